@@ -31,7 +31,7 @@
 
 #include <fstream>
 #include <iosfwd>
-#include <memory>                       // shared_ptr
+#include <memory>                       // shared_ptr, unique_ptr
 #include <string>
 #include <vector>
 
@@ -50,11 +50,13 @@ class LMI_SO AccountValue final
     :protected BasicValues
 {
     friend class SolveHelper;
+    friend class account_value_test;
     friend class run_census_in_parallel;
     friend currency SolveTest(); // Antediluvian.
 
   public:
     explicit AccountValue(Input const& input);
+    AccountValue(Input const& input, AccountValue const& prototype);
     AccountValue(AccountValue&&) = default;
     ~AccountValue() override = default;
 
@@ -91,9 +93,12 @@ class LMI_SO AccountValue final
     std::shared_ptr<Ledger const> ledger_from_av() const;
 
   private:
-    AccountValue(AccountValue const&) = delete;
+    AccountValue(Input const& input, AccountValue const* prototype);
+    AccountValue(AccountValue const&) = default;
     AccountValue& operator=(AccountValue const&) = delete;
 
+    std::unique_ptr<AccountValue> concurrent_copy() const;
+
     LedgerInvariant const& InvariantValues() const;
     LedgerVariant   const& VariantValues  () const;
 
@@ -311,7 +316,8 @@ class LMI_SO AccountValue final
     // Detailed monthly trace.
     std::string     InputFilename;
     std::string     DebugFilename;
-    std::ofstream   DebugStream;
+    // Shared by copies, which never write to it: see concurrent_copy().
+    std::shared_ptr<std::ofstream> DebugStream;
     std::vector<std::string> DebugRecord;
 
     currency        PriorAVGenAcct;
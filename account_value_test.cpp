@@ -23,32 +23,119 @@
 
 #include "account_value.hpp"
 
+#include "global_settings.hpp"
+#include "input.hpp"
+#include "ledger.hpp"
+#include "ssize_lmi.hpp"
 #include "test_tools.hpp"
 
+#include <cstdio>                       // remove()
+#include <memory>                       // shared_ptr
+#include <sstream>
+#include <string>
+#include <vector>
+
 class account_value_test
 {
   public:
     static void test()
         {
-        test0();
-        test1();
+        test_concurrent_bases();
         }
 
   private:
-    static void test0();
-    static void test1();
+    static std::string ledger_text(Input const&, bool serial);
+    static void test_concurrent_bases();
 };
 
-void account_value_test::test0()
+/// Project all bases and return the resulting ledger as text.
+///
+/// Non-current bases are projected concurrently, on copies of the
+/// account value object, unless 'serial' is specified. Serial
+/// projection is forced as a monthly trace forces it, without
+/// changing the input, which the ledger shows.
+
+std::string account_value_test::ledger_text(Input const& input, bool serial)
 {
+    std::string const trace_filename("account_value_test.monthly_trace");
+    std::ostringstream oss;
+    {
+    AccountValue av(input);
+    if(serial)
+        {
+        av.DebugFilename = trace_filename;
+        av.Debugging = true;
+        av.DebugPrintInit();
+        }
+    av.RunAV();
+    std::shared_ptr<Ledger const> const ledger = av.ledger_from_av();
+    // Concurrency requires at least two non-current bases.
+    LMI_TEST(3 <= lmi::ssize(ledger->GetRunBases()));
+    ledger->Spew(oss);
+    }
+    if(serial)
+        {
+        LMI_TEST(0 == std::remove(trace_filename.c_str()));
+        }
+    return oss.str();
 }
 
-void account_value_test::test1()
+/// Projecting non-current bases concurrently must not change any
+/// ledger value, whether or not the current basis was solved for.
+///
+/// If unshare_projection_state() failed to give a copy its own
+/// instance of anything that projection changes, the copies would
+/// race, and values would differ from those projected serially--at
+/// least sporadically, so each cell is run several times.
+
+void account_value_test::test_concurrent_bases()
 {
+    Input no_solve;
+    no_solve["ProductName"       ] = "sample2naic";
+    no_solve["SolveType"         ] = "No solve";
+    no_solve["Gender"            ] = "Male";
+    no_solve["Smoking"           ] = "Nonsmoker";
+    no_solve["UnderwritingClass" ] = "Standard";
+    no_solve["GeneralAccountRate"] = "0.06";
+    no_solve["Payment"           ] = "20000.0";
+    no_solve["SpecifiedAmount"   ] = "1000000.0";
+    no_solve["SolveToWhich"      ] = "Maturity";
+    no_solve.RealizeAllSequenceInput();
+
+    Input solve_specamt {no_solve};
+    solve_specamt["SolveType"] = "Specified amount";
+
+    Input solve_ee_prem {no_solve};
+    solve_ee_prem["SolveType"] = "Employee premium";
+
+    Input solve_on_guar {no_solve};
+    solve_on_guar["SolveType"                      ] = "Specified amount";
+    solve_on_guar["SolveExpenseGeneralAccountBasis"] = "Guaranteed";
+
+    Input withdrawals {no_solve};
+    withdrawals["Withdrawal"] = "0 10; 10000 20; 0";
+    withdrawals.RealizeAllSequenceInput();
+
+    std::vector<Input> const cells
+        {no_solve
+        ,solve_specamt
+        ,solve_ee_prem
+        ,solve_on_guar
+        ,withdrawals
+        };
+    for(auto const& i : cells)
+        {
+        std::string const serial = ledger_text(i, true);
+        for(int j = 0; j < 10; ++j)
+            {
+            LMI_TEST(serial == ledger_text(i, false));
+            }
+        }
 }
 
 int test_main(int, char*[])
 {
+    global_settings::instance().set_data_directory("/opt/lmi/data");
     account_value_test::test();
     return EXIT_SUCCESS;
 }
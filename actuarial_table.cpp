@@ -31,6 +31,7 @@
 #include "oecumenic_enumerations.hpp"   // methuselah
 #include "path.hpp"
 #include "path_utility.hpp"             // fs::path inserter
+#include "shared_table_store.hpp"
 #include "ssize_lmi.hpp"
 
 #include <algorithm>                    // max(), min()
@@ -38,10 +39,16 @@
 #   include <bit>                       // endian
 #endif //  202002 <= __cplusplus
 #include <cctype>                       // toupper()
+#include <cstddef>                      // size_t
 #include <cstdint>
 #include <ios>
 #include <istream>
 #include <limits>
+#include <map>
+#include <memory>                       // make_shared(), shared_ptr
+#include <mutex>
+#include <string>
+#include <utility>                      // move(), pair
 
 namespace
 {
@@ -77,6 +84,60 @@ namespace
         LMI_ASSERT(invalid != t);
         return t;
     }
+
+    /// Return a table via a cache that persists until the program
+    /// terminates, like class file_cache. Reading a table is costly
+    /// enough that a long-running process, such as a server, should
+    /// do it only once.
+    ///
+    /// Each table is reloaded if either of its files has been written
+    /// since it was cached. If either file is missing, the table is
+    /// constructed without the cache, so that the ctor's diagnostic
+    /// is shown.
+    ///
+    /// A table that another process has published in shared memory
+    /// is used from there, unless its files have changed since then.
+
+    std::shared_ptr<actuarial_table const> cached_table
+        (std::string const& filename
+        ,int                table_number
+        )
+    {
+        fs::path index_path(filename);
+        index_path.replace_extension(".ndx");
+        fs::path data_path(filename);
+        data_path.replace_extension(".dat");
+        if(!fs::exists(index_path) || !fs::exists(data_path))
+            {
+            return std::make_shared<actuarial_table>(filename, table_number);
+            }
+
+        struct record
+        {
+            std::shared_ptr<actuarial_table const> table;
+            fs::file_time_type                     index_time;
+            fs::file_time_type                     data_time;
+        };
+        static std::map<std::pair<std::string,int>,record> cache;
+        static std::mutex mutex;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto const index_time = fs::last_write_time(index_path);
+        auto const data_time  = fs::last_write_time(data_path );
+        record& r = cache[{filename, table_number}];
+        if(!r.table || index_time != r.index_time || data_time != r.data_time)
+            {
+            auto const shared = find_shared_actuarial_table(filename, table_number);
+            r.table =
+                  shared
+                ? std::make_shared<actuarial_table>(filename, table_number, *shared)
+                : std::make_shared<actuarial_table>(filename, table_number)
+                ;
+            r.index_time = index_time;
+            r.data_time  = data_time;
+            }
+        return r.table;
+    }
 } // Unnamed namespace.
 
 actuarial_table::actuarial_table(std::string const& filename, int table_number)
@@ -109,13 +170,94 @@ actuarial_table::actuarial_table(std::string const& filename, int table_number)
 
     find_table();
     parse_table();
+    data_view_ = data_;
+    tabulate_select_values();
+}
+
+/// Use a table that another process has already read and published
+/// in shared memory (see shared_table_store).
+
+actuarial_table::actuarial_table
+    (std::string            const& filename
+    ,int                           table_number
+    ,shared_actuarial_table const& shared
+    )
+    :filename_       {filename}
+    ,table_number_   {table_number}
+    ,table_type_     {shared.table_type}
+    ,min_age_        {shared.min_age}
+    ,max_age_        {shared.max_age}
+    ,select_period_  {shared.select_period}
+    ,max_select_age_ {shared.max_select_age}
+    ,data_view_      {shared.data}
+    ,select_view_    {shared.select_values}
+    ,shared_segment_ {shared.segment}
+    ,table_offset_   {-1}
+{
+    LMI_ASSERT('A' == table_type_ || 'D' == table_type_ || 'S' == table_type_);
+    LMI_ASSERT(min_age_ <= max_age_);
+    if('S' == table_type_)
+        {
+        set_select_offsets();
+        LMI_ASSERT(lmi::ssize(select_view_) == select_offsets_.back() + 1);
+        }
+}
+
+/// View a given number of values for a given issue age.
+///
+/// The view refers to this object's own storage, so looking up rates
+/// neither allocates nor copies anything.
+///
+/// Preconditions are the same as for specific_values(), which yields
+/// the same values.
+
+std::span<double const> actuarial_table::values_view
+    (int issue_age
+    ,int length
+    ) const
+{
+    LMI_ASSERT(min_age_ <= issue_age && issue_age <= max_age_);
+    LMI_ASSERT(0 <= length && length <= 1 + max_age_ - issue_age);
+
+    switch(table_type_)
+        {
+        case 'A':
+            {
+            return data_view_.subspan
+                (bourn_cast<std::size_t>(issue_age - min_age_)
+                ,bourn_cast<std::size_t>(length)
+                );
+            }
+        case 'D':
+            {
+            return data_view_.first(bourn_cast<std::size_t>(length));
+            }
+        case 'S':
+            {
+            return select_view_.subspan
+                (bourn_cast<std::size_t>(select_offsets_[issue_age - min_age_])
+                ,bourn_cast<std::size_t>(length)
+                );
+            }
+        default:
+            {
+            alarum()
+                << "Table type '"
+                << table_type_
+                << "' not recognized: must be one of 'A', 'D', or 'S'."
+                << LMI_FLUSH
+                ;
+            }
+        }
+    throw "Unreachable--silences a compiler diagnostic.";
 }
 
 /// Read a given number of values for a given issue age.
 
 std::vector<double> actuarial_table::values(int issue_age, int length) const
 {
-    return specific_values(issue_age, length);
+    std::span<double const> const v = values_view(issue_age, length);
+    return std::vector<double>(v.begin(), v.end());
 }
 
 /// Read a given number of values for a given issue age, using a
@@ -466,6 +608,49 @@ void actuarial_table::read_values(std::istream& is, int nominal_length)
         }
 }
 
+/// Tabulate a select table's values for every issue age.
+///
+/// Select and ultimate rates for a given issue age are not stored
+/// contiguously in data_, so they cannot be viewed there. Storing each
+/// issue age's values separately, once, lets values_view() return a
+/// view for any issue age and length: the values for a shorter length
+/// are always a prefix of those for the longest. For a table with a
+/// hundred issue ages, that's only about five thousand values.
+
+void actuarial_table::tabulate_select_values()
+{
+    if('S' != table_type_)
+        {
+        return;
+        }
+
+    set_select_offsets();
+    select_values_.clear();
+    select_values_.reserve(select_offsets_.back() + 1);
+    for(int issue_age = min_age_; issue_age <= max_age_; ++issue_age)
+        {
+        std::vector<double> const v = specific_values(issue_age, 1 + max_age_ - issue_age);
+        select_values_.insert(select_values_.end(), v.begin(), v.end());
+        }
+    select_view_ = select_values_;
+}
+
+/// Offsets of each issue age's values in a tabulated select table.
+///
+/// Each issue age has one value for every age through max_age_.
+
+void actuarial_table::set_select_offsets()
+{
+    select_offsets_.clear();
+    select_offsets_.reserve(1 + max_age_ - min_age_);
+    int offset = 0;
+    for(int issue_age = min_age_; issue_age <= max_age_; ++issue_age)
+        {
+        select_offsets_.push_back(offset);
+        offset += 1 + max_age_ - issue_age;
+        }
+}
+
 /// Read a given number of values for a given issue age.
 ///
 /// For table type "Duration", SOA software in effect treats min_age_
@@ -511,16 +696,16 @@ std::vector<double> actuarial_table::specific_values
             // libstdc++'s debug mode will dislike.
             //
             v = std::vector<double>
-                (data_.begin() + (issue_age - min_age_)
-                ,data_.begin() + (issue_age - min_age_ + length)
+                (data_view_.begin() + (issue_age - min_age_)
+                ,data_view_.begin() + (issue_age - min_age_ + length)
                 );
             }
             break;
         case 'D':
             {
             v = std::vector<double>
-                (data_.begin()
-                ,data_.begin() + length
+                (data_view_.begin()
+                ,data_view_.begin() + length
                 );
             }
             break;
@@ -534,7 +719,8 @@ std::vector<double> actuarial_table::specific_values
             v.resize(length);
             for(int j = 0; j < length; ++j, ++k)
                 {
-                v[j] = data_.at(k);
+                LMI_ASSERT(k < lmi::ssize(data_view_));
+                v[j] = data_view_[bourn_cast<std::size_t>(k)];
                 if
                     (   j + issue_age < max_select_age_ + select_period_
                     &&  select_period_ <= j
@@ -559,6 +745,32 @@ std::vector<double> actuarial_table::specific_values
     return v;
 }
 
+actuarial_table_view::actuarial_table_view
+    (std::shared_ptr<actuarial_table const> table
+    ,std::span<double const>                values
+    )
+    :table_  {table}
+    ,values_ {values}
+{
+}
+
+actuarial_table_view::actuarial_table_view(std::vector<double>&& computed_values)
+    :computed_values_ {std::move(computed_values)}
+    ,values_          {computed_values_}
+{
+}
+
+actuarial_table_view actuarial_table_rates_view
+    (std::string const& table_filename
+    ,int                table_number
+    ,int                issue_age
+    ,int                length
+    )
+{
+    std::shared_ptr<actuarial_table const> const t = cached_table(table_filename, table_number);
+    return actuarial_table_view(t, t->values_view(issue_age, length));
+}
+
 std::vector<double> actuarial_table_rates
     (std::string const& table_filename
     ,int                table_number
@@ -566,8 +778,7 @@ std::vector<double> actuarial_table_rates
     ,int                length
     )
 {
-    actuarial_table z(table_filename, table_number);
-    return z.values(issue_age, length);
+    return cached_table(table_filename, table_number)->values(issue_age, length);
 }
 
 std::vector<double> actuarial_table_rates_elaborated
@@ -580,8 +791,7 @@ std::vector<double> actuarial_table_rates_elaborated
     ,int                      reset_duration
     )
 {
-    actuarial_table z(table_filename, table_number);
-    return z.values_elaborated
+    return cached_table(table_filename, table_number)->values_elaborated
         (issue_age
         ,length
         ,method
@@ -25,9 +25,13 @@
 #include "config.hpp"
 
 #include <iosfwd>
+#include <memory>                       // shared_ptr
+#include <span>
 #include <string>
 #include <vector>
 
+struct shared_actuarial_table;
+
 /// Reentry methods for select tables.
 ///
 /// Reentry occurs only on anniversary.
@@ -129,8 +133,14 @@ class actuarial_table final
 {
   public:
     actuarial_table(std::string const& filename, int table_number);
+    actuarial_table
+        (std::string            const& filename
+        ,int                           table_number
+        ,shared_actuarial_table const& shared
+        );
     ~actuarial_table() = default;
 
+    std::span<double const> values_view(int issue_age, int length) const;
     std::vector<double> values(int issue_age, int length) const;
     std::vector<double> values_elaborated
         (int                      issue_age
@@ -148,6 +158,10 @@ class actuarial_table final
     int                select_period  () const {return select_period_  ;}
     int                max_select_age () const {return max_select_age_ ;}
 
+    // For shared_table_store.
+    std::span<double const> stored_values         () const {return data_view_  ;}
+    std::span<double const> tabulated_select_values() const {return select_view_;}
+
   private:
     actuarial_table(actuarial_table const&) = delete;
     actuarial_table& operator=(actuarial_table const&) = delete;
@@ -155,6 +169,8 @@ class actuarial_table final
     void find_table();
     void parse_table();
     void read_values(std::istream& is, int nominal_length);
+    void tabulate_select_values();
+    void set_select_offsets();
     std::vector<double> specific_values(int issue_age, int length) const;
 
     // Ctor arguments.
@@ -170,9 +186,62 @@ class actuarial_table final
 
     std::vector<double> data_;
 
+    // Values of a select table, by issue age (see values_view()).
+    std::vector<double> select_values_;
+    std::vector<int>    select_offsets_;
+
+    // Values actually used: either the vectors above, or the same
+    // values in a segment of shared memory, which is kept alive here.
+    std::span<double const>     data_view_;
+    std::span<double const>     select_view_;
+    std::shared_ptr<void const> shared_segment_;
+
     std::streampos table_offset_;
 };
 
+/// Rates looked up in a cached table, without copying them when that
+/// is possible.
+///
+/// Ordinarily, values() views the table's own storage, which remains
+/// valid as long as this object does, even if the cache reloads the
+/// table meanwhile. Rates that must be computed rather than merely
+/// looked up (see actuarial_table::values_elaborated()) are instead
+/// stored here.
+
+class actuarial_table_view final
+{
+  public:
+    actuarial_table_view
+        (std::shared_ptr<actuarial_table const> table
+        ,std::span<double const>                values
+        );
+    explicit actuarial_table_view(std::vector<double>&& computed_values);
+    // Moving a vector moves its storage, so values_ remains valid.
+    actuarial_table_view(actuarial_table_view&&) = default;
+    ~actuarial_table_view() = default;
+
+    std::span<double const> values() const {return values_;}
+
+  private:
+    actuarial_table_view(actuarial_table_view const&) = delete;
+    actuarial_table_view& operator=(actuarial_table_view const&) = delete;
+    actuarial_table_view& operator=(actuarial_table_view&&) = delete;
+
+    std::shared_ptr<actuarial_table const> table_;
+    std::vector<double>                    computed_values_;
+    std::span<double const>                values_;
+};
+
+/// Convenience function: view particular values of a table stored in
+/// the SOA table-manager format, without copying them.
+
+actuarial_table_view actuarial_table_rates_view
+    (std::string const& table_filename
+    ,int                table_number
+    ,int                issue_age
+    ,int                length
+    );
+
 /// Convenience function: read particular values from a table stored
 /// in the SOA table-manager format.
 
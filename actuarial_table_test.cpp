@@ -33,6 +33,9 @@
 
 #include <cstdio>                       // remove()
 #include <fstream>
+#include <span>
+#include <string>
+#include <vector>
 
 namespace
 {
@@ -383,6 +386,37 @@ void test_e_reenter_never()
     LMI_TEST(rates == gauge);
 }
 
+/// Views must hold the same values that are otherwise copied, and
+/// must refer to the table's storage instead of copying it.
+
+void test_views()
+{
+    for(int n : {42, 256, 750})
+        {
+        std::string const& f = (42 == n) ? qx_cso : qx_ins;
+        actuarial_table const table(f, n);
+        for(int x = table.min_age(); x <= table.max_age(); ++x)
+            {
+            int const length = 1 + table.max_age() - x;
+            std::span<double const> const v = table.values_view(x, length);
+            LMI_TEST(std::vector<double>(v.begin(), v.end()) == table.values(x, length));
+            // Shorter lookups are prefixes of longer ones.
+            LMI_TEST(v.data() == table.values_view(x, length / 2).data());
+            }
+
+        int const x = table.min_age();
+        int const length = 1 + table.max_age() - x;
+        actuarial_table_view const z = actuarial_table_rates_view(f, n, x, length);
+        std::span<double const> const v = z.values();
+        LMI_TEST(std::vector<double>(v.begin(), v.end()) == actuarial_table_rates(f, n, x, length));
+        }
+
+    std::vector<double> const computed {0.1, 0.2, 0.3};
+    actuarial_table_view const z {std::vector<double>(computed)};
+    std::span<double const> const v = z.values();
+    LMI_TEST(std::vector<double>(v.begin(), v.end()) == computed);
+}
+
 void test_e_reenter_at_inforce_duration()
 {
     std::vector<double> rates;
@@ -632,6 +666,7 @@ int test_main(int, char*[])
     test_precondition_failures();
     test_lookup_errors();
     test_e_reenter_never();
+    test_views();
     test_e_reenter_at_inforce_duration();
     test_e_reenter_upon_rate_reset();
     test_exotic_lookup_methods_with_attained_age_table();
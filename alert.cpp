@@ -44,6 +44,11 @@ alert_function_pointer alarum_alert_function         = nullptr;
 typedef void (*message_function_pointer)(char const*);
 message_function_pointer safe_message_alert_function = nullptr;
 
+/// Warnings collected by the innermost scoped_alert_capture on this
+/// thread, if any.
+
+thread_local std::string* captured_warnings = nullptr;
+
 inline bool all_function_pointers_have_been_set()
 {
     return
@@ -149,7 +154,11 @@ class status_buf
 {
     void raise_alert() override
         {
-        status_alert_function(alert_string());
+        std::string const& s = alert_string();
+        if(!captured_warnings)
+            {
+            status_alert_function(s);
+            }
         }
 };
 
@@ -158,7 +167,15 @@ class warning_buf
 {
     void raise_alert() override
         {
-        warning_alert_function(alert_string());
+        std::string const& s = alert_string();
+        if(captured_warnings)
+            {
+            captured_warnings->append(s).append(1, '\n');
+            }
+        else
+            {
+            warning_alert_function(s);
+            }
         }
 };
 
@@ -167,7 +184,12 @@ class hobsons_choice_buf
 {
     void raise_alert() override
         {
-        hobsons_choice_alert_function(alert_string());
+        std::string const& s = alert_string();
+        if(captured_warnings)
+            {
+            throw std::runtime_error(s);
+            }
+        hobsons_choice_alert_function(s);
         }
 };
 
@@ -187,13 +209,18 @@ class alarum_buf
 ///
 /// Both 'failbit' [27.6.2.5.3/8] and 'badbit' [27.6.2.1/3] must be
 /// specified in the call to exceptions().
+///
+/// Each thread has its own streams, so that a message composed on a
+/// worker thread cannot be interleaved with another thread's, and an
+/// exception thrown by alarum() propagates on the thread that wrote
+/// the message.
 
 template<typename T>
 inline std::ostream& alert_stream()
 {
     static_assert(std::is_base_of_v<alert_buf,T>);
-    static T buffer_;
-    static std::ostream stream_(&buffer_);
+    static thread_local T buffer_;
+    static thread_local std::ostream stream_(&buffer_);
     stream_.clear();
     stream_.exceptions(std::ios_base::failbit | std::ios_base::badbit);
     return stream_;
@@ -219,6 +246,17 @@ std::ostream& alarum()
     return alert_stream<alarum_buf>();
 }
 
+scoped_alert_capture::scoped_alert_capture()
+    :previous_ {captured_warnings}
+{
+    captured_warnings = &warnings_;
+}
+
+scoped_alert_capture::~scoped_alert_capture()
+{
+    captured_warnings = previous_;
+}
+
 void safely_show_on_stderr(char const* message)
 {
     std::fputs(message, stderr);
@@ -239,6 +239,31 @@ class hobsons_choice_exception
 {
 };
 
+/// While an instance exists, collect warning() messages written on
+/// the thread that created it, instead of showing them; discard any
+/// status() message; and treat hobsons_choice() as alarum(), because
+/// no one could answer it.
+///
+/// Intended use: a worker thread, which must not use a GUI, collects
+/// the warnings raised by each item of work, so that the thread that
+/// started it can show them all together afterwards.
+
+class LMI_SO scoped_alert_capture final
+{
+  public:
+    scoped_alert_capture();
+    ~scoped_alert_capture();
+
+    std::string const& warnings() const {return warnings_;}
+
+  private:
+    scoped_alert_capture(scoped_alert_capture const&) = delete;
+    scoped_alert_capture& operator=(scoped_alert_capture const&) = delete;
+
+    std::string* previous_;
+    std::string  warnings_ {};
+};
+
 /// Functions for testing, intended to be implemented in a shared
 /// library to demonstrate that alerts can be raised there and
 /// processed in the main application.
@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <iterator>                     // ostream_iterator
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 /// Demonstrate that alert streams can be used as arguments.
@@ -37,6 +38,37 @@ void test_stream_arg(std::ostream& os, std::string const& s)
     os << s << std::flush;
 }
 
+/// Capture alerts raised on a worker thread.
+
+void test_capture()
+{
+    std::string outer_warnings;
+    std::string inner_warnings;
+    std::thread worker
+        ([&]
+            {
+            scoped_alert_capture const outer;
+            warning() << "Outer." << std::flush;
+            {
+            scoped_alert_capture const inner;
+            status() << "This should be discarded." << std::flush;
+            warning() << "Inner." << std::flush;
+            inner_warnings = inner.warnings();
+            }
+            warning() << "Outer again." << std::flush;
+            LMI_TEST_THROW
+                (hobsons_choice() << "No one can answer." << std::flush
+                ,std::runtime_error
+                ,"No one can answer."
+                );
+            outer_warnings = outer.warnings();
+            }
+        );
+    worker.join();
+    LMI_TEST_EQUAL("Inner.\n", inner_warnings);
+    LMI_TEST_EQUAL("Outer.\nOuter again.\n", outer_warnings);
+}
+
 int test_main(int, char*[])
 {
     safely_show_message("  This message should appear on stderr.");
@@ -92,5 +124,7 @@ int test_main(int, char*[])
 
     LMI_TEST_THROW(test_stream_arg(alarum(), "X"), std::runtime_error, "X");
 
+    test_capture();
+
     return 0;
 }
@@ -23,16 +23,20 @@
 
 #include "alert.hpp"
 
+#include "background_calculation.hpp" // main_thread_handles_requests()
 #include "configurable_settings.hpp"
 #include "force_linking.hpp"
 
 #include <wx/app.h>                     // wxTheApp
 #include <wx/frame.h>
 #include <wx/msgdlg.h>
+#include <wx/thread.h>                  // wxThread::IsMain()
 #if defined LMI_MSW
 #   include <wx/msw/wrapwin.h>          // HWND etc.
 #endif // defined LMI_MSW
 
+#include <exception>                    // current_exception()
+#include <future>
 #include <iostream>
 #include <stdexcept>
 
@@ -47,6 +51,44 @@ bool volatile ensure_setup = set_alert_functions
     ,alarum_alert
     ,safe_message_alert
     );
+
+/// Whether an alert must be forwarded to the main thread.
+///
+/// A calculation may run on a worker thread (see 'calculation_channel.hpp'),
+/// but wx's user interface may be used only on the main thread.
+
+bool is_off_main_thread()
+{
+    return wxTheApp && !wxThread::IsMain();
+}
+
+/// Call f() on the main thread, and wait for it to return; propagate
+/// any exception it throws to the calling thread.
+///
+/// The main thread must be processing events meanwhile, as it does
+/// while it waits for a calculation on a worker thread: call this
+/// only if main_thread_handles_requests() returns true.
+
+template<typename F>
+void call_on_main_thread(F f)
+{
+    std::promise<void> done;
+    wxTheApp->CallAfter
+        ([&]
+            {
+            try
+                {
+                f();
+                done.set_value();
+                }
+            catch(...)
+                {
+                done.set_exception(std::current_exception());
+                }
+            }
+        );
+    done.get_future().get();
+}
 } // Unnamed namespace.
 
 /// Show a message on the statusbar, if a statusbar is available.
@@ -61,6 +103,12 @@ bool volatile ensure_setup = set_alert_functions
 
 void status_alert(std::string const& s)
 {
+    if(is_off_main_thread())
+        {
+        wxTheApp->CallAfter([s] {status_alert(s);});
+        return;
+        }
+
     if(wxTheApp)
         if(wxFrame* f = dynamic_cast<wxFrame*>(wxTheApp->GetTopWindow()))
             if(wxStatusBar* b = f->GetStatusBar())
@@ -70,9 +118,22 @@ void status_alert(std::string const& s)
                 }
 }
 
+/// A worker thread posts its warning to the main thread and continues
+/// at once, as it would on the command line.
+
 void warning_alert(std::string const& s)
 {
     std::cerr << "Warning: " << s << std::endl;
+    if(is_off_main_thread())
+        {
+        wxTheApp->CallAfter
+            ([s]
+                {
+                wxMessageBox(s, "Warning", wxOK, wxTheApp->GetTopWindow());
+                }
+            );
+        return;
+        }
     wxMessageBox(s, "Warning", wxOK, wxTheApp ? wxTheApp->GetTopWindow() : nullptr);
 }
 
@@ -83,9 +144,27 @@ void warning_alert(std::string const& s)
 ///
 /// The catch-clause throws an exception explicitly because accessing
 /// configurable_settings during startup may be problematic.
+///
+/// A worker thread must wait for the answer, so it asks the main
+/// thread to pose the question and waits for that to finish; if the
+/// choice is accepted, the exception is rethrown on the worker. But
+/// if the main thread isn't handling such requests--e.g., because it
+/// is waiting for the worker to finish--then no one can be asked, so
+/// an exception is thrown, as when the choice is not offered.
 
 void hobsons_choice_alert(std::string const& s)
 {
+    if(is_off_main_thread())
+        {
+        if(!main_thread_handles_requests())
+            {
+            std::cerr << "Hobson's choice: " << s << std::endl;
+            throw std::runtime_error(s);
+            }
+        call_on_main_thread([&s] {hobsons_choice_alert(s);});
+        return;
+        }
+
     std::cerr << "Hobson's choice: " << s << std::endl;
 
     wxWindow* w = nullptr;
@@ -30,21 +30,221 @@
 #include "handle_exceptions.hpp"        // report_exception()
 #include "md5.hpp"
 #include "md5sum.hpp"
+#include "parallel_for.hpp"
 #include "path.hpp"
 #include "path_utility.hpp"             // fs::path inserter
+#include "ssize_lmi.hpp"
 #include "timer.hpp"
 
 #include <cstdio>                       // fclose(), fopen()
 #include <cstdlib>                      // exit(), EXIT_FAILURE
 #include <cstring>                      // memcpy()
+#include <exception>                    // exception_ptr
+#include <fstream>
 #include <iostream>                     // cout, endl
+#include <map>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
 
+#if defined LMI_POSIX
+#   include <sys/stat.h>                // stat()
+#   include <unistd.h>                  // access(), geteuid()
+#endif // defined LMI_POSIX
+
 // TODO ?? Known security hole: data files can be modified after they
 // have been validated.
 
+namespace
+{
+/// A file's identity and modification state, as a string.
+///
+/// Any write to a file changes its ctime, which (unlike its mtime)
+/// cannot be set back to an earlier value, so a file with unchanged
+/// identity has not been altered. The device and inode numbers catch
+/// a file that was replaced by another. The result is empty if those
+/// numbers are unavailable; then the file is always hashed.
+
+std::string file_identity(fs::path const& path)
+{
+#if defined LMI_POSIX
+    struct stat st;
+    if(0 != ::stat(path.string().c_str(), &st) || !S_ISREG(st.st_mode))
+        {
+        return std::string();
+        }
+    std::ostringstream oss;
+    oss
+        <<        st.st_size
+        << ' ' << st.st_mtim.tv_sec << '.' << st.st_mtim.tv_nsec
+        << ' ' << st.st_ctim.tv_sec << '.' << st.st_ctim.tv_nsec
+        << ' ' << st.st_dev
+        << ' ' << st.st_ino
+        ;
+    return oss.str();
+#else  // !defined LMI_POSIX
+    (void)&path;
+    return std::string();
+#endif // !defined LMI_POSIX
+}
+
+/// Whether the user running this process can neither alter a file
+/// nor replace it: i.e., the file and its directory belong to some
+/// other user, who hasn't let this one write to them. False if that
+/// cannot be determined.
+
+bool is_beyond_users_reach(fs::path const& path)
+{
+#if defined LMI_POSIX
+    auto const protected_from_user = [](fs::path const& p)
+        {
+        struct stat st;
+        return
+               0 == ::stat(p.string().c_str(), &st)
+            && ::geteuid() != st.st_uid
+            && 0 != ::access(p.string().c_str(), W_OK)
+            ;
+        };
+    fs::path const directory =
+        path.parent_path().empty() ? fs::path(".") : path.parent_path();
+    return protected_from_user(path) && protected_from_user(directory);
+#else  // !defined LMI_POSIX
+    (void)&path;
+    return false;
+#endif // !defined LMI_POSIX
+}
+
+/// Files previously found to have their expected md5sums.
+///
+/// Each line records a file's expected md5sum, its identity, and its
+/// name. A file is vouched for only if its expected md5sum and
+/// identity are the same as when it was hashed; otherwise, it is
+/// hashed anew.
+///
+/// Anyone who can read the data files can compute any signature that
+/// lmi can, so no signature can prevent a user from forging a record.
+/// Therefore, a record is trusted only if the user can neither write
+/// it nor replace it: typically, it was written when an administrator
+/// ran lmi after installing the data files. Its first line is an
+/// HMAC-MD5 of the rest of the file, keyed with the passkey, so that
+/// a damaged record, or one made with a different passkey, is
+/// ignored.
+///
+/// This file is only an optimization. If it's absent, unreadable,
+/// untrusted, or invalid, it is ignored; if it can't be written,
+/// nothing is lost but time.
+
+class verified_state
+{
+  public:
+    verified_state(fs::path const& path, std::string const& passkey);
+
+    bool vouches_for
+        (fs::path    const& filename
+        ,std::string const& md5sum
+        ,std::string const& identity
+        ) const;
+
+    void save(std::vector<md5sum_for_file> const&, std::vector<std::string> const&) const;
+
+  private:
+    std::string signature(std::string const& body) const;
+
+    fs::path    const path_;
+    std::string const passkey_;
+    std::map<std::string,std::string> entries_;
+};
+
+verified_state::verified_state(fs::path const& path, std::string const& passkey)
+    :path_    {path}
+    ,passkey_ {passkey}
+{
+    if(path_.empty() || !is_beyond_users_reach(path_))
+        {
+        return;
+        }
+
+    std::ifstream is(path_.string(), std::ios_base::binary);
+    std::string signature_line;
+    if(!std::getline(is, signature_line))
+        {
+        return;
+        }
+    std::ostringstream body;
+    body << is.rdbuf();
+    if(signature_line != signature(body.str()))
+        {
+        return;
+        }
+
+    // Each line is "md5sum identity<TAB>filename".
+    std::istringstream iss(body.str());
+    std::string line;
+    while(std::getline(iss, line))
+        {
+        std::string::size_type const tab = line.find('\t');
+        if(std::string::npos != tab)
+            {
+            entries_[line.substr(1 + tab)] = line.substr(0, tab);
+            }
+        }
+}
+
+bool verified_state::vouches_for
+    (fs::path    const& filename
+    ,std::string const& md5sum
+    ,std::string const& identity
+    ) const
+{
+    if(identity.empty())
+        {
+        return false;
+        }
+    auto const i = entries_.find(filename.string());
+    return entries_.end() != i && md5sum + ' ' + identity == i->second;
+}
+
+/// Record every file whose identity is known. Call this only after
+/// every file has been verified. Write nothing if no identity is
+/// known, as is always the case on some platforms.
+
+void verified_state::save
+    (std::vector<md5sum_for_file> const& sums
+    ,std::vector<std::string>     const& identities
+    ) const
+{
+    if(path_.empty())
+        {
+        return;
+        }
+
+    std::ostringstream body;
+    for(int j = 0; j < lmi::ssize(sums); ++j)
+        {
+        if(!identities[j].empty())
+            {
+            body
+                << sums[j].md5sum << ' ' << identities[j]
+                << '\t' << sums[j].filename.string()
+                << '\n'
+                ;
+            }
+        }
+    if(body.str().empty())
+        {
+        return;
+        }
+
+    std::ofstream os(path_.string(), std::ios_base::binary | std::ios_base::trunc);
+    os << signature(body.str()) << '\n' << body.str();
+}
+
+std::string verified_state::signature(std::string const& body) const
+{
+    return md5_hmac_hex_string(passkey_, body);
+}
+} // Unnamed namespace.
+
 Authenticity& Authenticity::Instance()
 {
     try
@@ -68,6 +268,7 @@ void Authenticity::ResetCache()
 std::string Authenticity::Assay
     (calendar_date const& candidate
     ,fs::path const&      data_path
+    ,fs::path const&      verified_state_path
     )
 {
     Timer timer;
@@ -186,22 +387,56 @@ std::string Authenticity::Assay
         return oss.str();
         }
 
-    // Validate all data files.
+    // Validate all data files. They're hashed in parallel, but any
+    // failure is reported for the first file listed that fails, as
+    // if they had been hashed in order.
+    verified_state const state(verified_state_path, passkey);
+    std::vector<md5sum_for_file> sums;
+    std::vector<std::string> identities;
+    std::vector<char> hashed;
     try
         {
-        auto const sums = md5_read_checksum_file(data_path / md5sum_file());
-        for(auto const& s : sums)
+        sums = md5_read_checksum_file(data_path / md5sum_file());
+        int const n = lmi::ssize(sums);
+        identities.resize(n);
+        hashed    .resize(n);
+        std::vector<std::string>        md5s    (n);
+        std::vector<std::exception_ptr> failures(n);
+        auto hash = [&](int j)
+            {
+            try
+                {
+                auto const file_path = data_path / sums[j].filename;
+                // Identify the file before reading it: if it changes
+                // afterward, its identity will no longer match.
+                identities[j] = file_identity(file_path);
+                if(state.vouches_for(sums[j].filename, sums[j].md5sum, identities[j]))
+                    {
+                    md5s[j] = sums[j].md5sum;
+                    }
+                else
+                    {
+                    md5s[j] = md5_calculate_file_checksum(file_path, sums[j].file_mode);
+                    hashed[j] = true;
+                    }
+                }
+            catch(...)
+                {
+                failures[j] = std::current_exception();
+                }
+            };
+        parallel_for(n, hash);
+        for(int j = 0; j < n; ++j)
             {
-            auto const file_path = data_path / s.filename;
-            auto const md5 = md5_calculate_file_checksum
-                (data_path / s.filename
-                ,s.file_mode
-                );
-            if(md5 != s.md5sum)
+            if(failures[j])
+                {
+                std::rethrow_exception(failures[j]);
+                }
+            if(md5s[j] != sums[j].md5sum)
                 {
                     throw std::runtime_error
                         ( "Integrity check failed for '"
-                        + s.filename.string()
+                        + sums[j].filename.string()
                         + "'"
                         );
                 }
@@ -246,6 +481,13 @@ std::string Authenticity::Assay
     // Cache the validated date.
     Instance().CachedDate_ = candidate;
 
+    // Only now that the passkey is known to be valid, record the
+    // state of the files verified with it.
+    if(contains(hashed, true))
+        {
+        state.save(sums, identities);
+        }
+
     // MD5 !! Revert "measure_md5" instrumentation soon. Use
     //   git diff c029dd3248 authenticity.cpp
     // to see whether reversion is complete.
@@ -263,11 +505,13 @@ void authenticate_system()
 
     calendar_date const
         prospicience_date = global_settings::instance().prospicience_date();
+    fs::path const& data_path = global_settings::instance().data_directory();
     std::string const diagnostic_message = Authenticity::Assay
         (prospicience_date == last_yyyy_date()
             ? today()
             : prospicience_date
-        ,global_settings::instance().data_directory()
+        ,data_path
+        ,data_path / verified_state_file()
         );
     if
         (  "validated" != diagnostic_message
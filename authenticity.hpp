@@ -37,6 +37,13 @@
 ///
 /// 'cached_date_' holds the most-recently-validated date; it is
 /// initialized to a peremptorily-invalid default value of JDN zero.
+///
+/// Assay() hashes data files in parallel. If 'verified_state_path'
+/// is not empty, it names a file that records which files have been
+/// found intact, so that other processes need not hash them again
+/// unless they've changed. That record is trusted only if the user
+/// cannot write or replace it: see verified_state in the
+/// implementation.
 
 class Authenticity final
 {
@@ -47,6 +54,7 @@ class Authenticity final
     static std::string Assay
         (calendar_date const& candidate
         ,fs::path const&      data_path
+        ,fs::path const&      verified_state_path = fs::path()
         );
 
   private:
@@ -71,4 +79,8 @@ LMI_SO void authenticate_system();
 
 inline char const* md5sum_file() {return "validated.md5";}
 
+/// Name of file recording which secured files have been verified.
+
+inline char const* verified_state_file() {return "verified_state";}
+
 #endif // authenticity_hpp
@@ -36,6 +36,7 @@
 #include <cstdio>                       // remove()
 #include <cstring>                      // memcpy(), strlen()
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -49,6 +50,14 @@ std::string md5_str(T(&md5sum)[n])
     return md5_hex_string(svuc(md5sum, md5sum + md5len));
 }
 
+std::string file_contents(fs::path const& path)
+{
+    std::ifstream is(path.string(), std::ios_base::binary);
+    std::ostringstream oss;
+    oss << is.rdbuf();
+    return oss.str();
+}
+
 /// Data-file and date validation--unit test.
 ///
 /// Non-special public members are declared in invocation order.
@@ -73,6 +82,7 @@ class PasskeyTest
     void TestDate() const;
     void TestPasskey() const;
     void TestDataFile() const;
+    void TestVerifiedState() const;
     void TestExpiry() const;
 
   private:
@@ -125,6 +135,7 @@ void PasskeyTest::RemoveTestFiles(char const* file, int line) const
     filenames.push_back("passkey");
     filenames.push_back("coleridge");
     filenames.push_back(md5sum_file());
+    filenames.push_back(verified_state_file());
     for(auto const& i : filenames)
         {
         std::remove(i.c_str());
@@ -441,6 +452,76 @@ void PasskeyTest::TestDataFile() const
     CheckNominal(__FILE__, __LINE__);
 }
 
+/// Verified files are recorded, with an HMAC of the record. A record
+/// that the user could have forged is not trusted, and in any event
+/// a changed file is detected--even if the change is disguised by
+/// restoring the length and modification time.
+
+void PasskeyTest::TestVerifiedState() const
+{
+    CheckNominal(__FILE__, __LINE__);
+
+    fs::path const state_path(Pwd_ / verified_state_file());
+    Authenticity::ResetCache();
+    LMI_TEST_EQUAL("validated", Authenticity::Assay(BeginDate_, Pwd_, state_path));
+#if defined LMI_POSIX
+    std::string const state = file_contents(state_path);
+    LMI_TEST(contains(state, "bf039dbb0e8061971a2c322c8336199c "));
+    LMI_TEST(contains(state, "\tcoleridge\n"));
+    std::string const passkey = file_contents("passkey");
+    std::string::size_type const eol = state.find('\n');
+    LMI_TEST_EQUAL
+        (md5_hmac_hex_string(passkey.substr(0, passkey.find('\n')), state.substr(1 + eol))
+        ,state.substr(0, eol)
+        );
+#endif // defined LMI_POSIX
+
+    // This user can write the record, so it isn't trusted; but the
+    // unchanged file is validated anyway.
+    Authenticity::ResetCache();
+    LMI_TEST_EQUAL("validated", Authenticity::Assay(BeginDate_, Pwd_, state_path));
+
+    // A record altered by hand is ignored.
+    {
+    std::ofstream os(state_path.string(), std::ios_base::app);
+    os << "bogus\tcoleridge\n";
+    }
+    Authenticity::ResetCache();
+    LMI_TEST_EQUAL("validated", Authenticity::Assay(BeginDate_, Pwd_, state_path));
+
+    // Alter the file without changing its length or mtime.
+    std::string contents = file_contents("coleridge");
+    auto const mtime = fs::last_write_time("coleridge");
+    contents[0] = 'i';
+    {
+    std::ofstream os("coleridge", ios_out_trunc_binary());
+    os << contents;
+    }
+    fs::last_write_time("coleridge", mtime);
+
+    Authenticity::ResetCache();
+    std::cout
+        << "Expect"
+        << "\n  Integrity check failed for 'coleridge'"
+        << "\nto print:"
+        << std::endl
+        ;
+    {
+    scoped_unwind_toggler meaningless_name;
+    LMI_TEST_EQUAL
+        ("At least one required file is missing, altered, or invalid."
+        " Try reinstalling."
+        ,Authenticity::Assay(BeginDate_, Pwd_, state_path)
+        );
+    }
+
+    InitializeDataFile();
+    Authenticity::ResetCache();
+    LMI_TEST_EQUAL("validated", Authenticity::Assay(BeginDate_, Pwd_, state_path));
+    std::remove(verified_state_file());
+    CheckNominal(__FILE__, __LINE__);
+}
+
 void PasskeyTest::TestExpiry() const
 {
     CheckNominal(__FILE__, __LINE__);
@@ -499,6 +580,7 @@ int test_main(int, char*[])
     tester.TestDate();
     tester.TestPasskey();
     tester.TestDataFile();
+    tester.TestVerifiedState();
     tester.TestExpiry();
 
     return EXIT_SUCCESS;
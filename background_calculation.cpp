@@ -0,0 +1,180 @@
+// Run a calculation on a worker thread, showing its progress.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile_wx.hpp"
+
+#include "background_calculation.hpp"
+
+#include "calculation_channel.hpp"
+#include "wx_utility.hpp"               // TopWindow()
+
+#include <wx/app.h>                     // wxTheApp
+#include <wx/progdlg.h>
+#include <wx/utils.h>                   // wxBusyCursor
+#include <wx/window.h>                  // wxTopLevelWindows
+
+#include <algorithm>                    // min()
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>                       // make_unique(), unique_ptr
+#include <sstream>
+
+namespace
+{
+/// How often the main thread looks at the worker.
+
+std::chrono::milliseconds const polling_interval {50};
+
+/// How long a calculation may run before a progress dialog appears.
+/// Most single-cell illustrations finish sooner, and a dialog that
+/// flashes on the screen and disappears would be only a distraction.
+
+std::chrono::milliseconds const dialog_delay {500};
+
+constexpr int progress_dialog_style
+    {   wxPD_APP_MODAL
+    |   wxPD_AUTO_HIDE
+    |   wxPD_CAN_ABORT
+    |   wxPD_ELAPSED_TIME
+    |   wxPD_SMOOTH
+    };
+
+/// Number of calculate_in_background() calls now waiting.
+
+std::atomic<int> handling_requests {0};
+
+/// Handle events that the worker queued with wxApp::CallAfter(), and
+/// repaint any window that needs it. ProcessPendingEvents() doesn't
+/// repaint, and yielding would process user input as well, which
+/// must wait until the calculation is done.
+
+void handle_requests_and_repaint()
+{
+    wxTheApp->ProcessPendingEvents();
+    for(auto i = wxTopLevelWindows.GetFirst(); i; i = i->GetNext())
+        {
+        i->GetData()->Update();
+        }
+}
+
+std::string progress_message(calculation_channel::progress const& p)
+{
+    std::ostringstream oss;
+    oss << p.title;
+    if(0 < p.max_count)
+        {
+        oss << ": completed " << p.count << " of " << p.max_count;
+        }
+    return oss.str();
+}
+} // Unnamed namespace.
+
+bool calculate_in_background
+    (std::string           const& title
+    ,std::function<void()> const& calculation
+    )
+{
+    wxBusyCursor reverie;
+    ++handling_requests;
+    struct waiting
+    {
+        ~waiting() {--handling_requests;}
+    } const waiting_for_worker;
+    calculation_channel channel;
+    std::future<void> result = std::async
+        (std::launch::async
+        ,[&channel, &calculation]
+            {
+            scoped_calculation_channel const scope(&channel);
+            calculation();
+            }
+        );
+
+    // Created only when needed--see 'dialog_delay'. The generic dialog
+    // is used for the reason given in 'progress_meter_wx.cpp'.
+    std::unique_ptr<wxGenericProgressDialog> dialog;
+    auto const start = std::chrono::steady_clock::now();
+    while(std::future_status::ready != result.wait_for(polling_interval))
+        {
+        // Alerts from the worker are queued by wxApp::CallAfter().
+        handle_requests_and_repaint();
+
+        if(channel.cancellation_requested())
+            {
+            continue;
+            }
+        if(!dialog)
+            {
+            if(std::chrono::steady_clock::now() - start < dialog_delay)
+                {
+                continue;
+                }
+            dialog = std::make_unique<wxGenericProgressDialog>
+                (title
+                ,progress_message(channel.latest_progress())
+                ,100
+                ,&TopWindow()
+                ,progress_dialog_style
+                );
+            }
+
+        calculation_channel::progress const p = channel.latest_progress();
+        bool proceed = true;
+        if(0 < p.max_count)
+            {
+            if(p.max_count != dialog->GetRange())
+                {
+                dialog->SetRange(p.max_count);
+                }
+            proceed = dialog->Update
+                (std::min(p.count, p.max_count)
+                ,progress_message(p)
+                );
+            }
+        else
+            {
+            proceed = dialog->Pulse(progress_message(p));
+            }
+        if(!proceed)
+            {
+            channel.request_cancellation();
+            }
+        }
+    dialog.reset();
+    // The worker may have queued alerts just before it finished.
+    handle_requests_and_repaint();
+
+    try
+        {
+        result.get();
+        }
+    catch(calculation_cancelled const&)
+        {
+        return false;
+        }
+    return !channel.cancellation_requested();
+}
+
+bool main_thread_handles_requests()
+{
+    return 0 < handling_requests;
+}
@@ -0,0 +1,65 @@
+// Run a calculation on a worker thread, showing its progress.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef background_calculation_hpp
+#define background_calculation_hpp
+
+#include "config.hpp"
+
+#include <functional>
+#include <string>
+
+/// Run a calculation on a worker thread, showing its progress.
+///
+/// Return true if the calculation finished, or false if it was
+/// cancelled. Any other exception it throws is rethrown here.
+///
+/// The calculation reports progress and notices cancellation through
+/// a calculation_channel (see 'calculation_channel.hpp'), so it must
+/// not use wx itself; and it must not create windows, or write PDF
+/// files, which use wx fonts. Alerts are safe: they're forwarded to
+/// the main thread.
+///
+/// Meanwhile, the main thread keeps the display current and forwards
+/// alerts from the worker. If the calculation takes long enough to be
+/// noticed, an application-modal progress dialog is shown; its
+/// "Cancel" button stops the calculation within a month of projection
+/// or so. Because that dialog is modal, and nothing else is done with
+/// user input until it appears, no command can change or close the
+/// document whose data the worker reads. Thus, callers can treat this
+/// as an ordinary function call.
+
+bool calculate_in_background
+    (std::string           const& title
+    ,std::function<void()> const& calculation
+    );
+
+/// Whether the main thread is waiting in calculate_in_background(),
+/// where it handles events that other threads queue for it.
+///
+/// Only then may another thread wait for the main thread to do
+/// something for it. Elsewhere, the main thread may itself be waiting
+/// for that thread--e.g., in parallel_for()--and would never handle
+/// the request.
+
+bool main_thread_handles_requests();
+
+#endif // background_calculation_hpp
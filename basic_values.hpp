@@ -24,7 +24,7 @@
 
 #include "config.hpp"
 
-#include "actuarial_table.hpp"          // e_actuarial_table_method
+#include "actuarial_table.hpp"          // actuarial_table_view, e_actuarial_table_method
 #include "currency.hpp"
 #include "database.hpp"
 #include "dbnames.hpp"                  // e_database_key
@@ -35,7 +35,7 @@
 #include "so_attributes.hpp"
 #include "yare_input.hpp"
 
-#include <memory>                       // shared_ptr, unique_ptr
+#include <memory>                       // shared_ptr
 #include <string>
 #include <utility>                      // pair
 #include <vector>
@@ -102,6 +102,8 @@ class LMI_SO BasicValues
 
     void Init();
 
+    static bool is_rate_neutral(std::string const& input_field);
+
     int                   GetLength()                  const;
     int                   GetIssueAge()                const;
     int                   GetRetAge()                  const;
@@ -128,17 +130,19 @@ class LMI_SO BasicValues
     std::shared_ptr<rounding_rules     const> const RoundingRules_;
     std::shared_ptr<stratified_charges const> const StratifiedCharges_;
 
-    std::unique_ptr<i7702          const> i7702_;
+    // Shared rather than unique, so that a copy can share the
+    // immutable members: see unshare_projection_state().
+    std::shared_ptr<i7702          const> i7702_;
     std::shared_ptr<gpt7702             > gpt7702_;
 
-    std::unique_ptr<MortalityRates const> MortalityRates_;
-    std::unique_ptr<InterestRates       > InterestRates_;
-    std::unique_ptr<death_benefits      > DeathBfts_;
-    std::unique_ptr<modal_outlay        > Outlay_;
-    std::unique_ptr<premium_tax         > PremiumTax_;
-    std::unique_ptr<Loads          const> Loads_;
-    std::unique_ptr<Irc7702             > Irc7702_;
-    std::unique_ptr<Irc7702A            > Irc7702A_;
+    std::shared_ptr<MortalityRates const> MortalityRates_;
+    std::shared_ptr<InterestRates       > InterestRates_;
+    std::shared_ptr<death_benefits      > DeathBfts_;
+    std::shared_ptr<modal_outlay        > Outlay_;
+    std::shared_ptr<premium_tax         > PremiumTax_;
+    std::shared_ptr<Loads          const> Loads_;
+    std::shared_ptr<Irc7702             > Irc7702_;
+    std::shared_ptr<Irc7702A            > Irc7702A_;
 
     product_data     const& product () const {return *product_;}
     product_database const& database() const {return database_;}
@@ -207,6 +211,15 @@ class LMI_SO BasicValues
     round_to<double> const& round_minutiae          () const {return round_minutiae_          ;}
 
   protected:
+    BasicValues(Input const& input, BasicValues const* prototype);
+
+    /// A shallow copy, which shares every subobject with the original
+    /// until unshare_projection_state() is called.
+
+    BasicValues(BasicValues const&) = default;
+
+    void unshare_projection_state();
+
     currency GetModalMinPrem
         (int         a_year
         ,mcenum_mode a_mode
@@ -298,6 +311,14 @@ class LMI_SO BasicValues
         ,EBlend             CanBlendSmoking = CannotBlend
         ,EBlend             CanBlendGender  = CannotBlend
         ) const;
+    void GetTable
+        (std::vector<double>& z
+        ,std::string const&   TableFile
+        ,e_database_key       TableID
+        ,bool                 IsTableValid    = true
+        ,EBlend               CanBlendSmoking = CannotBlend
+        ,EBlend               CanBlendGender  = CannotBlend
+        ) const;
 
     std::vector<double> const& GetBandedCoiRates
         (mcenum_gen_basis rate_basis
@@ -397,7 +418,6 @@ class LMI_SO BasicValues
     std::vector<double>     TieredMECharges;
 
   private:
-    BasicValues(BasicValues const&) = delete;
     BasicValues& operator=(BasicValues const&) = delete;
 
     void set_partial_mortality();
@@ -420,18 +440,18 @@ class LMI_SO BasicValues
         ) const;
     currency GetModalSpecAmtMlyDed(currency annualized_pmt, mcenum_mode) const;
 
-    std::vector<double> GetActuarialTable
+    actuarial_table_view GetActuarialTable
         (std::string const& TableFile
         ,e_database_key     TableID
         ,int                TableNumber
         ) const;
 
-    std::vector<double> GetUnblendedTable
+    actuarial_table_view GetUnblendedTable
         (std::string const& TableFile
         ,e_database_key     TableID
         ) const;
 
-    std::vector<double> GetUnblendedTable
+    actuarial_table_view GetUnblendedTable
         (std::string const& TableFile
         ,e_database_key     TableID
         ,mcenum_gender      gender
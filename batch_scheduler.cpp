@@ -0,0 +1,252 @@
+// Run many input files concurrently in one process.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "batch_scheduler.hpp"
+
+#include "alert.hpp"
+#include "gpt_server.hpp"
+#include "illustrator.hpp"
+#include "mec_server.hpp"
+#include "parallel_for.hpp"
+#include "ssize_lmi.hpp"
+#include "timer.hpp"
+
+#include <algorithm>                    // stable_sort()
+#include <exception>
+#include <fstream>
+#include <iomanip>                      // setprecision(), setw()
+#include <map>
+#include <numeric>                      // iota()
+#include <ostream>
+#include <sstream>
+#include <system_error>                 // error_code
+
+namespace
+{
+template<typename T>
+input_file_run run_with(T server, fs::path const& file_path)
+{
+    input_file_run z;
+    z.completed                = server(file_path);
+    z.seconds_for_input        = server.seconds_for_input       ();
+    z.seconds_for_calculations = server.seconds_for_calculations();
+    z.seconds_for_output       = server.seconds_for_output      ();
+    return z;
+}
+
+std::string one_line(std::string s)
+{
+    std::replace(s.begin(), s.end(), '\n', ' ');
+    return s;
+}
+} // Unnamed namespace.
+
+e_input_file_runner input_file_runner(fs::path const& file_path)
+{
+    std::string const e = file_path.extension().string();
+    if(".cns" == e || ".cni" == e || ".ill" == e || ".ini" == e || ".inix" == e)
+        {
+        return e_run_illustrator;
+        }
+    else if(".mec" == e)
+        {
+        return e_run_mec_server;
+        }
+    else if(".gpt" == e)
+        {
+        return e_run_gpt_server;
+        }
+    else
+        {
+        return e_unrecognized_input;
+        }
+}
+
+input_file_run run_input_file(fs::path const& file_path, mcenum_emission emission)
+{
+    switch(input_file_runner(file_path))
+        {
+        case e_run_illustrator: return run_with(illustrator(emission), file_path);
+        case e_run_mec_server:  return run_with(mec_server (emission), file_path);
+        case e_run_gpt_server:  return run_with(gpt_server (emission), file_path);
+        case e_unrecognized_input:
+            {
+            alarum()
+                << "'"
+                << file_path
+                << "': unrecognized file extension."
+                << LMI_FLUSH
+                ;
+            }
+            break;
+        }
+    throw "Unreachable--silences a compiler diagnostic.";
+}
+
+std::vector<std::string> read_batch_manifest(fs::path const& manifest_path)
+{
+    std::ifstream ifs(manifest_path.string());
+    if(!ifs)
+        {
+        alarum()
+            << "Cannot open manifest '"
+            << manifest_path
+            << "'."
+            << LMI_FLUSH
+            ;
+        }
+    fs::path const directory = manifest_path.parent_path();
+    std::vector<std::string> z;
+    std::string line;
+    while(std::getline(ifs, line))
+        {
+        if(!line.empty() && '\r' == line.back())
+            {
+            line.pop_back();
+            }
+        if(line.empty() || '#' == line.front())
+            {
+            continue;
+            }
+        fs::path const p(line);
+        z.push_back((p.is_absolute() ? p : directory / p).string());
+        }
+    return z;
+}
+
+std::vector<batch_job_result> run_batch
+    (std::vector<std::string> const& file_names
+    ,mcenum_emission                 emission
+    ,int                             max_threads
+    )
+{
+    int const n = lmi::ssize(file_names);
+    std::vector<batch_job_result> results(file_names.size());
+    for(int j = 0; j < n; ++j)
+        {
+        results[j].file_name = file_names[j];
+        std::error_code ec;
+        std::uintmax_t const bytes = fs::file_size(fs::path(file_names[j]), ec);
+        results[j].bytes = ec ? 0 : bytes;
+        }
+
+    std::vector<int> order(file_names.size());
+    std::iota(order.begin(), order.end(), 0);
+    if(emission & (mce_emit_text_stream | mce_emit_timings))
+        {
+        max_threads = 1;
+        }
+    else
+        {
+        std::stable_sort
+            (order.begin()
+            ,order.end()
+            ,[&results](int a, int b) {return results[b].bytes < results[a].bytes;}
+            );
+        }
+
+    // Refuse to run concurrently any file whose output would have the
+    // same names as an earlier file's.
+    std::vector<std::string> collisions(file_names.size());
+    if(1 != max_threads)
+        {
+        std::map<std::string,std::string> stems;
+        for(int j = 0; j < n; ++j)
+            {
+            std::string const stem = fs::path(file_names[j]).stem().string();
+            auto const [i, inserted] = stems.insert({stem, file_names[j]});
+            if(!inserted)
+                {
+                collisions[j] = i->second;
+                }
+            }
+        }
+
+    parallel_for
+        (n
+        ,[&](int k)
+            {
+            batch_job_result& r = results[order[k]];
+            if(!collisions[order[k]].empty())
+                {
+                r.status =
+                      "failed: Output would have the same names as output from '"
+                    + collisions[order[k]]
+                    + "'."
+                    ;
+                return;
+                }
+            Timer timer;
+            try
+                {
+                r.succeeded = run_input_file(r.file_name, emission).completed;
+                r.status = r.succeeded ? "ok" : "incomplete";
+                }
+            catch(std::exception const& e)
+                {
+                r.status = "failed: " + one_line(e.what());
+                }
+            catch(...)
+                {
+                r.status = "failed: Unknown exception.";
+                }
+            r.seconds = timer.stop().elapsed_seconds();
+            }
+        ,max_threads
+        );
+    return results;
+}
+
+void write_batch_summary
+    (std::ostream&                        os
+    ,std::vector<batch_job_result> const& results
+    ,double                               elapsed_seconds
+    )
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    int failures = 0;
+    double total_seconds = 0.0;
+    for(auto const& r : results)
+        {
+        if(!r.succeeded)
+            {
+            ++failures;
+            }
+        total_seconds += r.seconds;
+        oss
+            << std::setw(10) << r.seconds << " s  "
+            << r.file_name
+            << ": "
+            << r.status
+            << '\n'
+            ;
+        }
+    oss
+        << results.size() << " files, "
+        << failures << " not completed; "
+        << total_seconds << " s of work in "
+        << elapsed_seconds << " s elapsed"
+        ;
+    os << oss.str() << std::endl;
+}
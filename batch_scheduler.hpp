@@ -0,0 +1,123 @@
+// Run many input files concurrently in one process.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef batch_scheduler_hpp
+#define batch_scheduler_hpp
+
+#include "config.hpp"
+
+#include "mc_enum_type_enums.hpp"       // mcenum_emission
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <cstdint>                      // uintmax_t
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// Class that 'lmi_cli --file' uses to run an input file.
+
+enum e_input_file_runner
+    {e_unrecognized_input
+    ,e_run_illustrator
+    ,e_run_mec_server
+    ,e_run_gpt_server
+    };
+
+/// Determine which class runs a file, from its extension: '.cns',
+/// '.cni', '.ill', '.ini', or '.inix' for illustrator; '.mec' for
+/// mec_server; and '.gpt' for gpt_server.
+
+LMI_SO e_input_file_runner input_file_runner(fs::path const&);
+
+/// Completion status and times reported by the class that ran a file.
+
+struct input_file_run
+{
+    bool   completed               {false};
+    double seconds_for_input       {0.0};
+    double seconds_for_calculations{0.0};
+    double seconds_for_output      {0.0};
+};
+
+/// Run a file with whichever class input_file_runner() selects.
+/// Throw if its extension is not recognized.
+
+LMI_SO input_file_run run_input_file(fs::path const&, mcenum_emission);
+
+/// Outcome of running one file in a batch.
+
+struct batch_job_result
+{
+    std::string    file_name;
+    std::uintmax_t bytes     {0};
+    double         seconds   {0.0};
+    bool           succeeded {false};
+    std::string    status    {};
+};
+
+/// Read the names of files to be run from a manifest: one name per
+/// line. Blank lines, and lines beginning with '#', are ignored. A
+/// relative name is taken as relative to the manifest's directory,
+/// so that a manifest can be kept beside the files it lists.
+
+LMI_SO std::vector<std::string> read_batch_manifest(fs::path const&);
+
+/// Run many files in one process, as 'lmi_cli --file' would run each
+/// of them, writing the same output files with the same names.
+///
+/// Files are run concurrently, on up to 'max_threads' threads (all
+/// available cores if that argument is not positive). Larger files
+/// are started first, because they usually take longer to run, and a
+/// long job started last would leave the other threads idle. Product
+/// files and tables are cached as they are first used, so every file
+/// after the first is run with warm caches.
+///
+/// Emissions that write to standard output ('emit_text_stream' and
+/// 'emit_timings') force serial execution in the order given, so that
+/// their output is exactly what it would be for separate runs.
+///
+/// Concurrent jobs must not write output files with the same names.
+/// Output file names are formed from input file names, with their
+/// directories replaced by the common print directory; therefore, a
+/// file whose name (apart from its directory and extension) matches
+/// that of an earlier file is not run concurrently, but fails.
+///
+/// An exception thrown by one file is recorded in its result, and
+/// does not prevent other files from being run. Results are returned
+/// in the order given, regardless of the order in which they ran.
+
+LMI_SO std::vector<batch_job_result> run_batch
+    (std::vector<std::string> const& file_names
+    ,mcenum_emission                 emission
+    ,int                             max_threads = 0
+    );
+
+/// Write a summary of a batch's results: one line per file, giving
+/// its time and status, then totals.
+
+LMI_SO void write_batch_summary
+    (std::ostream&                        os
+    ,std::vector<batch_job_result> const& results
+    ,double                               elapsed_seconds
+    );
+
+#endif // batch_scheduler_hpp
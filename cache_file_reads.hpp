@@ -29,6 +29,7 @@
 
 #include <map>
 #include <memory>                       // shared_ptr
+#include <mutex>
 #include <utility>                      // make_pair()
 
 namespace detail
@@ -50,7 +51,10 @@ namespace detail
 /// as long as it holds a pointer to them.
 ///
 /// Implemented as a simple Meyers singleton, with the expected
-/// dead-reference and threading issues.
+/// dead-reference issues. Retrieval is serialized by a mutex, so that
+/// several threads (e.g., reconciling census cells in parallel) may
+/// share the cache; a file is loaded only once even if several
+/// threads request it at the same time.
 
 template<typename T>
 class file_cache
@@ -66,6 +70,8 @@ class file_cache
 
     retrieved_type retrieve_or_reload(fs::path const& filename)
         {
+        std::lock_guard<std::mutex> lock(mutex_);
+
         // Throws if !exists(filename).
         auto const write_time = fs::last_write_time(filename);
 
@@ -103,6 +109,7 @@ class file_cache
     };
 
     std::map<fs::path,record> cache_;
+    std::mutex                mutex_;
 };
 } // namespace detail
 
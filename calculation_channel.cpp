@@ -0,0 +1,165 @@
+// Progress and cancellation for calculations on a worker thread.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "calculation_channel.hpp"
+
+#include <chrono>
+#include <sstream>
+#include <thread>                       // this_thread::sleep_for()
+
+namespace
+{
+thread_local calculation_channel* current_channel = nullptr;
+
+// Implicitly-declared special member functions do the right thing.
+// Virtuals are private because no one has any business accessing
+// them--not even derived classes, because deriving from this concrete
+// class is not contemplated.
+
+class channel_progress_meter
+    :public progress_meter
+{
+  public:
+    channel_progress_meter
+        (calculation_channel&
+        ,int                max_count
+        ,std::string const& title
+        ,enum_display_mode
+        );
+    ~channel_progress_meter() override = default;
+
+  private:
+    // progress_meter overrides.
+    void do_dawdle(int seconds) override;
+
+    // progress_meter required implementation.
+    std::string progress_message() const override;
+    bool show_progress_message() override;
+    void culminate_ui() override;
+
+    calculation_channel& channel_;
+    std::string const    title_;
+};
+
+channel_progress_meter::channel_progress_meter
+    (calculation_channel&              channel
+    ,int                               max_count
+    ,std::string const&                title
+    ,progress_meter::enum_display_mode display_mode
+    )
+    :progress_meter (max_count, title, display_mode)
+    ,channel_       {channel}
+    ,title_         {title}
+{
+    channel_.post_progress({title_, count(), max_count});
+}
+
+/// Sleep only for a tenth of a second at a time, so that cancellation
+/// interrupts the delay, as it does for the wx progress meter.
+
+void channel_progress_meter::do_dawdle(int seconds)
+{
+    for(int i = 10 * seconds; 0 < i && !channel_.cancellation_requested(); --i)
+        {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+}
+
+std::string channel_progress_meter::progress_message() const
+{
+    std::ostringstream oss;
+    oss << "Completed " << count() << " of " << max_count();
+    return oss.str();
+}
+
+bool channel_progress_meter::show_progress_message()
+{
+    channel_.post_progress({title_, count(), max_count()});
+    return !channel_.cancellation_requested();
+}
+
+void channel_progress_meter::culminate_ui()
+{
+}
+} // Unnamed namespace.
+
+calculation_cancelled::calculation_cancelled()
+    :std::runtime_error("Calculation cancelled.")
+{
+}
+
+void calculation_channel::request_cancellation()
+{
+    cancelled_ = true;
+}
+
+bool calculation_channel::cancellation_requested() const
+{
+    return cancelled_;
+}
+
+void calculation_channel::post_progress(progress const& p)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    progress_ = p;
+}
+
+calculation_channel::progress calculation_channel::latest_progress() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return progress_;
+}
+
+scoped_calculation_channel::scoped_calculation_channel(calculation_channel* c)
+    :previous_ {current_channel}
+{
+    current_channel = c;
+}
+
+scoped_calculation_channel::~scoped_calculation_channel()
+{
+    current_channel = previous_;
+}
+
+calculation_channel* current_calculation_channel()
+{
+    return current_channel;
+}
+
+void throw_if_calculation_cancelled()
+{
+    if(current_channel && current_channel->cancellation_requested())
+        {
+        throw calculation_cancelled();
+        }
+}
+
+std::unique_ptr<progress_meter> create_channel_progress_meter
+    (calculation_channel&              channel
+    ,int                               max_count
+    ,std::string const&                title
+    ,progress_meter::enum_display_mode mode
+    )
+{
+    return std::make_unique<channel_progress_meter>(channel, max_count, title, mode);
+}
@@ -0,0 +1,132 @@
+// Progress and cancellation for calculations on a worker thread.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef calculation_channel_hpp
+#define calculation_channel_hpp
+
+#include "config.hpp"
+
+#include "progress_meter.hpp"
+#include "so_attributes.hpp"
+
+#include <atomic>
+#include <memory>                       // unique_ptr
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+/// Design notes for class calculation_channel.
+///
+/// A calculation that runs on a worker thread must not touch the
+/// user interface, yet its user should see its progress and be able
+/// to stop it. This class carries both across threads: the worker
+/// posts progress, which the interface thread polls at its leisure;
+/// and the interface thread requests cancellation, which the worker
+/// notices the next time it checks.
+///
+/// A worker designates the channel it reports through by creating a
+/// scoped_calculation_channel, which makes that channel "current" for
+/// its own thread only. A thread that a worker starts in turn must be
+/// given the worker's channel explicitly, e.g.:
+///   calculation_channel* c = current_calculation_channel();
+///   parallel_for(n, [&](int j) {scoped_calculation_channel s(c); ...});
+/// (a null pointer means "no channel", so that works on any thread).
+/// Then:
+///
+/// create_progress_meter() returns a meter that posts progress to the
+/// current channel, instead of one that would display it--so code that
+/// uses progress meters needs no change to run on a worker thread; and
+/// that meter's reflect_progress() returns false once cancellation has
+/// been requested, just as though the user had pressed "Cancel".
+///
+/// throw_if_calculation_cancelled() throws calculation_cancelled if
+/// cancellation has been requested through the current channel. It is
+/// called once per month in the account-value loops, so that even a
+/// single long illustration can be stopped promptly. It does nothing
+/// on a thread that has no current channel, which is the case for
+/// every calculation that isn't run on a worker thread: a thread_local
+/// pointer is all it costs then.
+///
+/// Progress is a snapshot of the latest meter's title, count, and
+/// maximum count, guarded by a mutex because the title is a string.
+/// Polling the latest snapshot, rather than queueing every change,
+/// means that a slow interface thread simply skips intermediate steps.
+
+class LMI_SO calculation_cancelled
+    :public std::runtime_error
+{
+  public:
+    calculation_cancelled();
+};
+
+class LMI_SO calculation_channel final
+{
+  public:
+    struct progress
+        {
+        std::string title     {};
+        int         count     {0};
+        int         max_count {0};
+        };
+
+    calculation_channel() = default;
+    ~calculation_channel() = default;
+
+    void request_cancellation();
+    bool cancellation_requested() const;
+
+    void post_progress(progress const&);
+    progress latest_progress() const;
+
+  private:
+    calculation_channel(calculation_channel const&) = delete;
+    calculation_channel& operator=(calculation_channel const&) = delete;
+
+    std::atomic<bool>  cancelled_ {false};
+    mutable std::mutex mutex_     {};
+    progress           progress_  {};
+};
+
+class LMI_SO scoped_calculation_channel final
+{
+  public:
+    explicit scoped_calculation_channel(calculation_channel*);
+    ~scoped_calculation_channel();
+
+  private:
+    scoped_calculation_channel(scoped_calculation_channel const&) = delete;
+    scoped_calculation_channel& operator=(scoped_calculation_channel const&) = delete;
+
+    calculation_channel* const previous_;
+};
+
+LMI_SO calculation_channel* current_calculation_channel();
+
+LMI_SO void throw_if_calculation_cancelled();
+
+LMI_SO std::unique_ptr<progress_meter> create_channel_progress_meter
+    (calculation_channel&
+    ,int                               max_count
+    ,std::string const&                title
+    ,progress_meter::enum_display_mode
+    );
+
+#endif // calculation_channel_hpp
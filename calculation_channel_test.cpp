@@ -0,0 +1,142 @@
+// Progress and cancellation for calculations on a worker thread--unit test.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "calculation_channel.hpp"
+
+#include "test_tools.hpp"
+
+#include <atomic>
+#include <thread>
+
+void test_scope()
+{
+    LMI_TEST(nullptr == current_calculation_channel());
+    throw_if_calculation_cancelled();
+
+    calculation_channel c0;
+    calculation_channel c1;
+    {
+    scoped_calculation_channel const s0(&c0);
+    LMI_TEST(&c0 == current_calculation_channel());
+        {
+        scoped_calculation_channel const s1(&c1);
+        LMI_TEST(&c1 == current_calculation_channel());
+            {
+            scoped_calculation_channel const s2(nullptr);
+            LMI_TEST(nullptr == current_calculation_channel());
+            }
+        LMI_TEST(&c1 == current_calculation_channel());
+        }
+    LMI_TEST(&c0 == current_calculation_channel());
+
+    // The current channel is current for this thread only.
+    calculation_channel* elsewhere = &c1;
+    std::thread([&elsewhere] {elsewhere = current_calculation_channel();}).join();
+    LMI_TEST(nullptr == elsewhere);
+    }
+    LMI_TEST(nullptr == current_calculation_channel());
+}
+
+void test_progress_and_cancellation()
+{
+    calculation_channel c;
+    scoped_calculation_channel const s(&c);
+
+    // Progress meters post progress to the current channel, and
+    // write nothing to the stream they would otherwise use.
+    progress_meter_unit_test_stream().str("");
+    std::unique_ptr<progress_meter> meter
+        (create_progress_meter
+            (3
+            ,"Some title"
+            ,progress_meter::e_unit_test_mode
+            )
+        );
+    LMI_TEST_EQUAL("Some title", c.latest_progress().title);
+    LMI_TEST_EQUAL(0, c.latest_progress().count);
+    LMI_TEST_EQUAL(3, c.latest_progress().max_count);
+    LMI_TEST(meter->reflect_progress());
+    LMI_TEST_EQUAL(1, c.latest_progress().count);
+    LMI_TEST_EQUAL("", progress_meter_unit_test_stream().str());
+
+    throw_if_calculation_cancelled();
+    c.request_cancellation();
+    LMI_TEST(c.cancellation_requested());
+    LMI_TEST_THROW
+        (throw_if_calculation_cancelled()
+        ,calculation_cancelled
+        ,"Calculation cancelled."
+        );
+
+    // Cancellation interrupts dawdling, and a meter reports it just
+    // as though its "Cancel" button had been pressed.
+    meter->dawdle(60);
+    LMI_TEST(!meter->reflect_progress());
+    LMI_TEST_EQUAL(2, c.latest_progress().count);
+    meter->culminate();
+}
+
+/// Cancel a worker thread that runs until it's cancelled, after it
+/// has shown some progress.
+
+void test_worker_thread()
+{
+    calculation_channel c;
+    std::atomic<int> iterations {0};
+    std::thread worker
+        ([&]
+            {
+            scoped_calculation_channel const s(&c);
+            try
+                {
+                for(;;)
+                    {
+                    c.post_progress({"Working", ++iterations, 0});
+                    throw_if_calculation_cancelled();
+                    std::this_thread::yield();
+                    }
+                }
+            catch(calculation_cancelled const&)
+                {
+                }
+            }
+        );
+    while(c.latest_progress().count < 10)
+        {
+        std::this_thread::yield();
+        }
+    c.request_cancellation();
+    worker.join();
+    LMI_TEST_EQUAL("Working", c.latest_progress().title);
+    LMI_TEST_EQUAL(iterations.load(), c.latest_progress().count);
+    LMI_TEST(10 <= iterations);
+}
+
+int test_main(int, char*[])
+{
+    test_scope();
+    test_progress_and_cancellation();
+    test_worker_thread();
+
+    return 0;
+}
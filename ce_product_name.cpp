@@ -106,6 +106,7 @@ ce_product_name::ce_product_name(std::string const& s)
 ce_product_name& ce_product_name::operator=(std::string const& s)
 {
     value_ = product_names()[ordinal(s)];
+    note_change();
     return *this;
 }
 
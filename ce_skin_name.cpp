@@ -101,6 +101,7 @@ ce_skin_name::ce_skin_name(std::string const& s)
 ce_skin_name& ce_skin_name::operator=(std::string const& s)
 {
     value_ = skin_names()[ordinal(s)];
+    note_change();
     return *this;
 }
 
@@ -28,7 +28,9 @@
 #include "assert_lmi.hpp"
 #include "census_view.hpp"
 #include "illustrator.hpp"              // default_cell()
+#include "indexed_census.hpp"
 #include "miscellany.hpp"
+#include "path.hpp"
 #include "wx_utility.hpp"
 
 #include <fstream>
@@ -58,6 +60,15 @@ bool CensusDocument::OnCreate(wxString const& filename, long int flags)
     else
         {
         std::string f = ValidateAndConvertFilename(filename);
+        if(is_indexed_census(f))
+            {
+            indexed_census const census(f);
+            doc_.case_parms_  = census.case_parms ();
+            doc_.class_parms_ = census.class_parms();
+            doc_.cell_parms_  = census.cell_parms ();
+            doc_.assert_vector_sizes_are_sane();
+            return wxDocument::OnCreate(filename, flags);
+            }
         std::ifstream ifs(f.c_str());
         if(!ifs)
             {
@@ -87,6 +98,12 @@ bool CensusDocument::DoOpenDocument(wxString const&)
 bool CensusDocument::DoSaveDocument(wxString const& filename)
 {
     std::string f = ValidateAndConvertFilename(filename);
+    if(is_indexed_census(f))
+        {
+        indexed_census::write(f, doc_);
+        status() << "Saved '" << filename << "'." << std::flush;
+        return true;
+        }
     std::ofstream ofs(f.c_str(), ios_out_trunc_binary());
     doc_.write(ofs);
     if(!ofs)
@@ -0,0 +1,337 @@
+// Import census data from tab-delimited text.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "census_import.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "calendar_date.hpp"
+#include "contains.hpp"
+#include "facets.hpp"                   // tab_is_not_whitespace_locale()
+#include "istream_to_string.hpp"
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary()
+#include "multiple_cell_document.hpp"
+#include "parallel_for.hpp"
+#include "path_utility.hpp"             // fs::path inserter
+#include "ssize_lmi.hpp"
+#include "tn_range_types.hpp"           // tnr_date
+#include "value_cast.hpp"
+
+#include <exception>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+std::vector<std::string> split_on_tabs(std::string const& line)
+{
+    std::vector<std::string> v;
+    std::istringstream iss(line);
+    std::string token;
+    while(std::getline(iss, token, '\t'))
+        {
+        v.push_back(token);
+        }
+    return v;
+}
+
+/// Convert a date to JDN, accepting either JDN or YYYYMMDD.
+///
+/// Returns an empty string if the value is neither.
+
+std::string normalized_date(std::string const& s)
+{
+    int constexpr jdn_min = calendar_date::gregorian_epoch_jdn;
+    int constexpr jdn_max = calendar_date::last_yyyy_date_jdn;
+    static int const ymd_min = JdnToYmd(jdn_t(jdn_min)).value();
+    static int const ymd_max = JdnToYmd(jdn_t(jdn_max)).value();
+    int z = value_cast<int>(s);
+    if(jdn_min <= z && z <= jdn_max)
+        {
+        return s; // JDN is the default expectation.
+        }
+    else if(ymd_min <= z && z <= ymd_max)
+        {
+        z = YmdToJdn(ymd_t(z)).value();
+        return value_cast<std::string>(z);
+        }
+    else
+        {
+        return std::string();
+        }
+}
+
+/// Problems found on one line of data.
+
+struct line_diagnostics
+{
+    std::string errors;
+    std::string warnings;
+};
+
+/// Set one cell's fields from one line of data; return diagnostics.
+///
+/// This is called on worker threads, which must not show alerts, so
+/// any warnings raised while the cell is reconciled are collected and
+/// returned, along with errors that prevent the line from being used.
+
+line_diagnostics import_one_line
+    (Input&                          cell
+    ,std::string              const& line
+    ,std::vector<std::string> const& headers
+    ,std::vector<bool>        const& is_date
+    )
+{
+    scoped_alert_capture const capture;
+    std::ostringstream oss;
+    try
+        {
+        std::vector<std::string> values = split_on_tabs(line);
+        if(values.size() != headers.size())
+            {
+            oss
+                << "(" << line << ") "
+                << "should have one value per column. "
+                << "Number of values: " << values.size() << "; "
+                << "number expected: " << headers.size() << "."
+                ;
+            return {oss.str(), capture.warnings()};
+            }
+
+        for(int j = 0; j < lmi::ssize(headers); ++j)
+            {
+            if(is_date[j])
+                {
+                std::string const z = normalized_date(values[j]);
+                if(z.empty())
+                    {
+                    oss
+                        << "Invalid date " << values[j]
+                        << " for '" << headers[j] << "'."
+                        ;
+                    return {oss.str(), capture.warnings()};
+                    }
+                values[j] = z;
+                }
+            cell[headers[j]] = values[j];
+            }
+        cell.Reconcile();
+        for(auto const& i : cell.RealizeAllSequenceInput(false))
+            {
+            if(!i.empty())
+                {
+                oss << i << '\n';
+                }
+            }
+        }
+    catch(std::exception const& e)
+        {
+        oss << e.what();
+        }
+    return {oss.str(), capture.warnings()};
+}
+} // Unnamed namespace.
+
+/// Import census data from text, as pasted from a spreadsheet.
+///
+/// The first line names input fields, and each subsequent nonblank
+/// line represents one cell, with tab-delimited values in the same
+/// order. Date fields may be given either as JDN or as YYYYMMDD.
+/// If "DateOfBirth" is given, then "UseDOB" is forced to "Yes"; if
+/// "IssueAge" is given, then "No"; giving both is an error.
+///
+/// If there is no header line, or no line after it, a warning is
+/// given and no cells are returned.
+///
+/// Lines are split serially, but cells are set, reconciled, and
+/// realized in parallel. A problem on any line doesn't stop others
+/// from being processed; instead, all problems are reported together,
+/// with line numbers, by a single alarum(). Otherwise, any warnings
+/// are likewise shown together, by a single warning().
+
+census_import_result import_census
+    (std::string const& census_data
+    ,Input       const& case_default
+    )
+{
+    std::istringstream iss_census(census_data);
+    iss_census.imbue(tab_is_not_whitespace_locale());
+    std::string line;
+
+    // Get header line; parse into field names.
+    std::vector<std::string> headers;
+    if(std::getline(iss_census, line, '\n'))
+        {
+        iss_census >> std::ws;
+        headers = split_on_tabs(line);
+        }
+    else
+        {
+        warning() << "Error pasting census data: no header line." << LMI_FLUSH;
+        return {case_default, {}};
+        }
+
+    // Use a modifiable copy of case defaults as an archetype for new
+    // cells. Clients may write modifications back to case defaults.
+    census_import_result result {case_default, {}};
+    Input& archetype = result.archetype;
+
+    // Force 'UseDOB' prn. Pasting it as a column never makes sense.
+    if(contains(headers, "UseDOB"))
+        {
+        warning() << "'UseDOB' is unnecessary and will be ignored." << std::flush;
+        }
+    bool const dob_pasted = contains(headers, "DateOfBirth");
+    bool const age_pasted = contains(headers, "IssueAge");
+    if(dob_pasted && age_pasted)
+        {
+        alarum()
+            << "Cannot paste both 'DateOfBirth' and 'IssueAge'."
+            << LMI_FLUSH
+            ;
+        }
+    else if(dob_pasted)
+        {
+        archetype["UseDOB"] = "Yes";
+        }
+    else if(age_pasted)
+        {
+        archetype["UseDOB"] = "No";
+        }
+    else
+        {
+        ; // Do nothing: neither age nor DOB pasted.
+        }
+
+    // Look up each column once, rather than once per line. This also
+    // rejects any unknown field name before any cell is processed.
+    std::vector<bool> is_date;
+    for(auto const& i : headers)
+        {
+        is_date.push_back(nullptr != exact_cast<tnr_date>(archetype[i]));
+        }
+
+    std::vector<std::string> lines;
+    while(std::getline(iss_census, line, '\n'))
+        {
+        iss_census >> std::ws;
+        lines.push_back(line);
+        }
+
+    int const n = lmi::ssize(lines);
+    if(0 == n)
+        {
+        warning() << "No cells to paste." << LMI_FLUSH;
+        return result;
+        }
+
+    std::vector<Input> cells(lines.size(), archetype);
+    std::vector<line_diagnostics> diagnostics(lines.size());
+    parallel_for
+        (n
+        ,[&](int i)
+            {
+            diagnostics[i] = import_one_line(cells[i], lines[i], headers, is_date);
+            }
+        );
+
+    std::ostringstream errors;
+    std::ostringstream warnings;
+    int error_count = 0;
+    for(int i = 0; i < n; ++i)
+        {
+        if(!diagnostics[i].errors.empty())
+            {
+            ++error_count;
+            errors << "Line #" << 1 + i << ": " << diagnostics[i].errors << '\n';
+            }
+        if(!diagnostics[i].warnings.empty())
+            {
+            warnings << "Line #" << 1 + i << ": " << diagnostics[i].warnings;
+            }
+        }
+    if(0 != error_count)
+        {
+        alarum()
+            << error_count
+            << " of "
+            << n
+            << " lines could not be imported:\n"
+            << errors.str()
+            << LMI_FLUSH
+            ;
+        }
+    if(!warnings.str().empty())
+        {
+        warning() << warnings.str() << LMI_FLUSH;
+        }
+
+    result.cells.swap(cells);
+    return result;
+}
+
+/// Import a file of census data, with the given case default as an
+/// archetype for each cell; write it as a '.cns' file.
+///
+/// The file is written with the same name as the tab-delimited input,
+/// except that its extension is replaced with '.cns', and that name
+/// is returned so that the census can be run. Its case and class
+/// defaults are both the archetype, just as when data are pasted into
+/// a new census in the GUI.
+
+fs::path import_census_file
+    (fs::path const& tsv_path
+    ,Input    const& case_default
+    )
+{
+    std::ifstream ifs(tsv_path.string().c_str(), ios_in_binary());
+    if(!ifs)
+        {
+        alarum() << "Unable to read file " << tsv_path << " ." << LMI_FLUSH;
+        }
+    std::string census_data;
+    istream_to_string(ifs, census_data);
+
+    census_import_result z = import_census(census_data, case_default);
+    if(z.cells.empty())
+        {
+        alarum() << "File " << tsv_path << " has no cells." << LMI_FLUSH;
+        }
+
+    multiple_cell_document doc
+        ({z.archetype}
+        ,{z.archetype}
+        ,z.cells
+        );
+
+    fs::path cns_path {tsv_path};
+    cns_path.replace_extension(".cns");
+    std::ofstream ofs(cns_path.string().c_str(), ios_out_trunc_binary());
+    doc.write(ofs);
+    if(!ofs)
+        {
+        alarum() << "Unable to write file " << cns_path << " ." << LMI_FLUSH;
+        }
+    status() << "Imported " << z.cells.size() << " cells." << std::flush;
+    return cns_path;
+}
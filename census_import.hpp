@@ -0,0 +1,57 @@
+// Import census data from tab-delimited text.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef census_import_hpp
+#define census_import_hpp
+
+#include "config.hpp"
+
+#include "input.hpp"
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <string>
+#include <vector>
+
+/// Cells imported from tab-delimited census data.
+///
+/// 'archetype' is the case default that was used as a template for
+/// each cell, with "UseDOB" set to reflect whether the data specified
+/// dates of birth or issue ages. Clients may write it back to case
+/// and class defaults.
+
+struct LMI_SO census_import_result
+{
+    Input              archetype;
+    std::vector<Input> cells;
+};
+
+LMI_SO census_import_result import_census
+    (std::string const& census_data
+    ,Input       const& case_default
+    );
+
+LMI_SO fs::path import_census_file
+    (fs::path const& tsv_path
+    ,Input    const& case_default
+    );
+
+#endif // census_import_hpp
@@ -25,13 +25,13 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "background_calculation.hpp"
 #include "bourn_cast.hpp"
 #include "census_document.hpp"
+#include "census_import.hpp"
 #include "configurable_settings.hpp"
-#include "contains.hpp"
 #include "default_view.hpp"
 #include "edit_mvc_docview_parameters.hpp"
-#include "facets.hpp"                   // tab_is_not_whitespace_locale()
 #include "global_settings.hpp"
 #include "illustration_view.hpp"
 #include "illustrator.hpp"
@@ -68,7 +68,6 @@
 #include <cctype>                       // isupper()
 #include <cstddef>                      // size_t
 #include <fstream>
-#include <istream>                      // ws
 #include <iterator>                     // insert_iterator
 #include <sstream>
 
@@ -1584,12 +1583,32 @@ void CensusView::ViewComposite()
     illview.DisplaySelectedValuesAsHtml();
 }
 
+/// Calculate all cells on a worker thread, unless PDF output is
+/// wanted: that uses wx, which must be used only on the main thread.
+
 bool CensusView::DoAllCells(mcenum_emission emission)
 {
     test_census_consensus(emission, case_parms()[0], cell_parms());
 
     illustrator z(emission);
-    if(!z(base_filename(), cell_parms()))
+    fs::path const file(base_filename());
+    bool completed = false;
+    auto calculate = [&] {completed = z(file, cell_parms());};
+    mcenum_emission const wx_emissions = mcenum_emission
+        (   mce_emit_pdf_file
+        |   mce_emit_pdf_to_printer
+        |   mce_emit_pdf_to_viewer
+        |   mce_emit_group_quote
+        );
+    if(emission & wx_emissions)
+        {
+        calculate();
+        }
+    else
+        {
+        calculate_in_background("Calculating all cells", calculate);
+        }
+    if(!completed)
         {
         // Cancelled during run_census::operator().
         return false;
@@ -1756,141 +1775,19 @@ void CensusView::UponRunCaseToGroupQuote(wxCommandEvent&)
 
 void CensusView::UponPasteCensus(wxCommandEvent&)
 {
-    std::string const census_data = ClipboardEx::GetText();
-
-    std::vector<std::string> headers;
-    std::vector<Input> cells;
-
-    std::istringstream iss_census(census_data);
-    iss_census.imbue(tab_is_not_whitespace_locale());
-    std::string line;
-
-    // Get header line; parse into field names.
-    if(std::getline(iss_census, line, '\n'))
-        {
-        iss_census >> std::ws;
-
-        std::istringstream iss_line(line);
-        std::string token;
-
-        while(std::getline(iss_line, token, '\t'))
-            {
-            headers.push_back(token);
-            }
-        }
-    else
-        {
-        warning() << "Error pasting census data: no header line." << LMI_FLUSH;
-        return;
-        }
-
-    // Use a modifiable copy of case defaults as an archetype for new
-    // cells to be created by pasting. Modifications are conditionally
-    // written back to case defaults later.
-    Input archetype(case_parms()[0]);
-
-    // Force 'UseDOB' prn. Pasting it as a column never makes sense.
-    if(contains(headers, "UseDOB"))
-        {
-        warning() << "'UseDOB' is unnecessary and will be ignored." << std::flush;
-        }
-    bool const dob_pasted = contains(headers, "DateOfBirth");
-    bool const age_pasted = contains(headers, "IssueAge");
-    if(dob_pasted && age_pasted)
-        {
-        alarum()
-            << "Cannot paste both 'DateOfBirth' and 'IssueAge'."
-            << LMI_FLUSH
-            ;
-        }
-    else if(dob_pasted)
-        {
-        archetype["UseDOB"] = "Yes";
-        }
-    else if(age_pasted)
-        {
-        archetype["UseDOB"] = "No";
-        }
-    else
-        {
-        ; // Do nothing: neither age nor DOB pasted.
-        }
-
-    cells.reserve(std::count(census_data.begin(), census_data.end(), '\n'));
+    census_import_result z = import_census
+        (ClipboardEx::GetText()
+        ,case_parms()[0]
+        );
+    Input& archetype = z.archetype;
+    std::vector<Input>& cells = z.cells;
 
-    // Read each subsequent line into an input object representing one cell.
-    int current_line = 0;
-    while(std::getline(iss_census, line, '\n'))
+    if(cells.empty())
         {
-        ++current_line;
-
-        iss_census >> std::ws;
-
-        Input current_cell(archetype);
-
-        std::istringstream iss_line(line);
-        std::string token;
-        std::vector<std::string> values;
-
-        while(std::getline(iss_line, token, '\t'))
-            {
-            values.push_back(token);
-            }
-
-        if(values.size() != headers.size())
-            {
-            alarum()
-                << "Line #" << current_line << ": "
-                << "  (" << line << ") "
-                << "should have one value per column. "
-                << "Number of values: " << values.size() << "; "
-                << "number expected: " << headers.size() << "."
-                << LMI_FLUSH
-                ;
-            }
-
-        for(int j = 0; j < lmi::ssize(headers); ++j)
-            {
-            if(exact_cast<tnr_date>(current_cell[headers[j]]))
-                {
-                int constexpr jdn_min = calendar_date::gregorian_epoch_jdn;
-                int constexpr jdn_max = calendar_date::last_yyyy_date_jdn;
-                static int const ymd_min = JdnToYmd(jdn_t(jdn_min)).value();
-                static int const ymd_max = JdnToYmd(jdn_t(jdn_max)).value();
-                int z = value_cast<int>(values[j]);
-                if(jdn_min <= z && z <= jdn_max)
-                    {
-                    ; // Do nothing: JDN is the default expectation.
-                    }
-                else if(ymd_min <= z && z <= ymd_max)
-                    {
-                    z = YmdToJdn(ymd_t(z)).value();
-                    values[j] = value_cast<std::string>(z);
-                    }
-                else
-                    {
-                    alarum()
-                        << "Invalid date " << values[j]
-                        << " for '" << headers[j] << "'"
-                        << " on line " << current_line << "."
-                        << LMI_FLUSH
-                        ;
-                    }
-                }
-            current_cell[headers[j]] = values[j];
-            }
-        current_cell.Reconcile();
-        current_cell.RealizeAllSequenceInput();
-        cells.push_back(current_cell);
-
-        status() << "Added cell number " << cells.size() << '.' << std::flush;
+        return; // import_census() has already explained why.
         }
 
-    if(0 == current_line)
-        {
-        warning() << "No cells to paste." << LMI_FLUSH;
-        return;
-        }
+    status() << "Added " << cells.size() << " cells." << std::flush;
 
     auto const old_rows = grid_table_->GetNumberRows();
 
@@ -0,0 +1,62 @@
+// Replace global operator new() and operator delete() to count usage.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "memory_usage.hpp"
+
+#include <cstddef>                      // size_t
+
+// Link this file only into programs that should count heap usage;
+// see memory_usage.hpp.
+//
+// The array and nothrow forms call these replacements by default;
+// the overaligned forms are not replaced, so they are not counted.
+
+void* operator new(std::size_t size)
+{
+    return counted_allocation(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return counted_allocation(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    counted_deallocation(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    counted_deallocation(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    counted_deallocation(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    counted_deallocation(p);
+}
@@ -26,6 +26,13 @@
 #include <istream>
 #include <ostream>
 
+datum_base& datum_base::operator=(datum_base const& z)
+{
+    enabled_ = z.enabled_;
+    note_change();
+    return *this;
+}
+
 void datum_base::enable(bool b)
 {
     enabled_ = b;
@@ -36,6 +43,16 @@ bool datum_base::is_enabled() const
     return enabled_;
 }
 
+std::uint64_t datum_base::revision() const
+{
+    return revision_;
+}
+
+void datum_base::note_change()
+{
+    ++revision_;
+}
+
 std::istream& operator>>(std::istream& is, datum_base& z)
 {
     return z.read(is);
@@ -26,24 +26,41 @@
 
 #include "so_attributes.hpp"
 
+#include <cstdint>                      // uint64_t
 #include <iosfwd>
 
-// Implicitly-declared special member functions do the right thing.
+/// Base class for MVC data.
+///
+/// revision() changes whenever the value may have changed, so that a
+/// Model can tell which data need to be examined again: see
+/// MvcModel::Reconcile(). Every derived-class function that writes
+/// the value must call note_change(). Copy assignment does so here,
+/// because the target's history is not the source's; the implicitly-
+/// declared copy assignment of every derived class calls it.
 
 class LMI_SO datum_base
 {
   public:
     datum_base() = default;
+    datum_base(datum_base const&) = default;
     virtual ~datum_base() = default;
 
+    datum_base& operator=(datum_base const&);
+
     void enable(bool);
     bool is_enabled() const;
 
+    std::uint64_t revision() const;
+
     virtual std::istream& read (std::istream&)       = 0;
     virtual std::ostream& write(std::ostream&) const = 0;
 
+  protected:
+    void note_change();
+
   private:
-    bool enabled_ {true};
+    bool          enabled_  {true};
+    std::uint64_t revision_ {0};
 };
 
 std::istream& operator>>(std::istream&, datum_base&);
@@ -34,6 +34,7 @@ datum_boolean::datum_boolean(bool value)
 datum_boolean& datum_boolean::operator=(bool b)
 {
     value_ = b;
+    note_change();
     return *this;
 }
 
@@ -44,7 +45,9 @@ bool datum_boolean::value() const
 
 std::istream& datum_boolean::read(std::istream& is)
 {
-    return is >> value_;
+    is >> value_;
+    note_change();
+    return is;
 }
 
 std::ostream& datum_boolean::write(std::ostream& os) const
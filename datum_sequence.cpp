@@ -202,17 +202,15 @@ std::map<std::string,std::string> const payment_sequence::allowed_keywords() con
         return std::map<std::string,std::string>();
         }
 
-    static std::map<std::string,std::string> all_keywords;
-    if(all_keywords.empty())
-        {
-        all_keywords["minimum" ] = "PmtMinimum" ;
-        all_keywords["target"  ] = "PmtTarget"  ;
-        all_keywords["sevenpay"] = "Pmt7PP"     ;
-        all_keywords["glp"     ] = "PmtGLP"     ;
-        all_keywords["gsp"     ] = "PmtGSP"     ;
-        all_keywords["corridor"] = "PmtCorridor";
-        all_keywords["table"   ] = "PmtTable"   ;
-        }
+    static std::map<std::string,std::string> const all_keywords
+        {{"minimum" , "PmtMinimum"}
+        ,{"target"  , "PmtTarget"}
+        ,{"sevenpay", "Pmt7PP"}
+        ,{"glp"     , "PmtGLP"}
+        ,{"gsp"     , "PmtGSP"}
+        ,{"corridor", "PmtCorridor"}
+        ,{"table"   , "PmtTable"}
+        };
     std::map<std::string,std::string> permissible_keywords = all_keywords;
 
     return permissible_keywords;
@@ -239,14 +237,12 @@ std::string const mode_sequence::default_keyword() const
 std::map<std::string,std::string> const mode_sequence::allowed_keywords() const
 {
     LMI_ASSERT(!keyword_values_are_blocked());
-    static std::map<std::string,std::string> all_keywords;
-    if(all_keywords.empty())
-        {
-        all_keywords["annual"    ] = "Annual"    ;
-        all_keywords["semiannual"] = "Semiannual";
-        all_keywords["quarterly" ] = "Quarterly" ;
-        all_keywords["monthly"   ] = "Monthly"   ;
-        }
+    static std::map<std::string,std::string> const all_keywords
+        {{"annual"    , "Annual"}
+        ,{"semiannual", "Semiannual"}
+        ,{"quarterly" , "Quarterly"}
+        ,{"monthly"   , "Monthly"}
+        };
     std::map<std::string,std::string> permissible_keywords = all_keywords;
     return permissible_keywords;
 }
@@ -276,17 +272,15 @@ std::map<std::string,std::string> const specamt_sequence::allowed_keywords() con
         return std::map<std::string,std::string>();
         }
 
-    static std::map<std::string,std::string> all_keywords;
-    if(all_keywords.empty())
-        {
-        all_keywords["maximum" ] = "SAMaximum" ;
-        all_keywords["target"  ] = "SATarget"  ;
-        all_keywords["sevenpay"] = "SA7PP"     ;
-        all_keywords["glp"     ] = "SAGLP"     ;
-        all_keywords["gsp"     ] = "SAGSP"     ;
-        all_keywords["corridor"] = "SACorridor";
-        all_keywords["salary"  ] = "SASalary"  ;
-        }
+    static std::map<std::string,std::string> const all_keywords
+        {{"maximum" , "SAMaximum"}
+        ,{"target"  , "SATarget"}
+        ,{"sevenpay", "SA7PP"}
+        ,{"glp"     , "SAGLP"}
+        ,{"gsp"     , "SAGSP"}
+        ,{"corridor", "SACorridor"}
+        ,{"salary"  , "SASalary"}
+        };
     std::map<std::string,std::string> permissible_keywords = all_keywords;
 
     return permissible_keywords;
@@ -313,14 +307,12 @@ std::string const dbo_sequence::default_keyword() const
 std::map<std::string,std::string> const dbo_sequence::allowed_keywords() const
 {
     LMI_ASSERT(!keyword_values_are_blocked());
-    static std::map<std::string,std::string> all_keywords;
-    if(all_keywords.empty())
-        {
-        all_keywords["a"  ] = "A"  ;
-        all_keywords["b"  ] = "B"  ;
-        all_keywords["rop"] = "ROP";
-        all_keywords["mdb"] = "MDB";
-        }
+    static std::map<std::string,std::string> const all_keywords
+        {{"a"  , "A"}
+        ,{"b"  , "B"}
+        ,{"rop", "ROP"}
+        ,{"mdb", "MDB"}
+        };
     std::map<std::string,std::string> permissible_keywords = all_keywords;
     return permissible_keywords;
 }
@@ -36,6 +36,7 @@ datum_string::datum_string(std::string const& value)
 datum_string& datum_string::operator=(std::string const& s)
 {
     value_ = s;
+    note_change();
     return *this;
 }
 
@@ -48,6 +49,7 @@ std::istream& datum_string::read(std::istream& is)
 {
     std::locale old_locale = is.imbue(blank_is_not_whitespace_locale());
     is >> value_;
+    note_change();
     is.imbue(old_locale);
     return is;
 }
@@ -40,6 +40,7 @@ class death_benefits final
         ,yare_input       const&
         ,round_to<double> const& round_specamt
         );
+    death_benefits(death_benefits const&) = default;
     ~death_benefits() = default;
 
     void set_specamt (currency z, int from_year, int to_year);
@@ -50,7 +51,6 @@ class death_benefits final
     std::vector<currency>     const& supplamt() const;
 
   private:
-    death_benefits(death_benefits const&) = delete;
     death_benefits& operator=(death_benefits const&) = delete;
 
     int length_;
@@ -25,11 +25,60 @@
 #include "config.hpp"
 
 #include "assert_lmi.hpp"
+#include "numeric_io_traits.hpp"        // LMI_NUMERIC_IO_CHARCONV
 #include "ssize_lmi.hpp"                // sstrlen()
 
+#include <charconv>                     // to_chars()
+#include <cmath>                        // isfinite()
 #include <cstdio>                       // snprintf()
 #include <cstring>                      // strchr()
 #include <string>
+#include <system_error>                 // errc
+
+/// Format a double as std::snprintf() with format "%#.*f" would.
+///
+/// Writes a null-terminated string to 'buffer' and returns its length,
+/// which must be less than 'buffer_size'. Uses std::to_chars() where
+/// it is fully supported, because it's much faster; it produces the
+/// same characters, except that it ignores the C locale, and the '#'
+/// flag (which forces a decimal point if the number is finite) must
+/// be emulated.
+
+inline int fixed_to_buffer
+    (char*  buffer
+    ,int    buffer_size
+    ,double value
+    ,int    decimals
+    )
+{
+#if defined LMI_NUMERIC_IO_CHARCONV
+    std::to_chars_result const r = std::to_chars
+        (buffer
+        ,buffer + buffer_size - 2
+        ,value
+        ,std::chars_format::fixed
+        ,decimals
+        );
+    LMI_ASSERT(std::errc() == r.ec);
+    char* p = r.ptr;
+    if(0 == decimals && std::isfinite(value))
+        {
+        *p++ = '.';
+        }
+    *p = '\0';
+    return static_cast<int>(p - buffer);
+#else  // !defined LMI_NUMERIC_IO_CHARCONV
+    int const length = std::snprintf
+        (buffer
+        ,buffer_size
+        ,"%#.*f"
+        ,decimals
+        ,value
+        );
+    LMI_ASSERT(0 < length && length < buffer_size);
+    return length;
+#endif // !defined LMI_NUMERIC_IO_CHARCONV
+}
 
 /// Format a double using thousands separators. Reference:
 ///   https://groups.google.com/groups?selm=38C9B681.B8A036DF%40flash.net
@@ -48,8 +97,8 @@ inline std::string duff_fmt(double value, int decimals)
     char* p = in_buf;
     char* q = out_buf;
 
-    // Use '#' to force a decimal point unless infinite or NaN.
-    int const length = std::snprintf(p, buffer_size, "%#.*f", decimals, value);
+    // Force a decimal point unless infinite or NaN.
+    int const length = fixed_to_buffer(p, buffer_size, value, decimals);
     LMI_ASSERT(0 < length && length < buffer_size);
     LMI_ASSERT(lmi::sstrlen(p) == length);
 
@@ -23,13 +23,90 @@
 
 #include "duff_fmt.hpp"
 
-#include "miscellany.hpp"               // begins_with()
+#include "miscellany.hpp"               // begins_with(), stifle_unused_warning()
 #include "test_tools.hpp"
+#include "timer.hpp"
 
+#include <cstdio>                       // snprintf()
 #include <limits>
+#include <random>
+
+namespace
+{
+/// Format as duff_fmt() traditionally did, with std::snprintf().
+
+std::string snprintf_fixed(double value, int decimals)
+{
+    char buffer[1000];
+    int const length = std::snprintf(buffer, sizeof buffer, "%#.*f", decimals, value);
+    LMI_ASSERT(0 < length && length < lmi::ssize(buffer));
+    return buffer;
+}
+
+std::string fixed(double value, int decimals)
+{
+    char buffer[1000];
+    int const length = fixed_to_buffer(buffer, lmi::ssize(buffer), value, decimals);
+    LMI_ASSERT(lmi::sstrlen(buffer) == length);
+    return buffer;
+}
+
+void mete_snprintf()
+{
+    std::string s = snprintf_fixed(1234567.891, 2);
+    stifle_unused_warning(s);
+}
+
+void mete_fixed_to_buffer()
+{
+    std::string s = fixed(1234567.891, 2);
+    stifle_unused_warning(s);
+}
+
+void mete_duff_fmt()
+{
+    std::string s = duff_fmt(1234567.891, 2);
+    stifle_unused_warning(s);
+}
+} // Unnamed namespace.
+
+/// Test that fixed_to_buffer() formats just as std::snprintf() does.
+
+void test_fixed_to_buffer()
+{
+    constexpr double inf {std::numeric_limits<double>::infinity()};
+    constexpr double nan {std::numeric_limits<double>::quiet_NaN()};
+    for(double d : {0.0, -0.0, 0.5, 1.5, 2.5, -2.5, 1999.995, 1.0e300, inf, -inf, nan})
+        {
+        for(int j = 0; j < 20; ++j)
+            {
+            LMI_TEST_EQUAL(snprintf_fixed(d, j), fixed(d, j));
+            }
+        }
+
+    std::mt19937_64 g;
+    std::uniform_real_distribution<double> u(-1.0e10, 1.0e10);
+    for(int i = 0; i < 100000; ++i)
+        {
+        double const d = u(g);
+        int const j = static_cast<int>(g() % 10);
+        LMI_TEST_EQUAL(snprintf_fixed(d, j), fixed(d, j));
+        LMI_TEST_EQUAL(snprintf_fixed(i / 100.0, 2), fixed(i / 100.0, 2));
+        }
+
+    std::cout
+        << "Speed tests..."
+        << "\n  snprintf()       : " << TimeAnAliquot(mete_snprintf       )
+        << "\n  fixed_to_buffer(): " << TimeAnAliquot(mete_fixed_to_buffer)
+        << "\n  duff_fmt()       : " << TimeAnAliquot(mete_duff_fmt       )
+        << std::endl
+        ;
+}
 
 int test_main(int, char*[])
 {
+    test_fixed_to_buffer();
+
     // Format positive numbers, with two decimals.
     LMI_TEST_EQUAL( "1,234,567,890.14", duff_fmt( 1234567890.14159, 2));
     LMI_TEST_EQUAL(   "234,567,890.14", duff_fmt(  234567890.14159, 2));
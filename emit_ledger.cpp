@@ -31,7 +31,9 @@
 #include "group_quote_pdf_gen.hpp"
 #include "ledger.hpp"
 #include "ledger_pdf.hpp"
+#include "ledger_snapshot.hpp"
 #include "ledger_text_formats.hpp"
+#include "memory_usage.hpp"
 #include "miscellany.hpp"               // ios_out_trunc_binary()
 #include "path.hpp"
 #include "path_utility.hpp"             // unique_filepath()
@@ -51,6 +53,7 @@ ledger_emitter::ledger_emitter
     )
     :case_filepath_ {case_filepath}
     ,emission_      {emission}
+    ,allocations_   {0}
 {
     LMI_ASSERT(!case_filepath_.empty());
 
@@ -88,6 +91,7 @@ ledger_emitter::~ledger_emitter() = default;
 
 double ledger_emitter::initiate()
 {
+    heap_usage const usage = this_thread_heap_usage();
     Timer timer;
 
     if(emission_ & mce_emit_group_roster)
@@ -99,6 +103,7 @@ double ledger_emitter::initiate()
         group_quote_pdf_gen_ = group_quote_pdf_generator::create();
         }
 
+    allocations_ += allocations_since(usage);
     return timer.stop().elapsed_seconds();
 }
 
@@ -109,6 +114,7 @@ double ledger_emitter::emit_cell
     ,Ledger const& ledger
     )
 {
+    heap_usage const usage = this_thread_heap_usage();
     Timer timer;
     if((emission_ & mce_emit_composite_only) && !ledger.is_composite())
         {
@@ -137,6 +143,14 @@ double ledger_emitter::emit_cell
             );
         ledger.Spew(ofs);
         }
+    if(emission_ & mce_emit_test_snapshot)
+        {
+        fs::ofstream ofs
+            (fs::path{cell_filepath}.replace_extension(".snapshot")
+            ,ios_out_trunc_binary()
+            );
+        ledger.Snapshot().write(ofs);
+        }
     if(emission_ & mce_emit_spreadsheet)
         {
         PrintCellTabDelimited(ledger, case_filepath_spreadsheet_.string());
@@ -191,6 +205,7 @@ double ledger_emitter::emit_cell
         }
 
   done:
+    allocations_ += allocations_since(usage);
     return timer.stop().elapsed_seconds();
 }
 
@@ -198,6 +213,7 @@ double ledger_emitter::emit_cell
 
 double ledger_emitter::finish()
 {
+    heap_usage const usage = this_thread_heap_usage();
     Timer timer;
 
     if(emission_ & mce_emit_group_quote)
@@ -205,9 +221,17 @@ double ledger_emitter::finish()
         group_quote_pdf_gen_->save(case_filepath_group_quote_.string());
         }
 
+    allocations_ += allocations_since(usage);
     return timer.stop().elapsed_seconds();
 }
 
+/// Number of allocations made by this object's member functions.
+
+std::uint64_t ledger_emitter::allocations() const
+{
+    return allocations_;
+}
+
 /// Emit a single ledger in various guises.
 ///
 /// Return time spent, which is almost always wanted.
@@ -28,6 +28,7 @@
 #include "path.hpp"
 #include "so_attributes.hpp"
 
+#include <cstdint>
 #include <memory>                       // unique_ptr
 
 class Ledger;
@@ -48,12 +49,15 @@ class LMI_SO ledger_emitter final
     double emit_cell(fs::path const& cell_filepath, Ledger const& ledger);
     double finish   ();
 
+    std::uint64_t allocations() const;
+
   private:
     ledger_emitter(ledger_emitter const&) = delete;
     ledger_emitter& operator=(ledger_emitter const&) = delete;
 
     fs::path const& case_filepath_;
     mcenum_emission emission_;
+    std::uint64_t   allocations_;
 
     // Initialized only if required by emission_; empty otherwise.
     fs::path case_filepath_spreadsheet_;
@@ -56,6 +56,7 @@
 #include <algorithm>
 #include <functional>                   // bind() et al.
 #include <iterator>                     // back_inserter()
+#include <stdexcept>
 #include <string>
 #include <valarray>
 #include <vector>
@@ -122,6 +123,8 @@ namespace
     std::vector<double> pv0;
     std::vector<double> pv1;
     std::vector<double> pv2;
+    std::vector<double> pv3;
+    std::vector<double> pv4;
 } // Unnamed namespace.
 
 // These 'mete*' functions perform the same set of operations using
@@ -265,6 +268,30 @@ void mete_pete()
         }
 }
 
+/// Two assignments with common operands, evaluated one at a time.
+
+void mete_pete_separate()
+{
+    for(int i = 0; i < n_iter; ++i)
+        {
+        pv3 += pv0 - 2.1 * pv1;
+        pv4 += pv0 * pv1;
+        }
+}
+
+/// The same assignments, evaluated in a single pass.
+
+void mete_pete_fused()
+{
+    for(int i = 0; i < n_iter; ++i)
+        {
+        Fuse
+            (Deferred(pv3, OpAddAssign(), pv0 - 2.1 * pv1)
+            ,Deferred(pv4, OpAddAssign(), pv0 * pv1)
+            );
+        }
+}
+
 void run_one_test(std::string const& s, void(*f)())
 {
     double const max_seconds = 1.0;
@@ -402,6 +429,8 @@ void time_one_array_length(int length)
     pv0 = std::vector<double>(cv0, cv0 + g_length);
     pv1 = std::vector<double>(cv1, cv1 + g_length);
     pv2 = std::vector<double>(cv2, cv2 + g_length);
+    pv3 = std::vector<double>(cv2, cv2 + g_length);
+    pv4 = std::vector<double>(cv2, cv2 + g_length);
 
     int const alpha = 1 < g_length ? 1 : 0;
     int const omega = g_length - 1;
@@ -428,6 +457,9 @@ void time_one_array_length(int length)
     mete_pete();
     LMI_TEST(materially_equal(pv2[omega], value_omega));
 
+    mete_pete_fused();
+    LMI_TEST(materially_equal(pv3[omega], value_omega));
+
     run_one_test("C               ", mete_c        );
     run_one_test("STL plain       ", mete_stl_plain);
     run_one_test("STL fancy       ", mete_stl_fancy);
@@ -443,6 +475,11 @@ void time_one_array_length(int length)
     run_one_test("PETE typical    ", mete_pete_typical    );
 
     std::cout << std::endl;
+
+    run_one_test("PETE separate   ", mete_pete_separate   );
+    run_one_test("PETE fused      ", mete_pete_fused      );
+
+    std::cout << std::endl;
 }
 
 /// Assigning PETE expressions to a std::vector
@@ -489,6 +526,71 @@ void test_pete_assignment()
 //  v7f += v0 - v1;
 }
 
+/// Fused assignments give the same results as separate assignments.
+///
+/// Lengths that are and are not multiples of the block size are
+/// tested, as are assignments whose targets are also operands.
+
+void test_fusion()
+{
+    for(int n : {0, 1, 3, 4, 5, 8, 13})
+        {
+        std::vector<double> v0(n);
+        std::vector<double> v1(n);
+        for(int j = 0; j < n; ++j)
+            {
+            v0[j] = 1.0 + j;
+            v1[j] = 0.1 * j;
+            }
+
+        std::vector<double> a0(v0);
+        std::vector<double> a1(v1);
+        std::vector<double> a2(n, 2.0);
+        a0 += a0 * a1;
+        a1 -= a0 / a2;
+        a2 *= a1 + a0;
+
+        std::vector<double> b0(v0);
+        std::vector<double> b1(v1);
+        std::vector<double> b2(n, 2.0);
+        Fuse
+            (Deferred(b0, OpAddAssign()     , b0 * b1)
+            ,Deferred(b1, OpSubtractAssign(), b0 / b2)
+            ,Deferred(b2, OpMultiplyAssign(), b1 + b0)
+            );
+
+        LMI_TEST(a0 == b0);
+        LMI_TEST(a1 == b1);
+        LMI_TEST(a2 == b2);
+
+        // Elements of std::vector<bool> are evaluated one at a time.
+        std::vector<bool> c0(n);
+        std::vector<bool> c1(n);
+        Fuse
+            (Deferred(c0, OpAssign(), v1 < v0)
+            ,Deferred(c1, OpAssign(), v0 < v1)
+            );
+        LMI_TEST(std::vector<bool>(n, true ) == c0);
+        LMI_TEST(std::vector<bool>(n, false) == c1);
+        }
+
+    std::vector<double> v3(3);
+    std::vector<double> v4(4);
+    LMI_TEST_THROW
+        (Fuse
+            (Deferred(v4, OpAssign(), v4 + 1.0)
+            ,Deferred(v3, OpAssign(), v3 + 1.0)
+            )
+        ,std::runtime_error
+        ,"Fused assignments' lengths differ: 4 vs. 3."
+        );
+    LMI_TEST_THROW
+        (Fuse(Deferred(v4, OpAssign(), v3 + 1.0))
+        ,std::runtime_error
+        ,"Nonconformable lengths: 4 lhs vs. 3 rhs."
+        );
+}
+
 int test_main(int, char*[])
 {
     time_one_array_length(1);
@@ -498,6 +600,7 @@ int test_main(int, char*[])
     time_one_array_length(10000);
 
     test_pete_assignment();
+    test_fusion();
 
     return 0;
 }
@@ -234,6 +234,8 @@ extern "C"
 #endif // defined __cplusplus
 double fdlibm_expm1(double);
 double fdlibm_log1p(double);
+void fdlibm_expm1_n(double const*, double*, int);
+void fdlibm_log1p_n(double const*, double*, int);
 #if defined __cplusplus
 } // extern "C"
 #endif // defined __cplusplus
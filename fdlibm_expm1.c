@@ -258,6 +258,50 @@ double fdlibm_expm1(double x)
     }
     return y;
 }
+
+// Batch expm1(): y[j] = fdlibm_expm1(x[j]) for j in [0, n).
+//
+// For arguments in the primary range, 2^-54 <= |x| <= 0.5 ln2, no
+// argument reduction is needed, and fdlibm_expm1() evaluates only
+// its rational approximation. That is the usual case for monthly
+// rates. The loop that evaluates it here performs the same floating
+// operations in the same order, so results are bit-identical; but
+// it has no branches and a fixed trip count, so compilers vectorize
+// it. Any other argument is passed to fdlibm_expm1() itself.
+//
+// Arguments are copied into a local block first, so 'x' and 'y' may
+// be the same array.
+
+void fdlibm_expm1_n(double const* x, double* y, int n)
+{
+    enum {block = 64};
+    double a[block];
+    double b[block];
+    for(int i = 0; i < n; i += block) {
+        int const m = (n - i < block) ? n - i : block;
+        for(int j = 0; j < block; ++j) {
+            a[j] = (j < m) ? x[i + j] : 0.0;
+        }
+        for(int j = 0; j < block; ++j) {
+            double const v   = a[j];
+            double const hfx = 0.5*v;
+            double const hxs = v*hfx;
+            double const R1  = one+hxs*Q1;
+            double const h2  = hxs*hxs;
+            double const R2  = Q2+hxs*Q3;
+            double const h4  = h2*h2;
+            double const R3  = Q4+hxs*Q5;
+            double const r1  = R1 + h2*R2 + h4*R3;
+            double const t   = 3.0-r1*hfx;
+            double const e   = hxs*((r1-t)/(6.0 - v*t));
+            b[j] = v - (v*e-hxs);
+        }
+        for(int j = 0; j < m; ++j) {
+            uint32_t const hx = hi_uint(a[j]) & 0x7fffffff;
+            y[i + j] = (0x3fd62e42 < hx || hx < 0x3c900000) ? fdlibm_expm1(a[j]) : b[j];
+        }
+    }
+}
 #if defined __cplusplus && defined LMI_GCC
 #   pragma GCC diagnostic pop
 #endif // defined __cplusplus && defined LMI_GCC
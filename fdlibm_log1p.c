@@ -210,6 +210,57 @@ double fdlibm_log1p(double x)
     if(k==0) return f-(hfsq-s*(hfsq+R)); else
              return k*ln2_hi-((hfsq-(s*(hfsq+R)+(k*ln2_lo+c)))-f);
 }
+
+// Batch log1p(): y[j] = fdlibm_log1p(x[j]) for j in [0, n).
+//
+// For arguments in (-0.2929, 0.41422) with |x| >= 2^-29, no argument
+// reduction is needed, and fdlibm_log1p() evaluates only its
+// polynomial approximation. That is the usual case for annual rates.
+// The loop that evaluates it here performs the same floating
+// operations in the same order, so results are bit-identical; but
+// it has no branches and a fixed trip count, so compilers vectorize
+// it. Any other argument is passed to fdlibm_log1p() itself.
+//
+// Arguments are copied into a local block first, so 'x' and 'y' may
+// be the same array.
+
+void fdlibm_log1p_n(double const* x, double* y, int n)
+{
+    enum {block = 64};
+    double a[block];
+    double b[block];
+    for(int i = 0; i < n; i += block) {
+        int const m = (n - i < block) ? n - i : block;
+        for(int j = 0; j < block; ++j) {
+            a[j] = (j < m) ? x[i + j] : 0.0;
+        }
+        for(int j = 0; j < block; ++j) {
+            double const f    = a[j];
+            double const hfsq = 0.5*f*f;
+            double const s    = f/(2.0+f);
+            double const z    = s*s;
+            double const R1   =     z*Lp1;
+            double const z2   = z*z;
+            double const R2   = Lp2+z*Lp3;
+            double const z4   = z2*z2;
+            double const R3   = Lp4+z*Lp5;
+            double const z6   = z4*z2;
+            double const R4   = Lp6+z*Lp7;
+            double const R    = R1 + z2*R2 + z4*R3 + z6*R4;
+            b[j] = f-(hfsq-s*(hfsq+R));
+        }
+        for(int j = 0; j < m; ++j) {
+            int32_t const hx = hi_int(a[j]);
+            int32_t const ax = hx&0x7fffffff;
+            int const reduced =
+                   0x3FDA827A <= hx                          // x >= 0.41422
+                || (hx < 0 && ((int32_t)0xbfd2bec3) < hx)    // x <= -0.2929
+                || ax < 0x3e200000                           // |x| < 2**-29
+                ;
+            y[i + j] = reduced ? fdlibm_log1p(a[j]) : b[j];
+        }
+    }
+}
 #if defined __cplusplus && defined LMI_GCC
 #   pragma GCC diagnostic pop
 #endif // defined __cplusplus && defined LMI_GCC
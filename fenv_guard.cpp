@@ -48,4 +48,4 @@ int fenv_guard::instance_count()
     return instance_count_;
 }
 
-int fenv_guard::instance_count_ = 0;
+std::atomic<int> fenv_guard::instance_count_ {0};
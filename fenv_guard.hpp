@@ -26,6 +26,8 @@
 
 #include "so_attributes.hpp"
 
+#include <atomic>
+
 /// Guard class for critical floating-point calculations.
 ///
 /// Invariant: the floating-point control word has the desired value.
@@ -35,7 +37,9 @@
 /// dtor: display an error message if the invariant wasn't maintained.
 ///
 /// Intended use: instantiate on the stack at the beginning of any
-/// floating-point calculations that presume the invariant.
+/// floating-point calculations that presume the invariant. Each
+/// thread that performs such calculations needs its own instance,
+/// so instances are counted atomically.
 
 class LMI_SO fenv_guard final
 {
@@ -49,7 +53,7 @@ class LMI_SO fenv_guard final
     fenv_guard(fenv_guard const&) = delete;
     fenv_guard& operator=(fenv_guard const&) = delete;
 
-    static int instance_count_;
+    static std::atomic<int> instance_count_;
 };
 
 #endif // fenv_guard_hpp
@@ -26,6 +26,7 @@
 #include "account_value.hpp"
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "calculation_channel.hpp"
 #include "configurable_settings.hpp"
 #include "contains.hpp"
 #include "currency.hpp"
@@ -33,9 +34,12 @@
 #include "fenv_guard.hpp"
 #include "input.hpp"
 #include "ledger.hpp"
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
 #include "ledgervalues.hpp"
 #include "materially_equal.hpp"
 #include "mc_enum_types_aux.hpp"        // mc_str()
+#include "memory_usage.hpp"
 #include "path_utility.hpp"
 #include "progress_meter.hpp"
 #include "ssize_lmi.hpp"
@@ -84,6 +88,29 @@ int intermission_between_printouts(mcenum_emission emission)
     return (emission & mce_emit_pdf_to_printer) ? pause : 0;
 }
 
+/// Estimated memory footprint of a ledger: its vectors that are
+/// accessible by name, which hold nearly all of its data.
+
+double estimated_footprint(Ledger const& ledger)
+{
+    auto const vector_bytes = [](LedgerBase const& z)
+        {
+        double n = 0.0;
+        for(auto const& i : z.all_vectors())
+            {
+            n += static_cast<double>(sizeof(double) * i.second->capacity());
+            }
+        return n;
+        };
+    LedgerInvariant const& invariant = ledger.GetLedgerInvariant();
+    double z = sizeof ledger + sizeof invariant + vector_bytes(invariant);
+    for(auto const& i : ledger.GetLedgerMap().held())
+        {
+        z += sizeof i.second + vector_bytes(i.second);
+        }
+    return z;
+}
+
 progress_meter::enum_display_mode progress_meter_mode(mcenum_emission emission)
 {
     return (emission & mce_emit_quietly)
@@ -129,6 +156,7 @@ census_run_result run_census_in_series::operator()
     )
 {
     Timer timer;
+    heap_usage const usage = this_thread_heap_usage();
     census_run_result result;
     std::unique_ptr<progress_meter> meter
         (create_progress_meter
@@ -173,6 +201,9 @@ census_run_result run_census_in_series::operator()
     double total_seconds = timer.stop().elapsed_seconds();
     status() << Timer::elapsed_msec_str(total_seconds) << std::flush;
     result.seconds_for_calculations_ = total_seconds - result.seconds_for_output_;
+    result.allocations_for_output_ = emitter.allocations();
+    result.allocations_for_calculations_ =
+        allocations_since(usage) - result.allocations_for_output_;
     return result;
 }
 
@@ -184,6 +215,11 @@ census_run_result run_census_in_parallel::operator()
     )
 {
     Timer timer;
+    heap_usage const usage = this_thread_heap_usage();
+    bool const measure_footprints = mce_emit_timings & emission;
+    double input_bytes         = 0.0;
+    double account_value_bytes = 0.0;
+    double ledger_bytes        = 0.0;
     census_run_result result;
     std::unique_ptr<progress_meter> meter
         (create_progress_meter
@@ -196,6 +232,7 @@ census_run_result run_census_in_parallel::operator()
     ledger_emitter emitter(file, emission);
 
     std::vector<AccountValue> cell_values;
+    std::vector<std::shared_ptr<Ledger const>> ledgers;
     std::vector<mcenum_run_basis> const& RunBases = composite.GetRunBases();
 
     int const first_cell_inforce_year  = value_cast<int>((*cells.begin())["InforceYear"].str());
@@ -211,8 +248,17 @@ census_run_result run_census_in_parallel::operator()
             {
             { // Begin fenv_guard scope.
             fenv_guard fg;
+            heap_usage const before = this_thread_heap_usage();
             cell_values.emplace_back(ip);
             AccountValue& av = cell_values.back();
+            if(measure_footprints)
+                {
+                account_value_bytes +=
+                      sizeof av
+                    + static_cast<double>(this_thread_heap_usage().live_bytes - before.live_bytes)
+                    ;
+                input_bytes += static_cast<double>(copy_footprint(ip));
+                }
 
             std::string const name(cells[j]["InsuredName"].str());
             // Indexing: here, j is an index into cells, not cell_values.
@@ -323,6 +369,7 @@ census_run_result run_census_in_parallel::operator()
                     ;
             for(int month = inforce_month; month < 12; ++month)
                 {
+                throw_if_calculation_cancelled();
                 currency assets = C0;
 
                 // Get total case assets prior to interest crediting because
@@ -399,6 +446,10 @@ census_run_result run_census_in_parallel::operator()
         fenv_guard fg;
         i.FinalizeLifeAllBases();
         composite.PlusEq(*i.ledger_from_av());
+        if(measure_footprints)
+            {
+            ledger_bytes += estimated_footprint(*i.ledger_from_av());
+            }
         if(!meter->reflect_progress())
             {
             result.completed_normally_ = false;
@@ -407,22 +458,43 @@ census_run_result run_census_in_parallel::operator()
         }
     meter->culminate();
 
+    if(measure_footprints)
+        {
+        double const n = static_cast<double>(cell_values.size());
+        result.bytes_per_input_         = input_bytes         / n;
+        result.bytes_per_account_value_ = account_value_bytes / n;
+        result.bytes_per_ledger_        = ledger_bytes        / n;
+        }
+
+    // Only the ledgers are needed for output, so release everything
+    // else now, and release each ledger as soon as it's emitted. For
+    // a large census, that keeps output, which can itself use much
+    // memory, from raising peak usage.
+    ledgers.reserve(cell_values.size());
+    for(auto const& i : cell_values)
+        {
+        ledgers.push_back(i.ledger_from_av());
+        }
+    cell_values.clear();
+    cell_values.shrink_to_fit();
+
     result.seconds_for_output_ += emitter.initiate();
 
     meter = create_progress_meter
-        (lmi::ssize(cell_values)
+        (lmi::ssize(ledgers)
         ,"Writing output for all cells"
         ,progress_meter_mode(emission)
         );
     j = 0;
-    for(auto const& i : cell_values)
+    for(auto& i : ledgers)
         {
-        // Indexing: here, j is an index into cell_values, not cells.
+        // Indexing: here, j is an index into ledgers, not cells.
         std::string const name(cells[j]["InsuredName"].str());
         result.seconds_for_output_ += emitter.emit_cell
             (serial_file_path(file, name, j, "hastur")
-            ,*i.ledger_from_av()
+            ,*i
             );
+        i.reset();
         meter->dawdle(intermission_between_printouts(emission));
         if(!meter->reflect_progress())
             {
@@ -443,6 +515,9 @@ census_run_result run_census_in_parallel::operator()
     double total_seconds = timer.stop().elapsed_seconds();
     status() << Timer::elapsed_msec_str(total_seconds) << std::flush;
     result.seconds_for_calculations_ = total_seconds - result.seconds_for_output_;
+    result.allocations_for_output_ = emitter.allocations();
+    result.allocations_for_calculations_ =
+        allocations_since(usage) - result.allocations_for_output_;
     return result;
 }
 
@@ -477,28 +552,39 @@ census_run_result run_census::operator()
     // Use the first cell's run order for the entire census, ignoring
     // any conflicting run order for any other cell--which would have
     // been prevented upstream by assert_consistent_run_order().
-    switch(yare_input(cells[0]).RunOrder)
+    //
+    // A calculation on a worker thread may be cancelled in the middle
+    // of a cell (see 'calculation_channel.hpp'); that is reported in
+    // the same way as cancellation between cells.
+    try
         {
-        case mce_life_by_life:
+        switch(yare_input(cells[0]).RunOrder)
             {
-            result = run_census_in_series()
-                (file
-                ,emission
-                ,cells
-                ,*composite_
-                );
-            }
-            break;
-        case mce_month_by_month:
-            {
-            result = run_census_in_parallel()
-                (file
-                ,emission
-                ,cells
-                ,*composite_
-                );
+            case mce_life_by_life:
+                {
+                result = run_census_in_series()
+                    (file
+                    ,emission
+                    ,cells
+                    ,*composite_
+                    );
+                }
+                break;
+            case mce_month_by_month:
+                {
+                result = run_census_in_parallel()
+                    (file
+                    ,emission
+                    ,cells
+                    ,*composite_
+                    );
+                }
+                break;
             }
-            break;
+        }
+    catch(calculation_cancelled const&)
+        {
+        result.completed_normally_ = false;
         }
 
     // Indicate cancellation on the statusbar. This may be of little
@@ -28,6 +28,7 @@
 #include "path.hpp"
 #include "so_attributes.hpp"
 
+#include <cstdint>
 #include <memory>                       // shared_ptr
 #include <vector>
 
@@ -41,21 +42,40 @@ class Ledger;
 /// GUI progress dialog.
 ///
 /// Time is measured for calculations and output but not for input,
-/// because the census-run classes accept only preread input.
+/// because the census-run classes accept only preread input. So are
+/// allocations (see this_thread_heap_usage()).
+///
+/// Mean memory footprints per cell are measured only where all cells
+/// are held in memory at once, and only if 'emit_timings' is given;
+/// otherwise, they are zero. They are measured for:
+///  - Input: a copy of each cell's input;
+///  - AccountValue: everything allocated to construct it, including
+///    its ledger as first allocated;
+///  - Ledger: its vectors, estimated after all calculations.
 ///
 /// Implicitly-declared special member functions do the right thing.
 
 struct census_run_result
 {
     census_run_result()
-        :completed_normally_       {true}
-        ,seconds_for_calculations_ {0.0}
-        ,seconds_for_output_       {0.0}
+        :completed_normally_           {true}
+        ,seconds_for_calculations_     {0.0}
+        ,seconds_for_output_           {0.0}
+        ,allocations_for_calculations_ {0}
+        ,allocations_for_output_       {0}
+        ,bytes_per_input_              {0.0}
+        ,bytes_per_account_value_      {0.0}
+        ,bytes_per_ledger_             {0.0}
         {}
 
     bool completed_normally_;
     double seconds_for_calculations_;
     double seconds_for_output_;
+    std::uint64_t allocations_for_calculations_;
+    std::uint64_t allocations_for_output_;
+    double bytes_per_input_;
+    double bytes_per_account_value_;
+    double bytes_per_ledger_;
 };
 
 /// Run all cells in a census.
@@ -329,9 +329,9 @@ void i7702::initialize()
         }
 
     // Convert all to monthly.
-    assign(ic_usual_, apply_unary(i_upper_12_over_12_from_i<double>(), ic_usual_));
-    assign(ic_glp_  , apply_unary(i_upper_12_over_12_from_i<double>(), ic_glp_  ));
-    assign(ic_gsp_  , apply_unary(i_upper_12_over_12_from_i<double>(), ic_gsp_  ));
+    ic_usual_ = i_upper_12_over_12_from_i<double>()(ic_usual_);
+    ic_glp_   = i_upper_12_over_12_from_i<double>()(ic_glp_  );
+    ic_gsp_   = i_upper_12_over_12_from_i<double>()(ic_gsp_  );
 
     if(!each_equal(Em_, 0.0))
         {
@@ -148,9 +148,8 @@ i7702::i7702
 
     database.query_into(DB_NaarDiscount, Em_);
     bool const no_naar_discount = zero == Em_;
-    std::vector<double> theoretical_naar_discount {};
-    theoretical_naar_discount <<=
-        apply_unary(i_upper_12_over_12_from_i<double>(), Bgen_);
+    std::vector<double> const theoretical_naar_discount =
+        i_upper_12_over_12_from_i<double>()(Bgen_);
 
     std::vector<double> diff {};
     // PETE's fabs(), not std::fabs():
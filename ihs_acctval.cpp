@@ -25,6 +25,7 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "calculation_channel.hpp"
 #include "calendar_date.hpp"
 #include "contains.hpp"
 #include "database.hpp"
@@ -41,9 +42,11 @@
 #include "ledger_variant.hpp"
 #include "loads.hpp"
 #include "materially_equal.hpp"
+#include "memory_usage.hpp"
 #include "miscellany.hpp"
 #include "mortality_rates.hpp"
 #include "outlay.hpp"
+#include "parallel_for.hpp"
 #include "premium_tax.hpp"
 #include "ssize_lmi.hpp"
 #include "stratified_algorithms.hpp"
@@ -55,9 +58,12 @@
 #include <ios>                          // ios_base::fixed()
 #include <iterator>                     // back_inserter()
 #include <limits>
+#include <memory>                       // make_shared(), unique_ptr
 #include <numeric>
 #include <string>
+#include <thread>                       // this_thread::get_id()
 #include <utility>
+#include <vector>
 
 /*
 We ideally want transaction functions to be reorderable.
@@ -88,7 +94,22 @@ showing {accesses, modifies current year, modifies future years}
 
 //============================================================================
 AccountValue::AccountValue(Input const& input)
-    :BasicValues           (Input::consummate(input))
+    :AccountValue {input, nullptr}
+{
+}
+
+/// Values for an input that differs from the prototype's only in
+/// fields that don't affect rates: see BasicValues::is_rate_neutral().
+/// The prototype's rates and loads are shared through shared_ptr,
+/// so the prototype need not outlive this object.
+
+AccountValue::AccountValue(Input const& input, AccountValue const& prototype)
+    :AccountValue {input, &prototype}
+{
+}
+
+AccountValue::AccountValue(Input const& input, AccountValue const* prototype)
+    :BasicValues           (Input::consummate(input), prototype)
     ,InputFilename         {"anonymous"}
     ,DebugFilename         {"anonymous.monthly_trace"}
     ,Debugging             {false}
@@ -349,13 +370,82 @@ void AccountValue::RunAllApplicableBases()
         // TODO ?? Here we might save overriding parameters determined
         // on the solve basis.
         }
-    // Run all bases, current first.
-    for(auto const& b : ledger_->GetRunBases())
+    // Run all bases, current first. The current basis determines
+    // overriding values (e.g., payments) on which the other bases
+    // depend, but the other bases don't depend on each other, so
+    // they are projected concurrently, each on its own copy, and
+    // their results are then stored in basis order, exactly as if
+    // they had been projected serially. A monthly trace writes all
+    // bases to a single file, so it requires serial projection.
+    std::vector<mcenum_run_basis> const& bases = ledger_->GetRunBases();
+    LMI_ASSERT(!bases.empty() && mce_run_gen_curr_sep_full == bases.front());
+    RunOneBasis(bases.front());
+
+    int const n = lmi::ssize(bases) - 1;
+    if(Debugging || n < 2)
+        {
+        for(int j = 0; j < n; ++j)
+            {
+            RunOneBasis(bases[1 + j]);
+            }
+        return;
+        }
+
+    std::vector<std::unique_ptr<AccountValue>> copies(n);
+    for(auto& i : copies)
+        {
+        i = concurrent_copy();
+        }
+    // Cancellation must reach the copies' threads, too.
+    calculation_channel* const channel = current_calculation_channel();
+    // Heap usage is counted per thread, so attribute to this thread
+    // whatever the copies use on others.
+    std::thread::id const caller = std::this_thread::get_id();
+    std::vector<heap_usage> usage(n);
+    parallel_for
+        (n
+        ,[&](int j)
+            {
+            scoped_calculation_channel const scope(channel);
+            heap_usage const before = this_thread_heap_usage();
+            copies[j]->RunOneBasis(bases[1 + j]);
+            if(caller != std::this_thread::get_id())
+                {
+                usage[j] = heap_usage_since(before);
+                }
+            }
+        );
+    for(int j = 0; j < n; ++j)
         {
-        RunOneBasis(b);
+        add_to_this_thread_heap_usage(usage[j]);
+        ledger_->SetOneLedgerVariant(bases[1 + j], copies[j]->VariantValues());
         }
 }
 
+/// A copy that can be projected on another thread.
+///
+/// InitializeLife() resets the projection state for each basis, so
+/// the copy needs only the values that the current basis determined,
+/// and its own instances of everything that projection changes.
+/// Its ledger is private, and only its variant is used.
+
+std::unique_ptr<AccountValue> AccountValue::concurrent_copy() const
+{
+    LMI_ASSERT(!Debugging && !Solving && !SolvingForGuarPremium);
+    std::unique_ptr<AccountValue> z {::new AccountValue(*this)};
+    z->unshare_projection_state();
+    z->ledger_ = std::make_shared<Ledger>
+        (BasicValues::GetLength()
+        ,BasicValues::ledger_type()
+        ,BasicValues::nonillustrated()
+        ,BasicValues::no_can_issue()
+        ,false
+        );
+    z->ledger_invariant_ = std::make_shared<LedgerInvariant>(InvariantValues());
+    z->ledger_variant_   = std::make_shared<LedgerVariant  >(VariantValues  ());
+    return z;
+}
+
 //============================================================================
 /// This implementation seems slightly unnatural because it strives
 /// for similarity with run_census_in_parallel::operator(). For
@@ -378,6 +468,7 @@ void AccountValue::RunOneCell(mcenum_run_basis a_Basis)
         int inforce_month = (Year == InforceYear) ? InforceMonth : 0;
         for(int month = inforce_month; month < 12; ++month)
             {
+            throw_if_calculation_cancelled();
             Month = month;
             CoordinateCounters();
             IncrementBOM(year, month);
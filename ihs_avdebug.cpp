@@ -36,7 +36,9 @@
 #include "value_cast.hpp"
 
 #include <algorithm>
+#include <fstream>
 #include <iterator>                     // ostream_iterator
+#include <memory>                       // make_shared()
 #include <string>
 #include <vector>
 
@@ -285,13 +287,16 @@ void AccountValue::DebugPrintInit()
         return;
         }
 
-    DebugStream.open(DebugFilename.c_str(), ios_out_trunc_binary());
+    DebugStream = std::make_shared<std::ofstream>
+        (DebugFilename.c_str()
+        ,ios_out_trunc_binary()
+        );
     std::copy
         (DebugColHeaders().begin()
         ,DebugColHeaders().end()
-        ,std::ostream_iterator<std::string>(DebugStream, "\t")
+        ,std::ostream_iterator<std::string>(*DebugStream, "\t")
         );
-    DebugStream << '\n';
+    *DebugStream << '\n';
 }
 
 //============================================================================
@@ -301,7 +306,7 @@ void AccountValue::DebugEndBasis()
         {
         return;
         }
-    DebugStream << '\n';
+    *DebugStream << '\n';
 }
 
 //============================================================================
@@ -527,8 +532,8 @@ void AccountValue::DebugPrint()
     std::copy
         (DebugRecord.begin()
         ,DebugRecord.end()
-        ,std::ostream_iterator<std::string>(DebugStream, "\t")
+        ,std::ostream_iterator<std::string>(*DebugStream, "\t")
         );
-    DebugStream << '\n';
+    *DebugStream << '\n';
     DebugRecord.assign(eLast, "EMPTY");
 }
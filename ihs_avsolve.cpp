@@ -37,15 +37,19 @@
 #include "global_settings.hpp"
 #include "ledger_invariant.hpp"
 #include "ledger_variant.hpp"
-#include "mc_enum_types_aux.hpp"        // set_run_basis_from_cloven_bases()
+#include "mc_enum_types_aux.hpp"        // mc_str(), set_run_basis_from_cloven_bases()
 #include "miscellany.hpp"               // ios_out_app_binary()
 #include "null_stream.hpp"
 #include "outlay.hpp"
-#include "zero.hpp"                     // decimal_root()
+#include "zero.hpp"                     // decimal_root(), root_hint
 
 #include <algorithm>                    // min(), max()
+#include <cmath>                        // fabs(), pow()
 #include <functional>
+#include <map>
+#include <mutex>
 #include <numeric>                      // accumulate()
+#include <string>
 
 /// Helper class to provide a free function for solves.
 ///
@@ -86,6 +90,62 @@ class SolveHelper
     void (AccountValue::*solve_set_fn_)(currency);
 };
 
+namespace
+{
+/// Solutions remembered as hints for later solves of the same kind.
+///
+/// Hints are used only if 'pyx' contains "solve_hints". Neighboring
+/// cells in a census, and successive runs of the same cell after a
+/// small change, usually have nearby solutions, so the most recent
+/// solution of each kind is offered to decimal_root() as a guess.
+/// The hint's width adapts: it is twice the distance by which the
+/// previous hint of the same kind missed, but no less than one
+/// percent of the guess. A hint that misses more widely than that
+/// costs only a few evaluations, because decimal_root() widens it
+/// geometrically until it brackets a root.
+///
+/// Remembered solutions are shared by all threads. A hint affects
+/// only the number of iterations, so it doesn't matter which thread
+/// recorded it.
+
+struct remembered_solve
+{
+    double solution {0.0};
+    double miss     {0.0};
+};
+
+std::mutex remembered_solves_mutex;
+std::map<std::string,remembered_solve> remembered_solves;
+
+root_hint recall_solve(std::string const& key, int decimals)
+{
+    std::lock_guard<std::mutex> lock(remembered_solves_mutex);
+    auto const i = remembered_solves.find(key);
+    if(remembered_solves.end() == i)
+        {
+        return root_hint {};
+        }
+    double const guess = i->second.solution;
+    double const width = std::max
+        ({2.0 * i->second.miss
+        ,0.01 * guess
+        ,std::pow(10.0, -decimals)
+        });
+    return root_hint {guess, width};
+}
+
+void remember_solve
+    (std::string const& key
+    ,root_hint   const& hint
+    ,double             solution
+    )
+{
+    double const miss = 0.0 < hint.width ? std::fabs(solution - hint.guess) : 0.0;
+    std::lock_guard<std::mutex> lock(remembered_solves_mutex);
+    remembered_solves[key] = remembered_solve {solution, miss};
+}
+} // Unnamed namespace.
+
 /// Return outcome of a trial with a given input value.
 ///
 /// Naively, one might run an illustration for a given input, and
@@ -478,17 +538,42 @@ currency AccountValue::Solve
         os_trace << std::fixed << std::setprecision(std::max(2, decimals));
         }
 
+    bool const use_hints = contains(global_settings::instance().pyx(), "solve_hints");
+    std::string const hint_key =
+          yare_input_.ProductName
+        + ' ' + mc_str(a_SolveType)
+        + ' ' + mc_str(SolveTarget_)
+        + ' ' + mc_str(SolveGenBasis_)
+        + ' ' + mc_str(SolveSepBasis_)
+        + (SolvingForGuarPremium ? " guaranteed premium" : "")
+        ;
+    root_hint const hint = use_hints ? recall_solve(hint_key, decimals) : root_hint {};
+    if(0.0 < hint.width)
+        {
+        os_trace << " hint: " << hint.guess << " +/- " << hint.width << std::endl;
+        }
+
     SolveHelper solve_helper(*this, solve_set_fn);
     root_type const solution = decimal_root
         (solve_helper
         ,lower_bound
         ,upper_bound
+        ,hint
         ,bias
         ,decimals
         ,os_trace
         ,64
         );
     currency const solution_cents = round_minutiae().c(solution.root);
+    os_trace
+        << " iterations: " << solution.n_iter
+        << ", evaluations: " << solution.n_eval
+        << std::endl
+        ;
+    if(use_hints && root_is_valid == solution.validity)
+        {
+        remember_solve(hint_key, hint, solution.root);
+        }
 
     Solving = false;
 
@@ -53,16 +53,31 @@
 #include "stratified_charges.hpp"
 #include "ul_utilities.hpp"             // list_bill_premium(), max_modal_premium()
 
-#include <algorithm>                    // min()
+#include <algorithm>                    // find(), min()
 #include <cfenv>                        // fesetround()
 #include <cmath>                        // nearbyint(), pow()
 #include <functional>                   // multiplies
+#include <iterator>                     // begin(), end()
 #include <limits>
 #include <numeric>                      // accumulate(), partial_sum()
+#include <span>
 #include <stdexcept>
 
 //============================================================================
 BasicValues::BasicValues(Input const& input)
+    :BasicValues {input, nullptr}
+{
+}
+
+/// Values for an input that differs from the prototype's, if any,
+/// only in fields for which is_rate_neutral() is true.
+///
+/// Rates, loads, and 7702 interest rates depend on none of those
+/// fields, so they're shared with the prototype rather than computed
+/// again. Everything else is computed from the given input, exactly
+/// as though there were no prototype.
+
+BasicValues::BasicValues(Input const& input, BasicValues const* prototype)
     :yare_input_         (input)
     ,product_            (product_data::read_via_cache(filename_from_product_name(yare_input_.ProductName)))
     ,database_           (yare_input_)
@@ -74,7 +89,13 @@ BasicValues::BasicValues(Input const& input)
         (AddDataDir(product().datum("RoundingFilename"))))
     ,StratifiedCharges_  (stratified_charges::read_via_cache
         (AddDataDir(product().datum("TierFilename"))))
-    ,i7702_              {std::make_unique<i7702>(database(), *StratifiedCharges_)}
+    ,i7702_
+        {prototype
+        ? prototype->i7702_
+        : std::make_shared<i7702>(database(), *StratifiedCharges_)
+        }
+    ,MortalityRates_     {prototype ? prototype->MortalityRates_ : nullptr}
+    ,Loads_              {prototype ? prototype->Loads_          : nullptr}
     ,DefnLifeIns_        {mce_cvat}
     ,DefnMaterialChange_ {mce_unnecessary_premium}
     ,Effective7702DboRop {mce_option1_for_7702}
@@ -85,9 +106,46 @@ BasicValues::BasicValues(Input const& input)
     ,PremiumTaxState_    {mce_s_CT}
     ,InitialTargetPremium{0.0}
 {
+    if(prototype)
+        {
+        LMI_ASSERT(prototype->yare_input_.ProductName == yare_input_.ProductName);
+        LMI_ASSERT(prototype->yare_input_.IssueAge    == yare_input_.IssueAge   );
+        LMI_ASSERT(prototype->database().length()     == database().length()    );
+        }
     Init();
 }
 
+/// Whether an input field affects neither rates nor loads, so that
+/// values for inputs that differ only in such fields can share them.
+///
+/// The fields listed here are those that rates and loads are known
+/// not to depend on, and that are commonly varied in a scenario
+/// sweep: crediting and loan rates, premiums, face amounts, and
+/// loans and withdrawals. Any other field is conservatively assumed
+/// to affect rates.
+
+bool BasicValues::is_rate_neutral(std::string const& input_field)
+{
+    static std::string const neutral[] =
+        {"CorporationPayment"
+        ,"CorporationPaymentMode"
+        ,"DeathBenefitOption"
+        ,"GeneralAccountRate"
+        ,"LoanRate"
+        ,"NewLoan"
+        ,"Payment"
+        ,"PaymentMode"
+        ,"SeparateAccountRate"
+        ,"SpecifiedAmount"
+        ,"Withdrawal"
+        };
+    return std::end(neutral) != std::find
+        (std::begin(neutral)
+        ,std::end(neutral)
+        ,input_field
+        );
+}
+
 //============================================================================
 // Designed for GPT server, but available for general use.
 BasicValues::BasicValues
@@ -273,7 +331,11 @@ void BasicValues::Init()
 
     // Mortality and interest rates require database and rounding.
     // Interest rates require tiered data and 7702 spread.
-    MortalityRates_ = std::make_unique<MortalityRates>(*this);
+    // They may have been shared with a prototype instead.
+    if(!MortalityRates_)
+        {
+        MortalityRates_ = std::make_unique<MortalityRates>(*this);
+        }
     InterestRates_  = std::make_unique<InterestRates >(*this);
     DeathBfts_      = std::make_unique<death_benefits>
         (GetLength()
@@ -295,7 +357,10 @@ void BasicValues::Init()
         ,database()
         ,*StratifiedCharges_
         );
-    Loads_          = std::make_unique<Loads>(*this);
+    if(!Loads_)
+        {
+        Loads_      = std::make_unique<Loads>(*this);
+        }
 
     SetMaxSurvivalDur();
     set_partial_mortality();
@@ -418,7 +483,7 @@ void BasicValues::Init7702()
     double max_coi_rate = database().query<double>(DB_MaxMonthlyCoiRate);
     LMI_ASSERT(0.0 != max_coi_rate);
     max_coi_rate = 1.0 / max_coi_rate;
-    assign(Mly7702qc, apply_binary(coi_rate_from_q<double>(), Mly7702qc, max_coi_rate));
+    Mly7702qc = coi_rate_from_q<double>()(Mly7702qc, max_coi_rate);
 
     // DCV follows the usual monthiversary mechanics, which involve
     // (optionally) rounding monthly COI rates.
@@ -512,6 +577,26 @@ void BasicValues::Init7702()
         );
 }
 
+/// Give this copy its own instances of every subobject that changes
+/// while values are projected, so that it can be projected on one
+/// thread while the original is projected on another.
+///
+/// Rates, loads, and other members that never change after Init()
+/// remain shared. So do the rate vectors to which Irc7702 and
+/// Irc7702A hold references: the original must therefore outlive
+/// the copy.
+
+void BasicValues::unshare_projection_state()
+{
+    gpt7702_       = std::make_shared<gpt7702       >(*gpt7702_      );
+    InterestRates_ = std::make_shared<InterestRates >(*InterestRates_);
+    DeathBfts_     = std::make_shared<death_benefits>(*DeathBfts_    );
+    Outlay_        = std::make_shared<modal_outlay  >(*Outlay_       );
+    PremiumTax_    = std::make_shared<premium_tax   >(*PremiumTax_   );
+    Irc7702_       = std::make_shared<Irc7702       >(*Irc7702_      );
+    Irc7702A_      = std::make_shared<Irc7702A      >(*Irc7702A_     );
+}
+
 //============================================================================
 void BasicValues::Init7702A()
 {
@@ -1621,7 +1706,7 @@ std::vector<double> const& BasicValues::GetBandedCoiRates
 /// An argument could be made for applying them to term rider rates as
 /// well.
 
-std::vector<double> BasicValues::GetActuarialTable
+actuarial_table_view BasicValues::GetActuarialTable
     (std::string const& TableFile
     ,e_database_key     TableID
     ,int                TableNumber
@@ -1629,7 +1714,7 @@ std::vector<double> BasicValues::GetActuarialTable
 {
     if(DB_CurrCoiTable == TableID && e_reenter_never != CoiInforceReentry)
         {
-        return actuarial_table_rates_elaborated
+        return actuarial_table_view(actuarial_table_rates_elaborated
             (TableFile
             ,TableNumber
             ,GetIssueAge()
@@ -1637,11 +1722,11 @@ std::vector<double> BasicValues::GetActuarialTable
             ,CoiInforceReentry
             ,yare_input_.InforceYear
             ,duration_ceiling(yare_input_.EffectiveDate, yare_input_.LastCoiReentryDate)
-            );
+            ));
         }
     else
         {
-        return actuarial_table_rates
+        return actuarial_table_rates_view
             (TableFile
             ,TableNumber
             ,GetIssueAge()
@@ -1651,7 +1736,7 @@ std::vector<double> BasicValues::GetActuarialTable
 }
 
 //============================================================================
-std::vector<double> BasicValues::GetUnblendedTable
+actuarial_table_view BasicValues::GetUnblendedTable
     (std::string const& TableFile
     ,e_database_key     TableID
     ) const
@@ -1664,7 +1749,7 @@ std::vector<double> BasicValues::GetUnblendedTable
 }
 
 //============================================================================
-std::vector<double> BasicValues::GetUnblendedTable
+actuarial_table_view BasicValues::GetUnblendedTable
     (std::string const& TableFile
     ,e_database_key     TableID
     ,mcenum_gender      gender
@@ -1680,8 +1765,24 @@ std::vector<double> BasicValues::GetUnblendedTable
 }
 
 //============================================================================
-// TODO ?? Better to pass vector as arg rather than return it ?
+std::vector<double> BasicValues::GetTable
+    (std::string const& TableFile
+    ,e_database_key     TableID
+    ,bool               IsTableValid
+    ,EBlend             CanBlendSmoking
+    ,EBlend             CanBlendGender
+    ) const
+{
+    std::vector<double> z;
+    GetTable(z, TableFile, TableID, IsTableValid, CanBlendSmoking, CanBlendGender);
+    return z;
+}
 
+// Write a table into a caller-provided vector, whose storage is
+// reused if it has enough capacity. Unblended rates are copied from
+// views of cached tables, and blends are computed from such views,
+// so no temporary vector is created.
+//
 // This function automatically performs blending by gender and smoking if
 // called for. The CanBlend argument tells whether blending is to be
 // suppressed for a particular table; its default is to suppress blending.
@@ -1699,17 +1800,19 @@ std::vector<double> BasicValues::GetUnblendedTable
 // unismoke       2      2      4
 //
 // The order of blending in the unisex unismoke case makes no difference.
-std::vector<double> BasicValues::GetTable
-    (std::string const& TableFile
-    ,e_database_key     TableID
-    ,bool               IsTableValid
-    ,EBlend             CanBlendSmoking
-    ,EBlend             CanBlendGender
+void BasicValues::GetTable
+    (std::vector<double>& z
+    ,std::string const&   TableFile
+    ,e_database_key       TableID
+    ,bool                 IsTableValid
+    ,EBlend               CanBlendSmoking
+    ,EBlend               CanBlendGender
     ) const
 {
     if(!IsTableValid)
         {
-        return std::vector<double>(GetLength());
+        z.assign(GetLength(), 0.0);
+        return;
         }
 
     std::string const file_name = AddDataDir(TableFile);
@@ -1772,11 +1875,13 @@ std::vector<double> BasicValues::GetTable
 */
         )
         {
-        return GetUnblendedTable(file_name, TableID);
+        actuarial_table_view const t = GetUnblendedTable(file_name, TableID);
+        z.assign(t.values().begin(), t.values().end());
+        return;
         }
 
     // Any other case needs this
-    std::vector<double> BlendedTable;
+    z.resize(GetLength());
 
     // Case 2: blend by smoking only
     // no else because above if returned
@@ -1786,23 +1891,25 @@ std::vector<double> BasicValues::GetTable
         &&  !BlendGender
         )
         {
-        std::vector<double> S = GetUnblendedTable
+        actuarial_table_view const S_table = GetUnblendedTable
             (file_name
             ,TableID
             ,yare_input_.Gender
             ,mce_smoker
             );
-        std::vector<double> N = GetUnblendedTable
+        actuarial_table_view const N_table = GetUnblendedTable
             (file_name
             ,TableID
             ,yare_input_.Gender
             ,mce_nonsmoker
             );
+        std::span<double const> const S = S_table.values();
+        std::span<double const> const N = N_table.values();
         double n = yare_input_.NonsmokerProportion;
         double s = 1.0 - n;
         for(int j = 0; j < GetLength(); ++j)
             {
-            BlendedTable.push_back(s * S[j] + n * N[j]);
+            z[j] = s * S[j] + n * N[j];
             }
         }
 
@@ -1813,18 +1920,20 @@ std::vector<double> BasicValues::GetTable
         &&  BlendGender
         )
         {
-        std::vector<double> F = GetUnblendedTable
+        actuarial_table_view const F_table = GetUnblendedTable
             (file_name
             ,TableID
             ,mce_female
             ,yare_input_.Smoking
             );
-        std::vector<double> M = GetUnblendedTable
+        actuarial_table_view const M_table = GetUnblendedTable
             (file_name
             ,TableID
             ,mce_male
             ,yare_input_.Smoking
             );
+        std::span<double const> const F = F_table.values();
+        std::span<double const> const M = M_table.values();
         double m = yare_input_.MaleProportion;
         double f = 1.0 - m;
 
@@ -1840,7 +1949,7 @@ std::vector<double> BasicValues::GetTable
             f_tpx *= (1 - F[j]);
             m_tpx *= (1 - M[j]);
             tpx = (f * f_tpx + m * m_tpx);
-            BlendedTable.push_back(1.0 - tpx / tpx_prev);
+            z[j] = 1.0 - tpx / tpx_prev;
             tpx_prev = tpx;
             }
 */
@@ -1848,7 +1957,7 @@ std::vector<double> BasicValues::GetTable
 ///*
         for(int j = 0; j < GetLength(); ++j)
             {
-            BlendedTable.push_back(f * F[j] + m * M[j]);
+            z[j] = f * F[j] + m * M[j];
             }
 //*/
         }
@@ -1860,40 +1969,44 @@ std::vector<double> BasicValues::GetTable
         &&  BlendGender
         )
         {
-        std::vector<double> FS = GetUnblendedTable
+        actuarial_table_view const FS_table = GetUnblendedTable
             (file_name
             ,TableID
             ,mce_female
             ,mce_smoker
             );
-        std::vector<double> FN = GetUnblendedTable
+        actuarial_table_view const FN_table = GetUnblendedTable
             (file_name
             ,TableID
             ,mce_female
             ,mce_nonsmoker
             );
-        std::vector<double> MS = GetUnblendedTable
+        actuarial_table_view const MS_table = GetUnblendedTable
             (file_name
             ,TableID
             ,mce_male
             ,mce_smoker
             );
-        std::vector<double> MN = GetUnblendedTable
+        actuarial_table_view const MN_table = GetUnblendedTable
             (file_name
             ,TableID
             ,mce_male
             ,mce_nonsmoker
             );
+        std::span<double const> const FS = FS_table.values();
+        std::span<double const> const FN = FN_table.values();
+        std::span<double const> const MS = MS_table.values();
+        std::span<double const> const MN = MN_table.values();
         double n = yare_input_.NonsmokerProportion;
         double s = 1.0 - n;
         double m = yare_input_.MaleProportion;
         double f = 1.0 - m;
         for(int j = 0; j < GetLength(); ++j)
             {
-            BlendedTable.push_back
-                (   f * (s * FS[j] + n * FN[j])
+            z[j] =
+                    f * (s * FS[j] + n * FN[j])
                 +   m * (s * MS[j] + n * MN[j])
-                );
+                ;
 /* Equivalently we could do this:
                 (   s * (f * FS[j] + m * MS[j])
                 +   n * (f * FN[j] + m * MN[j])
@@ -1905,8 +2018,6 @@ std::vector<double> BasicValues::GetTable
         {
         alarum() << "Invalid mortality blending." << LMI_FLUSH;
         }
-
-    return BlendedTable;
 }
 
 //============================================================================
@@ -2044,12 +2155,13 @@ std::vector<double> BasicValues::GetCurrentSpouseRiderRates() const
         return std::vector<double>(GetLength());
         }
 
-    std::vector<double> z = actuarial_table_rates
+    actuarial_table_view const t = actuarial_table_rates_view
         (AddDataDir(product().datum("CurrSpouseRiderFilename"))
         ,database().query<int>(DB_SpouseRiderTable)
         ,yare_input_.SpouseIssueAge
         ,EndtAge - yare_input_.SpouseIssueAge
         );
+    std::vector<double> z(t.values().begin(), t.values().end());
     z.resize(Length);
     return z;
 }
@@ -2061,12 +2173,13 @@ std::vector<double> BasicValues::GetGuaranteedSpouseRiderRates() const
         return std::vector<double>(GetLength());
         }
 
-    std::vector<double> z = actuarial_table_rates
+    actuarial_table_view const t = actuarial_table_rates_view
         (AddDataDir(product().datum("GuarSpouseRiderFilename"))
         ,database().query<int>(DB_SpouseRiderGuarTable)
         ,yare_input_.SpouseIssueAge
         ,EndtAge - yare_input_.SpouseIssueAge
         );
+    std::vector<double> z(t.values().begin(), t.values().end());
     z.resize(Length);
     return z;
 }
@@ -109,18 +109,26 @@ void MortalityRates::SetCoiRates
     ,bool                       table_is_annual
     )
 {
+    std::vector<double> z(Length_);
     for(int j = 0; j < Length_; ++j)
         {
-        double z = coi_rates[j] * coi_multiplier[j];
-        if(table_is_annual)
-            {
-            z = coi_rate_from_q<double>()(z, maximum[j]);
-            }
-        else
+        z[j] = coi_rates[j] * coi_multiplier[j];
+        }
+    if(table_is_annual)
+        {
+        std::vector<double> const m(maximum.begin(), maximum.begin() + Length_);
+        z = coi_rate_from_q<double>()(z, m);
+        }
+    else
+        {
+        for(int j = 0; j < Length_; ++j)
             {
-            z = std::min                 (z, maximum[j]);
+            z[j] = std::min(z[j], maximum[j]);
             }
-        coi_rates[j] = round_coi_rate_(z);
+        }
+    for(int j = 0; j < Length_; ++j)
+        {
+        coi_rates[j] = round_coi_rate_(z[j]);
         }
 }
 
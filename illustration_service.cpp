@@ -0,0 +1,186 @@
+// Run illustrations on request, for a long-running server.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "illustration_service.hpp"
+
+#include "alert.hpp"
+#include "batch_scheduler.hpp"          // input_file_runner(), run_input_file()
+#include "mc_enum_types_aux.hpp"        // mc_emission_from_string()
+#include "path.hpp"
+#include "ssize_lmi.hpp"
+#include "timer.hpp"
+#include "value_cast.hpp"
+
+#include <algorithm>                    // sort()
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined LMI_POSIX
+#   include <stdlib.h>                  // mkdtemp()
+#endif // defined LMI_POSIX
+
+namespace
+{
+std::vector<std::string> split(std::string const& s, char delimiter)
+{
+    std::vector<std::string> z;
+    std::istringstream iss(s);
+    std::string token;
+    while(std::getline(iss, token, delimiter))
+        {
+        z.push_back(token);
+        }
+    return z;
+}
+
+mcenum_emission emission_from_string(std::string const& s)
+{
+    mcenum_emission z = mce_emit_quietly;
+    for(auto const& token : split(s, ','))
+        {
+        if(token.empty())
+            {
+            continue;
+            }
+        mcenum_emission e = mce_emit_nothing;
+        try
+            {
+            e = mc_emission_from_string(token);
+            }
+        catch(std::runtime_error const&)
+            {
+            alarum() << "Unrecognized emission '" << token << "'." << LMI_FLUSH;
+            }
+        if(mce_emit_text_stream == e || mce_emit_timings == e)
+            {
+            alarum()
+                << "Emission '"
+                << token
+                << "' writes to standard output, which a server cannot return."
+                << LMI_FLUSH
+                ;
+            }
+        if(mce_emit_to_pwd == e)
+            {
+            alarum()
+                << "Emission '"
+                << token
+                << "' writes to the server's working directory,"
+                << " which a client cannot find."
+                << LMI_FLUSH
+                ;
+            }
+        z = mcenum_emission(z | e);
+        }
+    return z;
+}
+
+/// Create a new directory, accessible only to this user, to hold the
+/// output of one request.
+
+fs::path private_directory()
+{
+#if defined LMI_POSIX
+    std::string z = (fs::temp_directory_path() / "lmi_service_XXXXXX").string();
+    if(nullptr == ::mkdtemp(z.data()))
+        {
+        alarum() << "Cannot create a directory for output." << LMI_FLUSH;
+        }
+    return z;
+#else  // !defined LMI_POSIX
+    alarum() << "A service is not supported on this platform." << LMI_FLUSH;
+    throw "Unreachable--silences a compiler diagnostic.";
+#endif // !defined LMI_POSIX
+}
+
+} // Unnamed namespace.
+
+std::string illustration_service::operator()(std::string const& request) const
+{
+    Timer timer;
+    std::vector<std::string> const fields = split(request, '\t');
+    if(3 != lmi::ssize(fields) || "run" != fields[0])
+        {
+        alarum()
+            << "Request '"
+            << request
+            << "' is not of the form 'run<TAB>emission<TAB>path'."
+            << LMI_FLUSH
+            ;
+        }
+
+    mcenum_emission const emission = emission_from_string(fields[1]);
+    fs::path const file_path(fields[2]);
+    if(!file_path.is_absolute())
+        {
+        alarum() << "Path '" << fields[2] << "' is not absolute." << LMI_FLUSH;
+        }
+
+    if(e_unrecognized_input == input_file_runner(file_path))
+        {
+        alarum() << "'" << fields[2] << "': unrecognized file extension." << LMI_FLUSH;
+        }
+
+    // Run a copy of the input file in a directory of its own, so that
+    // everything it emits can be found there and named in the
+    // response, even if other requests run the same file at once.
+    fs::path const directory = private_directory();
+    try
+        {
+        fs::path const input = directory / file_path.filename();
+        fs::copy_file(file_path, input);
+        input_file_run const r = run_input_file(input, emission);
+        fs::remove(input);
+
+        std::string z =
+              "ok"
+            + std::string("\t") + value_cast<std::string>(timer.stop().elapsed_seconds())
+            + std::string("\t") + value_cast<std::string>(r.seconds_for_input       )
+            + std::string("\t") + value_cast<std::string>(r.seconds_for_calculations)
+            + std::string("\t") + value_cast<std::string>(r.seconds_for_output      )
+            ;
+
+        std::vector<std::string> outputs;
+        for(auto const& i : fs::directory_iterator(directory))
+            {
+            outputs.push_back(i.path().string());
+            }
+        std::sort(outputs.begin(), outputs.end());
+        for(auto const& i : outputs)
+            {
+            z += "\t" + i;
+            }
+        if(outputs.empty())
+            {
+            fs::remove(directory);
+            }
+        return z;
+        }
+    catch(...)
+        {
+        fs::remove_all(directory);
+        throw;
+        }
+}
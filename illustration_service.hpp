@@ -0,0 +1,64 @@
+// Run illustrations on request, for a long-running server.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef illustration_service_hpp
+#define illustration_service_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <string>
+
+/// Handle one request to run an input file, as 'lmi_cli --file' would.
+///
+/// A request is three tab-delimited fields:
+///   run<TAB>emission<TAB>path
+/// where 'emission' is a comma-separated list of '--emit' suboptions
+/// and 'path' is an absolute path to a '.cns', '.cni', '.ill', '.ini',
+/// '.inix', '.mec', or '.gpt' file. ('lmi_cli --request' makes any
+/// path absolute before sending it.)
+///
+/// The file is copied into a new directory that only the server's
+/// user can read, and run there, so that its output is kept apart
+/// from that of any other request. The response is tab-delimited. On
+/// success, it's
+///   ok<TAB>seconds<TAB>input<TAB>calculations<TAB>output[<TAB>file]...
+/// where the first number is the time taken by the whole request and
+/// the others are the times that 'emit_timings' would show; thus, the
+/// client need not measure time itself. Each 'file' is the absolute
+/// path of a file emitted--e.g., a PDF illustration--which the client
+/// is responsible for removing, along with its directory, when it is
+/// no longer wanted. If nothing is emitted, the directory is removed.
+/// On failure, the response is
+///   error<TAB>message
+///
+/// Because requests may be served concurrently, 'emit_quietly' is
+/// always implied, and emissions that write to standard output or
+/// to the working directory are rejected.
+
+class LMI_SO illustration_service final
+{
+  public:
+    std::string operator()(std::string const& request) const;
+};
+
+#endif // illustration_service_hpp
@@ -35,6 +35,7 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "background_calculation.hpp"
 #include "configurable_settings.hpp"
 #include "custom_io_0.hpp"
 #include "custom_io_1.hpp"
@@ -301,7 +302,13 @@ void IllustrationView::Run(Input* overriding_input)
         }
 
     illustrator z(mce_emit_nothing);
-    z(base_filename(), input_data());
+    fs::path const file(base_filename());
+    Input const& input = input_data();
+    if(!calculate_in_background("Calculating", [&] {z(file, input);}))
+        {
+        status() << "Cancelled." << std::flush;
+        return;
+        }
     ledger_values_ = z.principal_ledger();
 
     status() << "Calculate: " << timer.stop().elapsed_msec_str();
@@ -31,7 +31,9 @@
 #include "emit_ledger.hpp"
 #include "group_values.hpp"
 #include "handle_exceptions.hpp"        // report_exception()
+#include "indexed_census.hpp"
 #include "input.hpp"
+#include "memory_usage.hpp"
 #include "ledgervalues.hpp"
 #include "multiple_cell_document.hpp"
 #include "path.hpp"
@@ -44,10 +46,16 @@
 #include <string>
 
 illustrator::illustrator(mcenum_emission emission)
-    :emission_                 {emission}
-    ,seconds_for_input_        {0.0}
-    ,seconds_for_calculations_ {0.0}
-    ,seconds_for_output_       {0.0}
+    :emission_                     {emission}
+    ,seconds_for_input_            {0.0}
+    ,seconds_for_calculations_     {0.0}
+    ,seconds_for_output_           {0.0}
+    ,allocations_for_input_        {0}
+    ,allocations_for_calculations_ {0}
+    ,allocations_for_output_       {0}
+    ,bytes_per_input_              {0.0}
+    ,bytes_per_account_value_      {0.0}
+    ,bytes_per_ledger_             {0.0}
 {
 }
 
@@ -56,48 +64,79 @@ bool illustrator::operator()(fs::path const& file_path)
     std::string const extension = file_path.extension().string();
     if(".cns" == extension)
         {
+        heap_usage const usage = this_thread_heap_usage();
         Timer timer;
         multiple_cell_document doc(file_path.string());
         test_census_consensus(emission_, doc.case_parms()[0], doc.cell_parms());
         seconds_for_input_ = timer.stop().elapsed_seconds();
+        allocations_for_input_ = allocations_since(usage);
         return operator()(file_path, doc.cell_parms());
         }
+    else if(is_indexed_census(file_path))
+        {
+        heap_usage const usage = this_thread_heap_usage();
+        Timer timer;
+        indexed_census const census(file_path);
+        std::vector<Input> const cells = census.cell_parms();
+        test_census_consensus(emission_, census.case_default(), cells);
+        seconds_for_input_ = timer.stop().elapsed_seconds();
+        allocations_for_input_ = allocations_since(usage);
+        return operator()(file_path, cells);
+        }
     else if(".ill" == extension)
         {
+        heap_usage const usage = this_thread_heap_usage();
         Timer timer;
         single_cell_document doc(file_path.string());
         seconds_for_input_ = timer.stop().elapsed_seconds();
+        allocations_for_input_ = allocations_since(usage);
         return operator()(file_path, doc.input_data());
         }
     else if(".ini" == extension)
         {
+        heap_usage usage = this_thread_heap_usage();
         Timer timer;
         Input input;
         bool close_when_done = custom_io_0_read(input, file_path.string());
         seconds_for_input_ = timer.stop().elapsed_seconds();
+        allocations_for_input_ = allocations_since(usage);
+        usage = this_thread_heap_usage();
         timer.restart();
+        hardware_counters counters(mce_emit_timings & emission_);
         IllusVal z(file_path.string());
         z.run(input);
         principal_ledger_ = z.ledger();
         seconds_for_calculations_ = timer.stop().elapsed_seconds();
+        calculation_counts_ = counters.stop().str();
+        allocations_for_calculations_ = allocations_since(usage);
+        usage = this_thread_heap_usage();
         seconds_for_output_ = emit_ledger(file_path, *z.ledger(), emission_);
+        allocations_for_output_ = allocations_since(usage);
         conditionally_show_timings_on_stdout();
         return close_when_done;
         }
     else if(".inix" == extension)
         {
+        heap_usage usage = this_thread_heap_usage();
         Timer timer;
         Input input;
         bool emit_pdf_too = custom_io_1_read(input, file_path.string());
         seconds_for_input_ = timer.stop().elapsed_seconds();
+        allocations_for_input_ = allocations_since(usage);
+        usage = this_thread_heap_usage();
         timer.restart();
+        hardware_counters counters(mce_emit_timings & emission_);
         IllusVal z(file_path.string());
         z.run(input);
         principal_ledger_ = z.ledger();
         seconds_for_calculations_ = timer.stop().elapsed_seconds();
+        calculation_counts_ = counters.stop().str();
+        allocations_for_calculations_ = allocations_since(usage);
         mcenum_emission x = emit_pdf_too ? mce_emit_pdf_file : mce_emit_nothing;
         mcenum_emission y = static_cast<mcenum_emission>(x | emission_);
+        usage = this_thread_heap_usage();
         seconds_for_output_ = emit_ledger(file_path, *z.ledger(), y);
+        allocations_for_output_ = allocations_since(usage);
         conditionally_show_timings_on_stdout();
         return true;
         }
@@ -117,12 +156,18 @@ bool illustrator::operator()(fs::path const& file_path)
 
 bool illustrator::operator()(fs::path const& file_path, Input const& z)
 {
+    heap_usage usage = this_thread_heap_usage();
     Timer timer;
+    hardware_counters counters(mce_emit_timings & emission_);
     IllusVal IV(file_path.string());
     IV.run(z);
     principal_ledger_ = IV.ledger();
     seconds_for_calculations_ = timer.stop().elapsed_seconds();
+    calculation_counts_ = counters.stop().str();
+    allocations_for_calculations_ = allocations_since(usage);
+    usage = this_thread_heap_usage();
     seconds_for_output_ = emit_ledger(file_path, *IV.ledger(), emission_);
+    allocations_for_output_ = allocations_since(usage);
     conditionally_show_timings_on_stdout();
     return true;
 }
@@ -135,6 +180,14 @@ bool illustrator::operator()(fs::path const& file_path, std::vector<Input> const
     principal_ledger_ = runner.composite();
     seconds_for_calculations_ = result.seconds_for_calculations_;
     seconds_for_output_       = result.seconds_for_output_      ;
+    allocations_for_calculations_ = result.allocations_for_calculations_;
+    allocations_for_output_       = result.allocations_for_output_      ;
+    bytes_per_input_              = result.bytes_per_input_             ;
+    bytes_per_account_value_      = result.bytes_per_account_value_     ;
+    bytes_per_ledger_             = result.bytes_per_ledger_            ;
+    // Output is interleaved with calculations in a census run, so
+    // calculations cannot be counted separately.
+    calculation_counts_.clear();
     conditionally_show_timings_on_stdout();
     return result.completed_normally_;
 }
@@ -152,6 +205,36 @@ void illustrator::conditionally_show_timings_on_stdout() const
             << Timer::elapsed_msec_str(seconds_for_output_)
             << '\n'
             ;
+        if(!calculation_counts_.empty())
+            {
+            std::cout << "    Counters:     " << calculation_counts_ << '\n';
+            }
+        if(heap_usage_is_counted())
+            {
+            std::cout
+                << "    Allocations:  "
+                << allocations_for_input_ << " input, "
+                << allocations_for_calculations_ << " calculations, "
+                << allocations_for_output_ << " output\n"
+                ;
+            }
+        if(heap_usage_is_counted() && 0.0 != bytes_per_account_value_)
+            {
+            std::cout
+                << "    Per cell:     "
+                << memory_str(bytes_per_input_) << " input, "
+                << memory_str(bytes_per_account_value_) << " account values, "
+                << memory_str(bytes_per_ledger_) << " ledger\n"
+                ;
+            }
+        if(0 != peak_resident_bytes())
+            {
+            std::cout
+                << "    Peak memory:  "
+                << memory_str(static_cast<double>(peak_resident_bytes()))
+                << " resident\n"
+                ;
+            }
         }
 }
 
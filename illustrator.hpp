@@ -28,7 +28,9 @@
 #include "path.hpp"
 #include "so_attributes.hpp"
 
+#include <cstdint>
 #include <memory>                       // shared_ptr
+#include <string>
 #include <vector>
 
 class Input;
@@ -62,6 +64,13 @@ class LMI_SO illustrator final
     double seconds_for_input_;
     double seconds_for_calculations_;
     double seconds_for_output_;
+    std::string calculation_counts_;
+    std::uint64_t allocations_for_input_;
+    std::uint64_t allocations_for_calculations_;
+    std::uint64_t allocations_for_output_;
+    double bytes_per_input_;
+    double bytes_per_account_value_;
+    double bytes_per_ledger_;
 };
 
 LMI_SO Input const& default_cell();
@@ -0,0 +1,491 @@
+// Census stored for random access to its cells.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "indexed_census.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "bourn_cast.hpp"
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary(), stifle_unused_warning()
+#include "multiple_cell_document.hpp"
+#include "ssize_lmi.hpp"
+#include "xml_lmi.hpp"
+
+#include <xmlwrapp/nodes_view.h>
+
+#include <algorithm>                    // equal()
+#include <cstddef>                      // size_t
+#include <fstream>
+#include <ios>                          // ios_base, streamoff
+
+#if defined LMI_POSIX
+#   include <fcntl.h>                   // open(), O_RDONLY
+#   include <sys/mman.h>                // mmap(), munmap()
+#   include <unistd.h>                  // close(), fsync()
+#endif // defined LMI_POSIX
+
+namespace
+{
+char const          magic[8]       = {'l', 'm', 'i', '.', 'c', 'n', 'i', '\n'};
+std::uint32_t const format_version = 1;
+std::uint64_t const header_length  = 24;
+std::uint64_t const offset_of_index_offset = 16;
+
+std::string const& record_root_name()
+{
+    static std::string const s("indexed_census_record");
+    return s;
+}
+
+void put_integer(std::string& s, std::uint64_t n, int bytes)
+{
+    for(int j = 0; j < bytes; ++j)
+        {
+        s += static_cast<char>((n >> (8 * j)) & 0xff);
+        }
+}
+
+std::uint64_t get_integer(char const* p, int bytes)
+{
+    std::uint64_t z = 0;
+    for(int j = bytes - 1; 0 <= j; --j)
+        {
+        z = (z << 8) | static_cast<unsigned char>(p[j]);
+        }
+    return z;
+}
+
+std::string serialize(Input const& z)
+{
+    xml_lmi::xml_document document(record_root_name());
+    z.write(document.root_node());
+    return document.str();
+}
+
+std::string header_bytes(std::uint64_t index_offset)
+{
+    std::string z(magic, sizeof magic);
+    put_integer(z, format_version, 4);
+    put_integer(z, 0, 4);
+    put_integer(z, index_offset, 8);
+    LMI_ASSERT(header_length == z.size());
+    return z;
+}
+
+/// Make sure what has been written to a file or directory reaches
+/// the disk before anything that depends on it is written.
+///
+/// Only POSIX is supported; elsewhere, this does nothing.
+
+void sync_to_disk(fs::path const& p)
+{
+#if defined LMI_POSIX
+    int const fd = ::open(p.string().c_str(), O_RDONLY);
+    if(fd < 0 || 0 != ::fsync(fd))
+        {
+        if(0 <= fd)
+            {
+            ::close(fd);
+            }
+        alarum() << "Unable to synchronize '" << p << "'." << LMI_FLUSH;
+        }
+    ::close(fd);
+#else  // !defined LMI_POSIX
+    stifle_unused_warning(p);
+#endif // !defined LMI_POSIX
+}
+} // Unnamed namespace.
+
+/// Read-only view of the whole file, mapped into memory where that
+/// is possible, and otherwise read on demand.
+
+class indexed_census::mapping final
+{
+  public:
+    explicit mapping(fs::path const& filename);
+    ~mapping();
+
+    std::uint64_t size() const {return size_;}
+
+    char const* bytes
+        (std::uint64_t offset
+        ,std::uint64_t length
+        ,std::string&  buffer
+        ) const;
+
+  private:
+    mapping(mapping const&) = delete;
+    mapping& operator=(mapping const&) = delete;
+
+    fs::path const filename_;
+    std::uint64_t  size_    {0};
+    void*          address_ {nullptr};
+};
+
+indexed_census::mapping::mapping(fs::path const& filename)
+    :filename_ {filename}
+{
+    if(!fs::exists(filename))
+        {
+        alarum() << "File '" << filename << "' not found." << LMI_FLUSH;
+        }
+    size_ = fs::file_size(filename);
+#if defined LMI_POSIX
+    int const fd = ::open(filename.string().c_str(), O_RDONLY);
+    if(0 <= fd)
+        {
+        void* const p =
+              0 < size_
+            ? ::mmap(nullptr, bourn_cast<std::size_t>(size_), PROT_READ, MAP_PRIVATE, fd, 0)
+            : MAP_FAILED
+            ;
+        if(MAP_FAILED != p)
+            {
+            address_ = p;
+            }
+        ::close(fd);
+        }
+#endif // defined LMI_POSIX
+}
+
+indexed_census::mapping::~mapping()
+{
+#if defined LMI_POSIX
+    if(address_)
+        {
+        ::munmap(address_, bourn_cast<std::size_t>(size_));
+        }
+#endif // defined LMI_POSIX
+}
+
+/// Return a pointer to 'length' bytes starting at 'offset'. They are
+/// in the mapping if there is one; otherwise, they're read into the
+/// buffer provided.
+
+char const* indexed_census::mapping::bytes
+    (std::uint64_t offset
+    ,std::uint64_t length
+    ,std::string&  buffer
+    ) const
+{
+    if(size_ < offset || size_ - offset < length)
+        {
+        alarum()
+            << "File '"
+            << filename_
+            << "' is truncated or damaged."
+            << LMI_FLUSH
+            ;
+        }
+
+    if(address_)
+        {
+        return static_cast<char const*>(address_) + offset;
+        }
+
+    buffer.resize(bourn_cast<std::size_t>(length));
+    std::ifstream ifs(filename_.string().c_str(), ios_in_binary());
+    ifs.seekg(bourn_cast<std::streamoff>(offset));
+    ifs.read(buffer.data(), bourn_cast<std::streamsize>(length));
+    if(!ifs)
+        {
+        alarum() << "Unable to read file '" << filename_ << "'." << LMI_FLUSH;
+        }
+    return buffer.data();
+}
+
+/// Read only the header and the index.
+
+indexed_census::indexed_census(fs::path const& filename)
+    :filename_ {filename}
+{
+    read_index();
+}
+
+indexed_census::~indexed_census() = default;
+
+int indexed_census::number_of_classes() const
+{
+    return bourn_cast<int>(number_of_classes_);
+}
+
+int indexed_census::number_of_cells() const
+{
+    return lmi::ssize(index_) - 1 - number_of_classes();
+}
+
+Input indexed_census::case_default() const
+{
+    return read_record(index_[0]);
+}
+
+Input indexed_census::class_default(int j) const
+{
+    LMI_ASSERT(0 <= j && j < number_of_classes());
+    return read_record(index_[1 + j]);
+}
+
+Input indexed_census::cell(int j) const
+{
+    LMI_ASSERT(0 <= j && j < number_of_cells());
+    return read_record(index_[1 + number_of_classes() + j]);
+}
+
+/// The case default, as a vector for parallelism with
+/// multiple_cell_document::case_parms().
+
+std::vector<Input> indexed_census::case_parms() const
+{
+    return {case_default()};
+}
+
+std::vector<Input> indexed_census::class_parms() const
+{
+    std::vector<Input> z;
+    z.reserve(number_of_classes_);
+    for(int j = 0; j < number_of_classes(); ++j)
+        {
+        z.push_back(class_default(j));
+        }
+    return z;
+}
+
+std::vector<Input> indexed_census::cell_parms() const
+{
+    std::vector<Input> z;
+    z.reserve(index_.size());
+    for(int j = 0; j < number_of_cells(); ++j)
+        {
+        z.push_back(cell(j));
+        }
+    return z;
+}
+
+void indexed_census::append_cell(Input const& z)
+{
+    write_record_and_index(number_of_cells(), z);
+}
+
+void indexed_census::replace_cell(int j, Input const& z)
+{
+    LMI_ASSERT(0 <= j && j < number_of_cells());
+    write_record_and_index(j, z);
+}
+
+/// Write a new file; parameters are as for multiple_cell_document.
+
+void indexed_census::write
+    (fs::path           const& filename
+    ,std::vector<Input> const& case_parms
+    ,std::vector<Input> const& class_parms
+    ,std::vector<Input> const& cell_parms
+    )
+{
+    LMI_ASSERT(1 == case_parms.size());
+    LMI_ASSERT(!class_parms.empty());
+    LMI_ASSERT(!cell_parms .empty());
+
+    std::string index;
+    put_integer(index, class_parms.size(), 8);
+    put_integer(index, cell_parms .size(), 8);
+
+    // Write a temporary file and rename it, so that an interruption
+    // leaves any existing file intact.
+    fs::path const temporary(filename.string() + ".tmp");
+    {
+    std::ofstream ofs(temporary.string().c_str(), ios_out_trunc_binary());
+    ofs << header_bytes(0);
+    std::uint64_t offset = header_length;
+    for(auto const* v : {&case_parms, &class_parms, &cell_parms})
+        {
+        for(auto const& i : *v)
+            {
+            std::string const record(serialize(i));
+            ofs << record;
+            put_integer(index, offset, 8);
+            put_integer(index, record.size(), 8);
+            offset += record.size();
+            }
+        }
+    ofs << index;
+    ofs.seekp(0);
+    ofs << header_bytes(offset);
+    ofs.close();
+    if(!ofs)
+        {
+        fs::remove(temporary);
+        alarum() << "Unable to write file '" << filename << "'." << LMI_FLUSH;
+        }
+    }
+    sync_to_disk(temporary);
+    fs::rename(temporary, filename);
+    fs::path const directory(filename.parent_path());
+    sync_to_disk(directory.empty() ? fs::path(".") : directory);
+}
+
+void indexed_census::write(fs::path const& filename, multiple_cell_document const& z)
+{
+    write(filename, z.case_parms(), z.class_parms(), z.cell_parms());
+}
+
+void indexed_census::read_index()
+{
+    mapping_ = std::make_unique<mapping>(filename_);
+    std::string buffer;
+
+    char const* p = mapping_->bytes(0, header_length, buffer);
+    if
+        (  !std::equal(magic, magic + sizeof magic, p)
+        || format_version < get_integer(p + sizeof magic, 4)
+        )
+        {
+        alarum()
+            << "File '"
+            << filename_
+            << "' is not an indexed census that this version of lmi can read."
+            << LMI_FLUSH
+            ;
+        }
+    std::uint64_t const index_offset = get_integer(p + offset_of_index_offset, 8);
+
+    // Use the index that the header points to. Anything after it was
+    // left by an update that was interrupted before the header could
+    // be rewritten, and is ignored.
+    std::uint64_t const size = mapping_->size();
+    if(index_offset < header_length || size < index_offset)
+        {
+        alarum() << "File '" << filename_ << "' has a damaged index." << LMI_FLUSH;
+        }
+    p = mapping_->bytes(index_offset, 16, buffer);
+    number_of_classes_ = get_integer(p, 8);
+    std::uint64_t const number_of_cells = get_integer(p + 8, 8);
+    std::uint64_t const room = (size - index_offset - 16) / 16;
+    if
+        (  0 == number_of_classes_
+        || 0 == number_of_cells
+        || room <= number_of_classes_
+        || room - 1 - number_of_classes_ < number_of_cells
+        )
+        {
+        alarum() << "File '" << filename_ << "' has a damaged index." << LMI_FLUSH;
+        }
+    std::uint64_t const entries = 1 + number_of_classes_ + number_of_cells;
+
+    p = mapping_->bytes(index_offset + 16, 16 * entries, buffer);
+    index_.clear();
+    index_.reserve(bourn_cast<std::size_t>(entries));
+    for(std::uint64_t j = 0; j < entries; ++j, p += 16)
+        {
+        record_position const r {get_integer(p, 8), get_integer(p + 8, 8)};
+        if
+            (  r.offset < header_length
+            || index_offset < r.offset
+            || index_offset - r.offset < r.length
+            )
+            {
+            alarum() << "File '" << filename_ << "' has a damaged index." << LMI_FLUSH;
+            }
+        index_.push_back(r);
+        }
+}
+
+Input indexed_census::read_record(record_position const& r) const
+{
+    std::string buffer;
+    char const* p = mapping_->bytes(r.offset, r.length, buffer);
+    xml_lmi::dom_parser parser(p, bourn_cast<std::size_t>(r.length));
+    xml::element const& root(parser.root_node(record_root_name()));
+    xml::const_nodes_view const elements(root.elements());
+    LMI_ASSERT(1 == elements.size());
+    Input z;
+    *elements.begin() >> z;
+    return z;
+}
+
+/// Append a record for the cell with the given index, which replaces
+/// an existing cell or, if it's one past the last, is a new cell; then
+/// append a new index, and only after both are safely on disk, point
+/// the header to it. Until the header is rewritten, the file still
+/// reads as it did before.
+
+void indexed_census::write_record_and_index(int index_of_cell, Input const& z)
+{
+    std::vector<record_position> new_index(index_);
+    std::uint64_t cells = bourn_cast<std::uint64_t>(number_of_cells());
+    std::uint64_t const offset = mapping_->size();
+    std::string const record(serialize(z));
+    record_position const r {offset, record.size()};
+    if(index_of_cell == number_of_cells())
+        {
+        new_index.push_back(r);
+        ++cells;
+        }
+    else
+        {
+        new_index[1 + number_of_classes_ + index_of_cell] = r;
+        }
+
+    std::string bytes(record);
+    put_integer(bytes, number_of_classes_, 8);
+    put_integer(bytes, cells             , 8);
+    for(auto const& i : new_index)
+        {
+        put_integer(bytes, i.offset, 8);
+        put_integer(bytes, i.length, 8);
+        }
+
+    // Release the mapping before the file grows.
+    mapping_.reset();
+    std::ios_base::openmode const mode =
+        std::ios_base::in | std::ios_base::out | std::ios_base::binary;
+    {
+    std::fstream file(filename_.string().c_str(), mode);
+    file.seekp(bourn_cast<std::streamoff>(offset));
+    file << bytes;
+    file.close();
+    if(!file)
+        {
+        alarum() << "Unable to write file '" << filename_ << "'." << LMI_FLUSH;
+        }
+    }
+    sync_to_disk(filename_);
+    {
+    std::string index_offset;
+    put_integer(index_offset, offset + record.size(), 8);
+    std::fstream file(filename_.string().c_str(), mode);
+    file.seekp(bourn_cast<std::streamoff>(offset_of_index_offset));
+    file << index_offset;
+    file.close();
+    if(!file)
+        {
+        alarum() << "Unable to write file '" << filename_ << "'." << LMI_FLUSH;
+        }
+    }
+    sync_to_disk(filename_);
+    read_index();
+}
+
+bool is_indexed_census(fs::path const& filename)
+{
+    return ".cni" == filename.extension().string();
+}
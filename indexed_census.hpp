@@ -0,0 +1,132 @@
+// Census stored for random access to its cells.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef indexed_census_hpp
+#define indexed_census_hpp
+
+#include "config.hpp"
+
+#include "input.hpp"
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <cstdint>
+#include <memory>                       // unique_ptr
+#include <string>
+#include <vector>
+
+class multiple_cell_document;
+
+/// A census stored for random access to its cells.
+///
+/// A '.cns' file must be parsed and reconciled in its entirety before
+/// any cell can be used. This alternative '.cni' format holds the same
+/// case, class, and cell parameters (see multiple_cell_document) as
+/// separate records, with an index of their positions. Opening one
+/// reads only the index; each record is read, directly from a memory
+/// mapping where possible, when it is requested. Thus, running or
+/// examining a few cells of a large census costs only those cells.
+///
+/// Each record is one Input, serialized as xml exactly as in a '.cns'
+/// file, so that conversion in either direction is lossless, and old
+/// versions of input are upgraded in the same way. Records are written
+/// only by lmi, so they're never validated against a schema.
+///
+/// Layout, all integers being unsigned and little-endian:
+///   header (24 bytes):
+///     magic number: the eight characters "lmi.cni\n"
+///     format version: 32 bits
+///     reserved, always zero: 32 bits
+///     offset of the index: 64 bits
+///   records, in any order, without separators
+///   index, wherever the header says it is:
+///     number of classes: 64 bits
+///     number of cells: 64 bits
+///     for the case, then each class, then each cell in order:
+///       offset of its record: 64 bits
+///       length of its record: 64 bits
+///
+/// A cell is appended or replaced by writing its record at the end of
+/// the file, followed by a new index; once both are on disk, the
+/// header's index offset is overwritten. Only the index the header
+/// points to is read, so if an update is interrupted before the header
+/// is rewritten, the bytes it appended are ignored and the file reads
+/// as it did before. Superseded records and indexes become unreachable,
+/// but are retained until the file is written anew.
+///
+/// A file is written anew as a temporary file that then replaces it,
+/// so that an interruption leaves any existing file intact.
+
+class LMI_SO indexed_census final
+{
+  public:
+    explicit indexed_census(fs::path const& filename);
+    ~indexed_census();
+
+    int number_of_classes() const;
+    int number_of_cells  () const;
+
+    Input case_default() const;
+    Input class_default(int) const;
+    Input cell(int) const;
+
+    std::vector<Input> case_parms () const;
+    std::vector<Input> class_parms() const;
+    std::vector<Input> cell_parms () const;
+
+    void append_cell(Input const&);
+    void replace_cell(int, Input const&);
+
+    static void write
+        (fs::path           const& filename
+        ,std::vector<Input> const& case_parms
+        ,std::vector<Input> const& class_parms
+        ,std::vector<Input> const& cell_parms
+        );
+    static void write(fs::path const&, multiple_cell_document const&);
+
+  private:
+    indexed_census(indexed_census const&) = delete;
+    indexed_census& operator=(indexed_census const&) = delete;
+
+    struct record_position
+        {
+        std::uint64_t offset;
+        std::uint64_t length;
+        };
+
+    class mapping;
+
+    void read_index();
+    Input read_record(record_position const&) const;
+    void write_record_and_index(int index_of_cell, Input const&);
+
+    fs::path const                filename_;
+    std::unique_ptr<mapping>      mapping_;
+    std::uint64_t                 number_of_classes_ {0};
+    std::vector<record_position>  index_;
+};
+
+/// Whether a file is an indexed census, as its '.cni' extension says.
+
+LMI_SO bool is_indexed_census(fs::path const&);
+
+#endif // indexed_census_hpp
@@ -144,6 +144,8 @@ class LMI_SO Input final
 
     static Input consummate(Input const&);
 
+    bool append_xml_text(std::string&, int depth) const;
+
     void validate_external_data();
 
   private:
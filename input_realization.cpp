@@ -163,17 +163,15 @@ std::string realize_sequence_string
 std::map<std::string,std::string> const
 Input::permissible_specified_amount_strategy_keywords()
 {
-    static std::map<std::string,std::string> all_keywords;
-    if(all_keywords.empty())
-        {
-        all_keywords["maximum" ] = "SAMaximum"       ;
-        all_keywords["target"  ] = "SATarget"        ;
-        all_keywords["sevenpay"] = "SA7PP"           ;
-        all_keywords["glp"     ] = "SAGLP"           ;
-        all_keywords["gsp"     ] = "SAGSP"           ;
-        all_keywords["corridor"] = "SACorridor"      ;
-        all_keywords["salary"  ] = "SASalary"        ;
-        }
+    static std::map<std::string,std::string> const all_keywords
+        {{"maximum" , "SAMaximum"}
+        ,{"target"  , "SATarget"}
+        ,{"sevenpay", "SA7PP"}
+        ,{"glp"     , "SAGLP"}
+        ,{"gsp"     , "SAGSP"}
+        ,{"corridor", "SACorridor"}
+        ,{"salary"  , "SASalary"}
+        };
 //    std::map<std::string,std::string> permissible_keywords = all_keywords;
     std::map<std::string,std::string> permissible_keywords;
     // Don't use initialization--we want this to happen every time [6.7].
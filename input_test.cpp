@@ -24,7 +24,9 @@
 // Facilities offered by all of these headers are tested here.
 // Class product_database might appear not to belong, but it's
 // intimately entwined with input.
+#include "census_import.hpp"
 #include "database.hpp"
+#include "indexed_census.hpp"
 #include "input.hpp"
 #include "multiple_cell_document.hpp"
 #include "single_cell_document.hpp"
@@ -35,8 +37,9 @@
 #include "dbdict.hpp"
 #include "dbnames.hpp"
 #include "global_settings.hpp"
-#include "miscellany.hpp"               // stifle_unused_warning()
+#include "miscellany.hpp"               // ios_out_app_binary(), stifle_unused_warning()
 #include "oecumenic_enumerations.hpp"
+#include "ssize_lmi.hpp"
 #include "test_tools.hpp"
 #include "timer.hpp"
 #include "xml_lmi.hpp"
@@ -47,6 +50,8 @@
 #include <fstream>
 #include <functional>                   // bind()
 #include <ios>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 
 class input_test
@@ -57,6 +62,9 @@ class input_test
         test_product_database();
         test_input_class();
         test_document_classes();
+        test_census_text();
+        test_census_import();
+        test_indexed_census();
         test_obsolete_history();
         assay_speed();
         // Rerun this test after assay_speed() because it removes
@@ -68,6 +76,9 @@ class input_test
     static void test_product_database();
     static void test_input_class();
     static void test_document_classes();
+    static void test_census_text();
+    static void test_census_import();
+    static void test_indexed_census();
     static void test_obsolete_history();
     static void assay_speed();
 
@@ -407,6 +418,147 @@ void input_test::test_document_classes()
     test_document_io<S>("sample.ill", "replica.ill", __FILE__, __LINE__, false);
 }
 
+/// Writing a census directly as text must give exactly the same
+/// result as writing it through a DOM.
+
+void input_test::test_census_text()
+{
+    multiple_cell_document document("sample.cns");
+    Input cell = document.cell_parms_[0];
+    cell["InsuredName"] = "Ren\xC3\xA9" "e <&> \"O'Neill\"";
+    cell["Comments"] = "Line one\r\nline two\ttabbed \xE2\x82\xAC";
+    // More cells than are formatted in a single chunk.
+    document.cell_parms_.resize(200, cell);
+
+    std::ostringstream dom;
+    document.write_dom(dom);
+    std::ostringstream text;
+    LMI_TEST(document.write_text(text));
+    LMI_TEST(dom.str() == text.str());
+    std::ostringstream oss;
+    document.write(oss);
+    LMI_TEST(dom.str() == oss.str());
+
+    // Invalid UTF-8 can't be written as text, so nothing is written,
+    // and write() must use a DOM instead.
+    document.cell_parms_[150]["Comments"] = "Truncated \xC3";
+    std::ostringstream rejected;
+    LMI_TEST(!document.write_text(rejected));
+    LMI_TEST(rejected.str().empty());
+}
+
+/// Import tab-delimited census data. Dates may be given as YYYYMMDD
+/// or as JDN, and every defective line is reported.
+
+void input_test::test_census_import()
+{
+    Input const case_default;
+    std::string const header = "InsuredName\tDateOfBirth\tSpecifiedAmount\n";
+    // JDN 2440588 is 1970-01-01.
+    std::string const lines =
+          "Alice\t19700101\t100000\n"
+          "Bob\t2440588\t200000\n"
+        ;
+
+    census_import_result const z = import_census(header + lines, case_default);
+    LMI_TEST_EQUAL(2, lmi::ssize(z.cells));
+    LMI_TEST_EQUAL("Yes", z.archetype["UseDOB"].str());
+    LMI_TEST_EQUAL("Alice", z.cells[0]["InsuredName"].str());
+    LMI_TEST_EQUAL("Bob"  , z.cells[1]["InsuredName"].str());
+    LMI_TEST_EQUAL(z.cells[0]["DateOfBirth"].str(), z.cells[1]["DateOfBirth"].str());
+
+    // Every defective line is reported, not just the first.
+    LMI_TEST_THROW
+        (import_census
+            (header + lines + "Carol\t19700101\n" + "Dave\t99999999\t300000\n"
+            ,case_default
+            )
+        ,std::runtime_error
+        ,lmi_test::what_regex
+            ("^2 of 4 lines could not be imported:\n"
+             "Line #3: .*one value per column.*\n"
+             "Line #4: Invalid date 99999999 for 'DateOfBirth'\\."
+            )
+        );
+
+    LMI_TEST_THROW
+        (import_census("DateOfBirth\tIssueAge\n", case_default)
+        ,std::runtime_error
+        ,"Cannot paste both 'DateOfBirth' and 'IssueAge'."
+        );
+
+    // Without a header line, or any line after it, there is nothing
+    // to import. That merits only a warning.
+    LMI_TEST(import_census(""    , case_default).cells.empty());
+    LMI_TEST(import_census(header, case_default).cells.empty());
+}
+
+/// Convert a census to the indexed format and back: the result must
+/// be identical to the original. Then append and replace cells.
+
+void input_test::test_indexed_census()
+{
+    multiple_cell_document const original("sample.cns");
+    indexed_census::write("replica.cni", original);
+
+    multiple_cell_document replica;
+    {
+    indexed_census const census("replica.cni");
+    LMI_TEST_EQUAL(lmi::ssize(original.class_parms_), census.number_of_classes());
+    LMI_TEST_EQUAL(lmi::ssize(original.cell_parms_ ), census.number_of_cells  ());
+    LMI_TEST(original.case_parms_[0] == census.case_default());
+    LMI_TEST(original.cell_parms_.back() == census.cell(census.number_of_cells() - 1));
+    replica.case_parms_  = census.case_parms ();
+    replica.class_parms_ = census.class_parms();
+    replica.cell_parms_  = census.cell_parms ();
+    }
+    std::ostringstream oss0;
+    original.write(oss0);
+    std::ostringstream oss1;
+    replica.write(oss1);
+    LMI_TEST(oss0.str() == oss1.str());
+
+    int const n = lmi::ssize(original.cell_parms_);
+    {
+    indexed_census census("replica.cni");
+    Input cell = census.cell(0);
+    cell["InsuredName"] = "Appended";
+    census.append_cell(cell);
+    LMI_TEST_EQUAL(1 + n, census.number_of_cells());
+    cell["InsuredName"] = "Replaced";
+    census.replace_cell(0, cell);
+    LMI_TEST_EQUAL(1 + n, census.number_of_cells());
+    }
+
+    // Changes persist, and other cells are unaffected.
+    indexed_census const census("replica.cni");
+    LMI_TEST_EQUAL(1 + n, census.number_of_cells());
+    LMI_TEST(std::string("Replaced") == census.cell(0).InsuredName.value());
+    LMI_TEST(std::string("Appended") == census.cell(n).InsuredName.value());
+    LMI_TEST(original.cell_parms_.back() == census.cell(n - 1));
+    LMI_TEST(original.case_parms_[0] == census.case_default());
+
+    LMI_TEST_THROW
+        (census.cell(1 + n)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Assertion.*failed")
+        );
+
+    // Bytes appended by an update that was interrupted before the
+    // header was rewritten are ignored.
+    {
+    std::ofstream ofs("replica.cni", ios_out_app_binary());
+    ofs << "interrupted";
+    }
+    {
+    indexed_census const interrupted("replica.cni");
+    LMI_TEST_EQUAL(1 + n, interrupted.number_of_cells());
+    LMI_TEST(std::string("Appended") == interrupted.cell(n).InsuredName.value());
+    }
+
+    LMI_TEST(0 == std::remove("replica.cni"));
+}
+
 void input_test::test_obsolete_history()
 {
     Input z;
@@ -25,6 +25,7 @@
 #include "xml_serializable.tpp"
 
 #include "alert.hpp"
+#include "bourn_cast.hpp"
 #include "calendar_date.hpp"
 #include "contains.hpp"
 #include "database.hpp"
@@ -32,6 +33,7 @@
 #include "map_lookup.hpp"
 #include "oecumenic_enumerations.hpp"
 #include "value_cast.hpp"
+#include "xml_lmi.hpp"
 
 #include <algorithm>                    // min()
 #include <stdexcept>
@@ -91,6 +93,53 @@ std::string const& Input::xml_root_name() const
     return s;
 }
 
+/// Append xml text for this cell: exactly what write() would yield,
+/// as libxml2 formats an element at the given depth of nesting.
+///
+/// Unlike write(), this builds no DOM, so many cells can be written
+/// quickly, and concurrently. It relies on this class's use of the
+/// default write_element() implementation.
+///
+/// Returns false if libxml2 would write some value differently (see
+/// xml_lmi::append_escaped_content()), in which case write() must be
+/// used instead.
+
+bool Input::append_xml_text(std::string& out, int depth) const
+{
+    std::string const indent(bourn_cast<std::string::size_type>(2 * depth), ' ');
+    out += indent;
+    out += '<';
+    out += xml_root_name();
+    out += " version=\"";
+    out += value_cast<std::string>(class_version());
+    out += "\">\n";
+    for(auto const& i : member_names())
+        {
+        std::string const value = operator[](i).str();
+        out += indent;
+        out += "  <";
+        out += i;
+        if(value.empty())
+            {
+            out += "/>\n";
+            continue;
+            }
+        out += '>';
+        if(!xml_lmi::append_escaped_content(out, value))
+            {
+            return false;
+            }
+        out += "</";
+        out += i;
+        out += ">\n";
+        }
+    out += indent;
+    out += "</";
+    out += xml_root_name();
+    out += ">\n";
+    return true;
+}
+
 /// See this function's general documentation in the base class.
 ///
 /// No xml file written by lmi ever contained 'FilingApprovalState'.
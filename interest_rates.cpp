@@ -29,7 +29,7 @@
 #include "database.hpp"
 #include "dbnames.hpp"
 #include "et_vector.hpp"
-#include "math_functions.hpp"           // assign_midpoint()
+#include "math_functions.hpp"           // assign_midpoint(), i_upper_12_over_12_from_i
 #include "miscellany.hpp"               // each_equal()
 #include "ssize_lmi.hpp"
 #include "yare_input.hpp"
@@ -168,6 +168,9 @@ void convert_interest_rates
 // happens, we just replicate the previous value in order to avoid
 // costly floating point calculations. The investment management fee
 // is a scalar because that seems to be the universal practice.
+//
+// The rates that do change are all converted from annual to monthly
+// at once, which is faster than converting them one by one.
 void convert_interest_rates
     (std::vector<double> const& annual_gross_rate
     ,std::vector<double>      & annual_net_rate
@@ -183,9 +186,8 @@ void convert_interest_rates
     annual_net_rate .resize(length);
     monthly_net_rate.resize(length);
 
-    double cached_annual_net_rate     = 0.0;
-    double cached_monthly_net_rate    = 0.0;
-
+    std::vector<bool> changed(length);
+    std::vector<double> annual_net;
     double previous_annual_gross_rate = 0.0;
     double previous_spread            = 0.0;
     double previous_floor             = 0.0;
@@ -201,17 +203,32 @@ void convert_interest_rates
             previous_annual_gross_rate = annual_gross_rate[j];
             previous_spread            = spread           [j];
             previous_floor             = floor            [j];
-            convert_interest_rates
-                (annual_gross_rate[j]
-                ,cached_annual_net_rate
-                ,cached_monthly_net_rate
-                ,round_interest_rate
-                ,spread           [j]
-                ,spread_method
-                ,floor            [j]
-                ,fee
+            changed[j] = true;
+            annual_net.push_back
+                (transform_annual_gross_rate_to_annual_net
+                    (annual_gross_rate[j]
+                    ,spread           [j]
+                    ,spread_method
+                    ,floor            [j]
+                    ,fee
+                    )
                 );
             }
+        }
+    std::vector<double> const monthly_net =
+        i_upper_12_over_12_from_i<double>()(annual_net);
+
+    double cached_annual_net_rate     = 0.0;
+    double cached_monthly_net_rate    = 0.0;
+    int k = 0;
+    for(int j = 0; j < length; ++j)
+        {
+        if(changed[j])
+            {
+            cached_annual_net_rate  = round_interest_rate(annual_net [k]);
+            cached_monthly_net_rate = round_interest_rate(monthly_net[k]);
+            ++k;
+            }
         annual_net_rate [j] = cached_annual_net_rate;
         monthly_net_rate[j] = cached_monthly_net_rate;
         }
@@ -220,7 +237,8 @@ void convert_interest_rates
 // Transform vector of annual gross interest rates to monthly gross.
 // Often the rates are the same from one year to the next; when that
 // happens, we just replicate the previous value in order to avoid
-// costly floating point calculations.
+// costly floating point calculations. The rates that do change are
+// all converted at once.
 void convert_interest_rates
     (std::vector<double> const& annual_gross_rate
     ,std::vector<double>      & monthly_gross_rate
@@ -230,16 +248,29 @@ void convert_interest_rates
     int const length = lmi::ssize(annual_gross_rate);
     monthly_gross_rate.resize(length);
 
-    double cached_monthly_gross_rate  = 0.0;
-
+    std::vector<bool> changed(length);
+    std::vector<double> annual_gross;
     double previous_annual_gross_rate = 0.0;
     for(int j = 0; j < length; ++j)
         {
         if(previous_annual_gross_rate != annual_gross_rate[j])
             {
             previous_annual_gross_rate = annual_gross_rate[j];
-            cached_monthly_gross_rate = i_upper_12_over_12_from_i<double>()(annual_gross_rate[j]);
-            cached_monthly_gross_rate = round_interest_rate(cached_monthly_gross_rate);
+            changed[j] = true;
+            annual_gross.push_back(annual_gross_rate[j]);
+            }
+        }
+    std::vector<double> const monthly_gross =
+        i_upper_12_over_12_from_i<double>()(annual_gross);
+
+    double cached_monthly_gross_rate  = 0.0;
+    int k = 0;
+    for(int j = 0; j < length; ++j)
+        {
+        if(changed[j])
+            {
+            cached_monthly_gross_rate = round_interest_rate(monthly_gross[k]);
+            ++k;
             }
         monthly_gross_rate[j] = cached_monthly_gross_rate;
         }
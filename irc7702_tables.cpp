@@ -50,21 +50,19 @@ irc7702_tables::irc7702_tables
     ,ol_corr_ (length_)
     ,ol_7pp_  (length_)
 {
-    std::vector<double> q12(length_);
-    q12 += apply_binary(coi_rate_from_q<double>(), q_, max_coi_rate);
-
-    std::vector<double> i12(length_);
-    i12 += apply_unary(i_upper_12_over_12_from_i<double>(), i_);
+    std::vector<double> const q12 = coi_rate_from_q<double>()(q_, max_coi_rate);
+    std::vector<double> const i12 = i_upper_12_over_12_from_i<double>()(i_);
 
     ULCommFns const ulcf(q12, i12, i12, mce_option1_for_7702, mce_monthly);
 
-    ul_corr_ += ulcf.aD() / (ulcf.aDomega() + ulcf.kM());
-
     // 'E' is the shift operator, so E(7) f(x) = f(x+7).
     std::vector<double> E7aN(ulcf.aN());
     E7aN.insert(E7aN.end(), 7, 0.0);
     E7aN.erase(E7aN.begin(), 7 + E7aN.begin());
-    ul_7pp_ += (ulcf.aDomega() + ulcf.kM()) / (ulcf.aN() - E7aN);
+    Fuse
+        (Deferred(ul_corr_, OpAddAssign(), ulcf.aD() / (ulcf.aDomega() + ulcf.kM()))
+        ,Deferred(ul_7pp_ , OpAddAssign(), (ulcf.aDomega() + ulcf.kM()) / (ulcf.aN() - E7aN))
+        );
 
     std::vector<double> i_over_delta(length_);
     i_over_delta += i_ / log(1 + i_); // PETE's log(), not std::log()
@@ -29,6 +29,7 @@
 #include "crc32.hpp"
 #include "global_settings.hpp"
 #include "ledger_invariant.hpp"
+#include "ledger_snapshot.hpp"
 #include "ledger_variant.hpp"
 #include "map_lookup.hpp"
 #include "mc_enum_types_aux.hpp"        // mc_str()
@@ -343,14 +344,22 @@ unsigned int Ledger::CalculateCRC() const
 }
 
 //============================================================================
-void Ledger::Spew(std::ostream& os) const
+ledger_snapshot Ledger::Snapshot() const
 {
-    ledger_invariant_->Spew(os);
+    ledger_snapshot snapshot;
+    ledger_invariant_->Snapshot(snapshot);
     ledger_map_t const& l_map_rep = ledger_map_->held();
     for(auto const& i : l_map_rep)
         {
-        i.second.Spew(os);
+        i.second.Snapshot(snapshot);
         }
+    return snapshot;
+}
+
+//============================================================================
+void Ledger::Spew(std::ostream& os) const
+{
+    Snapshot().write_text(os);
 }
 
 //============================================================================
@@ -59,6 +59,7 @@
 class LedgerInvariant;
 class LedgerVariant;
 class ledger_map_holder;
+class ledger_snapshot;
 
 class LMI_SO Ledger final
 {
@@ -103,6 +104,7 @@ class LMI_SO Ledger final
     bool                                 is_composite       () const;
 
     unsigned int CalculateCRC() const;
+    ledger_snapshot Snapshot() const;
     void Spew(std::ostream& os) const;
 
     ledger_evaluator make_evaluator() const;
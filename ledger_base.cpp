@@ -28,6 +28,7 @@
 #include "bin_exp.hpp"
 #include "crc32.hpp"
 #include "et_vector.hpp"
+#include "ledger_snapshot.hpp"
 #include "value_cast.hpp"
 
 #include <algorithm>                    // max(), min()
@@ -188,6 +189,12 @@ double_vector_map const& LedgerBase::all_vectors() const
     return AllVectors;
 }
 
+//============================================================================
+scalar_map const& LedgerBase::all_scalars() const
+{
+    return AllScalars;
+}
+
 namespace
 {
 /// Special non-general helper function.
@@ -461,30 +468,20 @@ void LedgerBase::UpdateCRC(CRC& crc) const
 }
 
 //============================================================================
-void LedgerBase::Spew(std::ostream& os) const
+void LedgerBase::Snapshot(ledger_snapshot& snapshot) const
 {
     for(auto const& i : AllVectors)
         {
-        SpewVector(os, i.first, *i.second);
+        snapshot.add(i.first, *i.second);
         }
 
     for(auto const& i : AllScalars)
         {
-        os
-            << i.first
-            << "=="
-            << std::setprecision(DECIMAL_DIG) << *i.second
-            << '\n'
-            ;
+        snapshot.add(i.first, *i.second);
         }
 
     for(auto const& i : Strings)
         {
-        os
-            << i.first
-            << "=="
-            << *i.second
-            << '\n'
-            ;
+        snapshot.add(i.first, *i.second);
         }
 }
@@ -27,16 +27,16 @@
 #include "miscellany.hpp"               // minmax
 #include "so_attributes.hpp"
 
-#include <algorithm>                    // copy()
+#include <algorithm>
 #include <cfloat>                       // DECIMAL_DIG
 #include <iomanip>                      // setprecision()
-#include <iterator>                     // ostream_iterator
 #include <map>
 #include <ostream>
 #include <string>
 #include <vector>
 
 class CRC;
+class ledger_snapshot;
 
 /// Design notes for class LedgerBase.
 ///
@@ -190,6 +190,7 @@ class LMI_SO LedgerBase
         ) const;
 
     double_vector_map const& all_vectors() const;
+    scalar_map        const& all_scalars() const;
 
   protected:
     explicit LedgerBase(int a_Length);
@@ -207,7 +208,7 @@ class LMI_SO LedgerBase
 
     virtual int     GetLength() const = 0;
     virtual void    UpdateCRC(CRC&) const;
-    virtual void    Spew(std::ostream&) const;
+    virtual void    Snapshot(ledger_snapshot&) const;
 
     // TODO ?? A priori, protected data is a defect.
 
@@ -241,17 +242,4 @@ class LMI_SO LedgerBase
     std::string         scale_unit_;  // E.g., for (000,000): "millions"
 };
 
-template<typename T> void SpewVector
-    (std::ostream        &  os
-    ,std::string    const&  name
-    ,std::vector<T> const&  elements
-    )
-{
-    std::ostream_iterator<T> osi(os, "\n");
-
-    os << name << '\n';
-    os << std::setprecision(DECIMAL_DIG);
-    std::copy(elements.begin(), elements.end(), osi);
-}
-
 #endif // ledger_base_hpp
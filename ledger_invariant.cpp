@@ -30,12 +30,12 @@
 #include "crc32.hpp"
 #include "financial.hpp"                // for CalculateIrrs()
 #include "ledger.hpp"                   // for CalculateIrrs()
+#include "ledger_snapshot.hpp"
 #include "ledger_variant.hpp"           // for CalculateIrrs()
 #include "mc_enum_aux.hpp"              // mc_e_vector_to_string_vector()
 #include "oecumenic_enumerations.hpp"
 
 #include <algorithm>                    // max(), min()
-#include <ostream>
 
 //============================================================================
 LedgerInvariant::LedgerInvariant(int len)
@@ -870,16 +870,19 @@ void LedgerInvariant::UpdateCRC(CRC& a_crc) const
 }
 
 //============================================================================
-void LedgerInvariant::Spew(std::ostream& os) const
+void LedgerInvariant::Snapshot(ledger_snapshot& snapshot) const
 {
-    LedgerBase::Spew(os);
-
-    SpewVector(os, std::string("InforceLives")    ,InforceLives    );
-    SpewVector(os, std::string("DBOpt")           ,DBOpt           );
-    SpewVector(os, std::string("EeMode")          ,EeMode          );
-    SpewVector(os, std::string("ErMode")          ,ErMode          );
-    SpewVector(os, std::string("FundNumbers")     ,FundNumbers     );
-    SpewVector(os, std::string("FundNames")       ,FundNames       );
-    SpewVector(os, std::string("FundAllocs")      ,FundAllocs      );
-    SpewVector(os, std::string("FundAllocations") ,FundAllocations );
+    LedgerBase::Snapshot(snapshot);
+
+    snapshot.add("InforceLives"    ,InforceLives                         );
+    snapshot.add("DBOpt"           ,mc_e_vector_to_string_vector(DBOpt)  );
+    snapshot.add("EeMode"          ,mc_e_vector_to_string_vector(EeMode) );
+    snapshot.add("ErMode"          ,mc_e_vector_to_string_vector(ErMode) );
+    snapshot.add("FundNumbers"     ,FundNumbers                          );
+    snapshot.add("FundNames"       ,FundNames                            );
+    snapshot.add
+        ("FundAllocs"
+        ,std::vector<double>(FundAllocs.begin(), FundAllocs.end())
+        );
+    snapshot.add("FundAllocations" ,FundAllocations                      );
 }
@@ -62,7 +62,7 @@ class LMI_SO LedgerInvariant final
     void CalculateIrrs(Ledger const&);
 
     void UpdateCRC(CRC& a_crc) const override;
-    void Spew(std::ostream& os) const override;
+    void Snapshot(ledger_snapshot&) const override;
 
 // TODO ?? Make data private. Provide const accessors. Some values
 // (e.g., outlay) could be calculated dynamically instead of stored.
@@ -468,7 +468,7 @@ class LMI_SO LedgerInvariant final
     // Calendar dates are special because date formatting might be
     // customized or treated differently by different platforms.
     // Therefore, they are represented elsewhere as JDNs, and only the
-    // JDNs are used in UpdateCRC() and Spew().
+    // JDNs are used in UpdateCRC() and Snapshot().
     std::string     EffDate;
     std::string     DateOfBirth;
     std::string     LastCoiReentryDate;
@@ -0,0 +1,576 @@
+// Ledger values as a binary snapshot, for regression testing.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "ledger_snapshot.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "bourn_cast.hpp"
+#include "istream_to_string.hpp"
+#include "ssize_lmi.hpp"
+
+#include <algorithm>                    // max(), min()
+#include <bit>                          // endian
+#include <cfloat>                       // DECIMAL_DIG
+#include <cmath>                        // fabs()
+#include <cstdint>
+#include <cstring>                      // memcmp(), memcpy()
+#include <iomanip>                      // setprecision(), setw()
+#include <istream>
+#include <limits>
+#include <ostream>
+
+namespace
+{
+char const signature[8] = {'l', 'm', 'i', 's', 'n', 'a', 'p', '\0'};
+
+/// Relative errors smaller than this are not itemized in reports.
+///
+/// This is the threshold 'ihs_crc_comp' has always used.
+
+double const itemization_threshold = 1.0E-11;
+
+void put_uint32(std::string& s, int i)
+{
+    std::uint32_t const u = bourn_cast<std::uint32_t>(i);
+    char bytes[sizeof u];
+    std::memcpy(bytes, &u, sizeof u);
+    s.append(bytes, sizeof u);
+}
+
+void put_string(std::string& s, std::string const& t)
+{
+    put_uint32(s, lmi::ssize(t));
+    s.append(t);
+}
+
+void put_doubles(std::string& s, std::vector<double> const& v)
+{
+    put_uint32(s, lmi::ssize(v));
+    s.append
+        (reinterpret_cast<char const*>(v.data())
+        ,v.size() * sizeof(double)
+        );
+}
+
+/// Sequential reader of a snapshot's bytes.
+///
+/// Every read is bounds-checked, so that a truncated or corrupted
+/// file is diagnosed rather than misread.
+
+class snapshot_reader
+{
+  public:
+    explicit snapshot_reader(std::string const& bytes)
+        :bytes_ {bytes}
+        {
+        }
+
+    bool exhausted() const {return position_ == bytes_.size();}
+
+    char const* take(std::size_t length)
+        {
+        if(bytes_.size() - position_ < length)
+            {
+            alarum()
+                << "Snapshot is truncated: "
+                << length
+                << " bytes wanted at offset "
+                << position_
+                << ", but only "
+                << bytes_.size() - position_
+                << " remain."
+                << LMI_FLUSH
+                ;
+            }
+        char const* p = bytes_.data() + position_;
+        position_ += length;
+        return p;
+        }
+
+    int get_uint32()
+        {
+        std::uint32_t u;
+        std::memcpy(&u, take(sizeof u), sizeof u);
+        return bourn_cast<int>(u);
+        }
+
+    std::string get_string()
+        {
+        int const length = get_uint32();
+        return std::string(take(length), length);
+        }
+
+    std::vector<double> get_doubles()
+        {
+        int const count = get_uint32();
+        std::vector<double> v(count);
+        std::memcpy(v.data(), take(count * sizeof(double)), count * sizeof(double));
+        return v;
+        }
+
+  private:
+    std::string const& bytes_;
+    std::size_t        position_ {0};
+};
+
+/// Number of lines in the text form of a record.
+
+int text_lines(ledger_snapshot::record const& r)
+{
+    switch(r.kind)
+        {
+        case ledger_snapshot::numeric_vector: return 1 + lmi::ssize(r.numbers);
+        case ledger_snapshot::string_vector:  return 1 + lmi::ssize(r.strings);
+        case ledger_snapshot::numeric_scalar: return 1;
+        case ledger_snapshot::string_scalar:  return 1;
+        }
+    throw "Unreachable--silences a compiler diagnostic.";
+}
+
+void report_scalar_difference
+    (ledger_snapshot::record const& r1
+    ,ledger_snapshot::record const& r2
+    ,std::ostream&                  os
+    )
+{
+    std::streamsize const original_precision = os.precision();
+    os << std::setprecision(DECIMAL_DIG);
+    if(ledger_snapshot::numeric_scalar == r1.kind)
+        {
+        os
+            << "line1: " << r1.name << "==" << r1.numbers.front()
+            << "\nline2: " << r2.name << "==" << r2.numbers.front()
+            << '\n'
+            ;
+        }
+    else
+        {
+        os
+            << "line1: " << r1.name << "==" << r1.strings.front()
+            << "\nline2: " << r2.name << "==" << r2.strings.front()
+            << '\n'
+            ;
+        }
+    os.precision(original_precision);
+}
+
+/// Measure differences between two numeric vectors of equal length.
+///
+/// Errors are first calculated for all elements in a loop with no
+/// branches or calls that the compiler can vectorize; only elements
+/// whose error exceeds a threshold are then itemized, in order. The
+/// arithmetic and the treatment of zeros are as in relative_error(),
+/// but in double rather than long double precision, which doesn't
+/// affect the six significant digits of the summary.
+///
+/// Elements with identical representations are skipped, just as
+/// identical lines of text are, so that (e.g.) two NaNs are not
+/// deemed to differ.
+
+void compare_numbers
+    (std::string         const& name
+    ,std::vector<double> const& v1
+    ,std::vector<double> const& v2
+    ,std::vector<double>      & errors
+    ,snapshot_comparison      & summary
+    ,std::ostream             & os
+    )
+{
+    int const n = lmi::ssize(v1);
+    double const* const x = v1.data();
+    double const* const y = v2.data();
+    if(0 == std::memcmp(x, y, n * sizeof(double)))
+        {
+        return;
+        }
+
+    constexpr double inf {std::numeric_limits<double>::infinity()};
+    errors.resize(n);
+    double* const e = errors.data();
+    double max_abs_diff = summary.max_abs_diff;
+    double max_rel_err  = summary.max_rel_err;
+    for(int j = 0; j < n; ++j)
+        {
+        double const abs_diff    = std::fabs(x[j] - y[j]);
+        double const denominator = std::min(std::fabs(x[j]), std::fabs(y[j]));
+        double const rel_err =
+              (0.0 == x[j] && 0.0 == y[j]) ? 0.0
+            : (0.0 == denominator)         ? inf
+            :                                abs_diff / denominator
+            ;
+        e[j] = rel_err;
+        max_abs_diff = std::max(max_abs_diff, abs_diff);
+        max_rel_err  = std::max(max_rel_err , rel_err );
+        }
+    summary.max_abs_diff = max_abs_diff;
+    summary.max_rel_err  = max_rel_err;
+
+    std::streamsize const original_precision = os.precision();
+    for(int j = 0; j < n; ++j)
+        {
+        if(e[j] < itemization_threshold)
+            {
+            continue;
+            }
+        if(0 == std::memcmp(x + j, y + j, sizeof(double)))
+            {
+            continue;
+            }
+        os
+            << name
+            << '\n'
+            << std::setprecision(DECIMAL_DIG)
+            << e[j]
+            << "  " << x[j]
+            << " vs. " << y[j]
+            << '\n'
+            ;
+        os.precision(original_precision);
+        }
+}
+
+void compare_strings
+    (std::string              const& name
+    ,std::vector<std::string> const& v1
+    ,std::vector<std::string> const& v2
+    ,std::ostream                  & os
+    )
+{
+    for(int j = 0; j < lmi::ssize(v1); ++j)
+        {
+        if(v1[j] != v2[j])
+            {
+            os
+                << name
+                << "\nline1: " << v1[j]
+                << "\nline2: " << v2[j]
+                << '\n'
+                ;
+            }
+        }
+}
+} // Unnamed namespace.
+
+void ledger_snapshot::add(std::string const& name, std::vector<double> const& v)
+{
+    records_.push_back({numeric_vector, name, v, {}});
+}
+
+void ledger_snapshot::add(std::string const& name, std::vector<std::string> const& v)
+{
+    records_.push_back({string_vector, name, {}, v});
+}
+
+void ledger_snapshot::add(std::string const& name, double d)
+{
+    records_.push_back({numeric_scalar, name, {d}, {}});
+}
+
+void ledger_snapshot::add(std::string const& name, std::string const& s)
+{
+    records_.push_back({string_scalar, name, {}, {s}});
+}
+
+/// Write in the binary form described in the design notes.
+///
+/// The whole snapshot is assembled in memory, and then written at
+/// once, because typical snapshots are small.
+
+void ledger_snapshot::write(std::ostream& os) const
+{
+    static_assert(std::endian::native == std::endian::little);
+    static_assert(std::numeric_limits<double>::is_iec559);
+
+    std::string s(signature, sizeof signature);
+    put_uint32(s, version);
+    put_uint32(s, lmi::ssize(records_));
+    for(auto const& r : records_)
+        {
+        s.push_back(static_cast<char>(r.kind));
+        put_string(s, r.name);
+        switch(r.kind)
+            {
+            case numeric_vector:
+                {
+                put_doubles(s, r.numbers);
+                }
+                break;
+            case string_vector:
+                {
+                put_uint32(s, lmi::ssize(r.strings));
+                for(auto const& i : r.strings)
+                    {
+                    put_string(s, i);
+                    }
+                }
+                break;
+            case numeric_scalar:
+                {
+                LMI_ASSERT(1 == r.numbers.size());
+                s.append(reinterpret_cast<char const*>(r.numbers.data()), sizeof(double));
+                }
+                break;
+            case string_scalar:
+                {
+                LMI_ASSERT(1 == r.strings.size());
+                put_string(s, r.strings.front());
+                }
+                break;
+            }
+        }
+    os.write(s.data(), lmi::ssize(s));
+    if(!os)
+        {
+        alarum() << "Unable to write snapshot." << LMI_FLUSH;
+        }
+}
+
+/// Write exactly the text that Ledger::Spew() has always written.
+
+void ledger_snapshot::write_text(std::ostream& os) const
+{
+    os << std::setprecision(DECIMAL_DIG);
+    for(auto const& r : records_)
+        {
+        switch(r.kind)
+            {
+            case numeric_vector:
+                {
+                os << r.name << '\n';
+                for(auto const& i : r.numbers)
+                    {
+                    os << i << '\n';
+                    }
+                }
+                break;
+            case string_vector:
+                {
+                os << r.name << '\n';
+                for(auto const& i : r.strings)
+                    {
+                    os << i << '\n';
+                    }
+                }
+                break;
+            case numeric_scalar:
+                {
+                os << r.name << "==" << r.numbers.front() << '\n';
+                }
+                break;
+            case string_scalar:
+                {
+                os << r.name << "==" << r.strings.front() << '\n';
+                }
+                break;
+            }
+        }
+}
+
+ledger_snapshot ledger_snapshot::read(std::istream& is)
+{
+    std::string bytes;
+    istream_to_string(is, bytes);
+    snapshot_reader reader(bytes);
+
+    if(0 != std::memcmp(signature, reader.take(sizeof signature), sizeof signature))
+        {
+        alarum() << "File is not a ledger snapshot." << LMI_FLUSH;
+        }
+    int const file_version = reader.get_uint32();
+    if(version != file_version)
+        {
+        alarum()
+            << "Snapshot version is "
+            << file_version
+            << ", but only version "
+            << version
+            << " can be read."
+            << LMI_FLUSH
+            ;
+        }
+
+    ledger_snapshot z;
+    int const n = reader.get_uint32();
+    z.records_.reserve(n);
+    for(int j = 0; j < n; ++j)
+        {
+        record_kind const kind = static_cast<record_kind>(*reader.take(1));
+        std::string name = reader.get_string();
+        switch(kind)
+            {
+            case numeric_vector:
+                {
+                z.add(name, reader.get_doubles());
+                }
+                break;
+            case string_vector:
+                {
+                std::vector<std::string> v(reader.get_uint32());
+                for(auto& i : v)
+                    {
+                    i = reader.get_string();
+                    }
+                z.add(name, v);
+                }
+                break;
+            case numeric_scalar:
+                {
+                double d;
+                std::memcpy(&d, reader.take(sizeof d), sizeof d);
+                z.add(name, d);
+                }
+                break;
+            case string_scalar:
+                {
+                z.add(name, reader.get_string());
+                }
+                break;
+            default:
+                {
+                alarum()
+                    << "Snapshot record "
+                    << j
+                    << " ('"
+                    << name
+                    << "') has unknown kind "
+                    << static_cast<int>(kind)
+                    << "."
+                    << LMI_FLUSH
+                    ;
+                }
+            }
+        }
+    if(!reader.exhausted())
+        {
+        alarum() << "Snapshot has trailing data." << LMI_FLUSH;
+        }
+    return z;
+}
+
+/// Compare two snapshots, writing a report like 'ihs_crc_comp''s.
+///
+/// For each numeric element whose relative error is not negligible,
+/// the report shows the vector's name, the relative error, and both
+/// values; for each scalar or string that differs, it shows both, as
+/// lines of the text form would appear. It ends with a summary line
+/// that 'make system_test' extracts.
+///
+/// Snapshots must have the same structure--the same names, in the
+/// same order, with vectors of the same lengths--because differences
+/// in structure cannot be quantified.
+
+snapshot_comparison compare_snapshots
+    (ledger_snapshot const& s1
+    ,ledger_snapshot const& s2
+    ,std::ostream&          report
+    )
+{
+    std::vector<ledger_snapshot::record> const& v1 = s1.records();
+    std::vector<ledger_snapshot::record> const& v2 = s2.records();
+    if(v1.size() != v2.size())
+        {
+        alarum()
+            << "Snapshots have "
+            << v1.size()
+            << " and "
+            << v2.size()
+            << " records."
+            << LMI_FLUSH
+            ;
+        }
+
+    snapshot_comparison summary;
+    std::vector<double> errors;
+    for(int j = 0; j < lmi::ssize(v1); ++j)
+        {
+        ledger_snapshot::record const& r1 = v1[j];
+        ledger_snapshot::record const& r2 = v2[j];
+        bool const same_structure =
+               r1.kind           == r2.kind
+            && r1.name           == r2.name
+            && r1.numbers.size() == r2.numbers.size()
+            && r1.strings.size() == r2.strings.size()
+            ;
+        if(!same_structure)
+            {
+            alarum()
+                << "Snapshots differ in structure at record "
+                << j
+                << ": '"
+                << r1.name
+                << "' ("
+                << text_lines(r1)
+                << " lines) vs. '"
+                << r2.name
+                << "' ("
+                << text_lines(r2)
+                << " lines)."
+                << LMI_FLUSH
+                ;
+            }
+        summary.lines += text_lines(r1);
+
+        switch(r1.kind)
+            {
+            case ledger_snapshot::numeric_vector:
+                {
+                compare_numbers(r1.name, r1.numbers, r2.numbers, errors, summary, report);
+                }
+                break;
+            case ledger_snapshot::string_vector:
+                {
+                compare_strings(r1.name, r1.strings, r2.strings, report);
+                }
+                break;
+            case ledger_snapshot::numeric_scalar:
+                {
+                if(0 != std::memcmp(r1.numbers.data(), r2.numbers.data(), sizeof(double)))
+                    {
+                    report_scalar_difference(r1, r2, report);
+                    }
+                }
+                break;
+            case ledger_snapshot::string_scalar:
+                {
+                if(r1.strings != r2.strings)
+                    {
+                    report_scalar_difference(r1, r2, report);
+                    }
+                }
+                break;
+            }
+        }
+
+    report << "Processed " << summary.lines << " lines\n";
+    std::streamsize const original_precision = report.precision();
+    report
+        << std::setprecision(6) << std::setw(12)
+        << "Summary:"
+        << " max abs diff: " << summary.max_abs_diff
+        << " max rel err:  " << summary.max_rel_err
+        << '\n'
+        ;
+    report.precision(original_precision);
+    return summary;
+}
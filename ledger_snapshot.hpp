@@ -0,0 +1,116 @@
+// Ledger values as a binary snapshot, for regression testing.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef ledger_snapshot_hpp
+#define ledger_snapshot_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// Design notes for class ledger_snapshot.
+///
+/// A snapshot holds every named value that Ledger::Spew() writes, in
+/// the same order, but keeps numbers as binary doubles instead of
+/// formatting them as decimal text. It can be written as a compact
+/// binary file that is read back exactly and quickly, or converted
+/// to the text that Ledger::Spew() has always written ('.test' files)
+/// so that either form can be inspected or compared.
+///
+/// Binary layout, version 1 (all integers are little-endian uint32
+/// except where noted; doubles are IEC 60559 binary64):
+///   signature     8 bytes: "lmisnap" and a terminating NUL
+///   version       1
+///   record count
+///   records, each of which is:
+///     kind        1 byte: a record_kind enumerator
+///     name        length, then that many bytes
+///     payload     numeric vector: count, then that many doubles
+///                 string vector:  count, then that many strings
+///                 numeric scalar: one double
+///                 string scalar:  one string
+/// where a string is its length followed by that many bytes.
+///
+/// Snapshots are portable only to little-endian hardware, like the
+/// SOA binary tables that lmi already uses.
+
+class LMI_SO ledger_snapshot final
+{
+  public:
+    enum record_kind : unsigned char
+        {numeric_vector = 1
+        ,string_vector  = 2
+        ,numeric_scalar = 3
+        ,string_scalar  = 4
+        };
+
+    /// A named value. Scalars are stored as vectors of length one.
+
+    struct record
+    {
+        record_kind              kind;
+        std::string              name;
+        std::vector<double>      numbers;
+        std::vector<std::string> strings;
+    };
+
+    static constexpr int version {1};
+
+    void add(std::string const& name, std::vector<double>      const&);
+    void add(std::string const& name, std::vector<std::string> const&);
+    void add(std::string const& name, double);
+    void add(std::string const& name, std::string              const&);
+
+    std::vector<record> const& records() const {return records_;}
+
+    void write     (std::ostream&) const;
+    void write_text(std::ostream&) const;
+
+    static ledger_snapshot read(std::istream&);
+
+  private:
+    std::vector<record> records_;
+};
+
+/// Summary of differences between two snapshots.
+///
+/// 'lines' counts the lines of the equivalent text form. Differences
+/// are measured only for numeric vectors, just as 'ihs_crc_comp' has
+/// always measured them for '.test' files.
+
+struct snapshot_comparison
+{
+    int    lines        {0};
+    double max_abs_diff {0.0};
+    double max_rel_err  {0.0};
+};
+
+LMI_SO snapshot_comparison compare_snapshots
+    (ledger_snapshot const& s1
+    ,ledger_snapshot const& s2
+    ,std::ostream&          report
+    );
+
+#endif // ledger_snapshot_hpp
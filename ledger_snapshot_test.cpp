@@ -0,0 +1,303 @@
+// Ledger values as a binary snapshot, for regression testing--unit test.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "ledger_snapshot.hpp"
+
+#include "test_tools.hpp"
+#include "timer.hpp"
+
+#include <cfloat>                       // DECIMAL_DIG
+#include <iomanip>                      // setprecision()
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+/// A snapshot with every kind of record.
+
+ledger_snapshot sample_snapshot()
+{
+    ledger_snapshot z;
+    z.add("Basis"       , std::string("CurrentFull"));
+    z.add("AcctVal"     , std::vector<double> {0.1, 1000.0, -2.5, 0.0});
+    z.add("EmptyVector" , std::vector<double> {});
+    z.add("Age"         , 45.0);
+    z.add("GuarMaxMandE", 0.0065);
+    z.add("ProductName" , std::string("sample"));
+    z.add("DBOpt"       , std::vector<std::string> {"A", "B", "ROP"});
+    z.add("FundNames"   , std::vector<std::string> {"Money Market", ""});
+    return z;
+}
+
+std::string bytes_of(ledger_snapshot const& s)
+{
+    std::ostringstream oss;
+    s.write(oss);
+    return oss.str();
+}
+
+std::string text_of(ledger_snapshot const& s)
+{
+    std::ostringstream oss;
+    s.write_text(oss);
+    return oss.str();
+}
+
+ledger_snapshot from_bytes(std::string const& bytes)
+{
+    std::istringstream iss(bytes);
+    return ledger_snapshot::read(iss);
+}
+
+/// Format a value exactly as SpewVector() did.
+
+std::string spewed(double d)
+{
+    std::ostringstream oss;
+    oss << std::setprecision(DECIMAL_DIG) << d;
+    return oss.str();
+}
+} // Unnamed namespace.
+
+/// The text form must be exactly what Ledger::Spew() always wrote.
+
+void test_text_form()
+{
+    std::string const expected =
+          "Basis==CurrentFull\n"
+          "AcctVal\n"
+        + spewed(0.1) + "\n"
+          "1000\n"
+          "-2.5\n"
+          "0\n"
+          "EmptyVector\n"
+          "Age==45\n"
+          "GuarMaxMandE==" + spewed(0.0065) + "\n"
+          "ProductName==sample\n"
+          "DBOpt\n"
+          "A\n"
+          "B\n"
+          "ROP\n"
+          "FundNames\n"
+          "Money Market\n"
+          "\n"
+        ;
+    LMI_TEST_EQUAL(expected, text_of(sample_snapshot()));
+    LMI_TEST_EQUAL("0.100000000000000005551", spewed(0.1));
+}
+
+void test_binary_round_trip()
+{
+    ledger_snapshot const s0 = sample_snapshot();
+    std::string const bytes = bytes_of(s0);
+    LMI_TEST_EQUAL("lmisnap", std::string(bytes.c_str()));
+
+    ledger_snapshot const s1 = from_bytes(bytes);
+    LMI_TEST_EQUAL(s0.records().size(), s1.records().size());
+    LMI_TEST_EQUAL(bytes, bytes_of(s1));
+    LMI_TEST_EQUAL(text_of(s0), text_of(s1));
+
+    LMI_TEST(s1.records()[1].numbers == s0.records()[1].numbers);
+    LMI_TEST(s1.records()[7].strings == s0.records()[7].strings);
+
+    // An empty snapshot is valid.
+    LMI_TEST_EQUAL(0, from_bytes(bytes_of(ledger_snapshot())).records().size());
+}
+
+void test_malformed_input()
+{
+    std::string const bytes = bytes_of(sample_snapshot());
+
+    LMI_TEST_THROW
+        (from_bytes("AcctVal\n0.1\n")
+        ,std::runtime_error
+        ,"File is not a ledger snapshot."
+        );
+
+    std::string v2 = bytes;
+    v2[8] = '\2';
+    LMI_TEST_THROW
+        (from_bytes(v2)
+        ,std::runtime_error
+        ,"Snapshot version is 2, but only version 1 can be read."
+        );
+
+    LMI_TEST_THROW
+        (from_bytes(bytes.substr(0, bytes.size() - 1))
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Snapshot is truncated")
+        );
+
+    LMI_TEST_THROW
+        (from_bytes(bytes + '\0')
+        ,std::runtime_error
+        ,"Snapshot has trailing data."
+        );
+
+    // Corrupt the kind of the first record, which follows the
+    // signature, version, and record count.
+    std::string bad_kind = bytes;
+    bad_kind[16] = '\7';
+    LMI_TEST_THROW
+        (from_bytes(bad_kind)
+        ,std::runtime_error
+        ,"Snapshot record 0 ('Basis') has unknown kind 7."
+        );
+}
+
+void test_comparison()
+{
+    ledger_snapshot const s0 = sample_snapshot();
+    int const lines = 17;
+
+    std::ostringstream oss0;
+    snapshot_comparison const c0 = compare_snapshots(s0, s0, oss0);
+    LMI_TEST_EQUAL(lines, c0.lines);
+    LMI_TEST_EQUAL(0.0, c0.max_abs_diff);
+    LMI_TEST_EQUAL(0.0, c0.max_rel_err);
+    LMI_TEST_EQUAL
+        ("Processed 17 lines\n"
+         "    Summary: max abs diff: 0 max rel err:  0\n"
+        ,oss0.str()
+        );
+
+    // Differences below the itemization threshold affect only the
+    // summary; others are itemized in order, with scalars and strings
+    // shown as lines of text.
+    ledger_snapshot s1;
+    s1.add("Basis"       , std::string("GuaranteedFull"));
+    s1.add("AcctVal"     , std::vector<double> {0.1, 1000.0 * (1.0 + 1.0E-13), -2.0, 0.0});
+    s1.add("EmptyVector" , std::vector<double> {});
+    s1.add("Age"         , 46.0);
+    s1.add("GuarMaxMandE", 0.0065);
+    s1.add("ProductName" , std::string("sample"));
+    s1.add("DBOpt"       , std::vector<std::string> {"A", "A", "ROP"});
+    s1.add("FundNames"   , std::vector<std::string> {"Money Market", ""});
+
+    std::ostringstream oss1;
+    snapshot_comparison const c1 = compare_snapshots(s0, s1, oss1);
+    LMI_TEST_EQUAL(lines, c1.lines);
+    LMI_TEST_EQUAL(0.5, c1.max_abs_diff);
+    LMI_TEST_EQUAL(0.25, c1.max_rel_err);
+    LMI_TEST_EQUAL
+        ("line1: Basis==CurrentFull\n"
+         "line2: Basis==GuaranteedFull\n"
+         "AcctVal\n"
+         "0.25  -2.5 vs. -2\n"
+         "line1: Age==45\n"
+         "line2: Age==46\n"
+         "DBOpt\n"
+         "line1: B\n"
+         "line2: A\n"
+         "Processed 17 lines\n"
+         "    Summary: max abs diff: 0.5 max rel err:  0.25\n"
+        ,oss1.str()
+        );
+
+    // Zero vs. nonzero has infinite relative error, as in
+    // relative_error().
+    ledger_snapshot z0;
+    z0.add("V", std::vector<double> {0.0, 1.0});
+    ledger_snapshot z1;
+    z1.add("V", std::vector<double> {1.0, 1.0});
+    std::ostringstream oss2;
+    snapshot_comparison const c2 = compare_snapshots(z0, z1, oss2);
+    LMI_TEST_EQUAL(1.0, c2.max_abs_diff);
+    LMI_TEST(std::numeric_limits<double>::infinity() == c2.max_rel_err);
+
+    // Differences in structure cannot be quantified.
+    ledger_snapshot short_vector;
+    short_vector.add("V", std::vector<double> {0.0});
+    LMI_TEST_THROW
+        (compare_snapshots(z0, short_vector, oss2)
+        ,std::runtime_error
+        ,"Snapshots differ in structure at record 0:"
+         " 'V' (3 lines) vs. 'V' (2 lines)."
+        );
+    ledger_snapshot renamed;
+    renamed.add("W", std::vector<double> {0.0, 1.0});
+    LMI_TEST_THROW
+        (compare_snapshots(z0, renamed, oss2)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Snapshots differ in structure")
+        );
+    LMI_TEST_THROW
+        (compare_snapshots(z0, s0, oss2)
+        ,std::runtime_error
+        ,"Snapshots have 1 and 8 records."
+        );
+}
+
+/// Compare speed of the binary form to the text form.
+///
+/// Each snapshot has as many values as a typical ledger: a few hundred
+/// vectors of a hundred years' values.
+
+void test_speed()
+{
+    ledger_snapshot s0;
+    ledger_snapshot s1;
+    for(int j = 0; j < 400; ++j)
+        {
+        std::vector<double> v(100);
+        for(int k = 0; k < 100; ++k)
+            {
+            v[k] = 1000.0 * j + k + 0.01;
+            }
+        s0.add("Vector" + std::to_string(j), v);
+        v[j % 100] += 1.0E-12;
+        s1.add("Vector" + std::to_string(j), v);
+        }
+    std::string const bytes = bytes_of(s0);
+
+    auto f0 = [&s0   ] {bytes_of(s0);};
+    auto f1 = [&s0   ] {text_of(s0);};
+    auto f2 = [&bytes] {from_bytes(bytes);};
+    auto f3 = [&s0, &s1]
+        {
+        std::ostringstream oss;
+        compare_snapshots(s0, s1, oss);
+        };
+    std::cout
+        << "\n  Speed tests:"
+        << "\n  write binary : " << TimeAnAliquot(f0)
+        << "\n  write text   : " << TimeAnAliquot(f1)
+        << "\n  read binary  : " << TimeAnAliquot(f2)
+        << "\n  compare      : " << TimeAnAliquot(f3)
+        << std::endl
+        ;
+}
+
+int test_main(int, char*[])
+{
+    test_text_form();
+    test_binary_round_trip();
+    test_malformed_input();
+    test_comparison();
+    test_speed();
+
+    return 0;
+}
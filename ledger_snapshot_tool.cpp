@@ -0,0 +1,74 @@
+// Compare ledger snapshots, or convert them to text.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "ledger_snapshot.hpp"
+#include "main_common.hpp"
+
+#include <cstdlib>                      // exit()
+#include <cstring>                      // strcmp()
+#include <fstream>
+#include <iostream>
+
+// Usage:
+//   ledger_snapshot_tool FILE1 FILE2
+// compares two '.snapshot' files written by 'emit_test_snapshot' and
+// writes the same report that 'ihs_crc_comp' writes for two '.test'
+// files, so that 'make system_test' can treat both alike;
+//   ledger_snapshot_tool --text FILE
+// writes FILE as the text that 'emit_test_data' would have written.
+
+namespace
+{
+ledger_snapshot read_snapshot(char const* filename)
+{
+    std::ifstream ifs(filename, std::ios_base::in | std::ios_base::binary);
+    if(!ifs)
+        {
+        std::cerr << "Cannot open " << filename << '\n';
+        std::exit(EXIT_FAILURE);
+        }
+    return ledger_snapshot::read(ifs);
+}
+} // Unnamed namespace.
+
+int try_main(int argc, char* argv[])
+{
+    if(3 == argc && 0 == std::strcmp("--text", argv[1]))
+        {
+        read_snapshot(argv[2]).write_text(std::cout);
+        return EXIT_SUCCESS;
+        }
+
+    if(3 != argc)
+        {
+        std::cerr
+            << "Usage:\n"
+            << "  " << argv[0] << " FILE1 FILE2   compare two snapshots\n"
+            << "  " << argv[0] << " --text FILE   convert a snapshot to text\n"
+            ;
+        return EXIT_FAILURE;
+        }
+
+    compare_snapshots(read_snapshot(argv[1]), read_snapshot(argv[2]), std::cout);
+    return EXIT_SUCCESS;
+}
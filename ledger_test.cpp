@@ -24,6 +24,7 @@
 #include "ledger.hpp"
 #include "ledger_evaluator.hpp"
 #include "ledger_invariant.hpp"
+#include "ledger_snapshot.hpp"
 #include "ledger_text_formats.hpp"      // ledger_format()
 #include "ledger_variant.hpp"
 #include "oecumenic_enumerations.hpp"
@@ -31,7 +32,10 @@
 #include "test_tools.hpp"
 #include "timer.hpp"
 
+#include <algorithm>                    // count()
 #include <cstdio>                       // remove()
+#include <sstream>
+#include <string>
 
 void authenticate_system() {} // Do-nothing stub.
 
@@ -43,6 +47,7 @@ class ledger_test
         test_default_initialization();
         test_evaluator();
         test_ledger_format();
+        test_snapshot();
         test_speed();
         }
 
@@ -50,6 +55,7 @@ class ledger_test
     static void test_default_initialization();
     static void test_evaluator();
     static void test_ledger_format();
+    static void test_snapshot();
     static void test_speed();
 };
 
@@ -98,6 +104,33 @@ void ledger_test::test_ledger_format()
     LMI_TEST_EQUAL("0.0314"     , ledger_format(pi, g3));
 }
 
+/// A snapshot's text form is what Spew() writes, and its binary form
+/// is read back exactly.
+
+void ledger_test::test_snapshot()
+{
+    Ledger ledger(100, mce_finra, false, false, false);
+    ledger_snapshot const s0 = ledger.Snapshot();
+
+    std::ostringstream spewed;
+    ledger.Spew(spewed);
+    std::string const text = spewed.str();
+
+    std::stringstream ss;
+    s0.write(ss);
+    ledger_snapshot const s1 = ledger_snapshot::read(ss);
+
+    std::ostringstream report;
+    snapshot_comparison const c = compare_snapshots(s0, s1, report);
+    LMI_TEST_EQUAL(std::count(text.begin(), text.end(), '\n'), c.lines);
+    LMI_TEST_EQUAL(0.0, c.max_abs_diff);
+    LMI_TEST_EQUAL(0.0, c.max_rel_err);
+
+    std::ostringstream oss;
+    s1.write_text(oss);
+    LMI_TEST_EQUAL(text, oss.str());
+}
+
 void mete_format()
 {
     constexpr double pi_millions {3141592.65358979323851};
@@ -24,10 +24,10 @@
 #include "ledger_variant.hpp"
 
 #include "assert_lmi.hpp"
+#include "ledger_snapshot.hpp"
 #include "mc_enum_types_aux.hpp"        // mc_str()
 
 #include <algorithm>                    // max()
-#include <ostream>
 
 //============================================================================
 LedgerVariant::LedgerVariant(int len)
@@ -231,12 +231,12 @@ void LedgerVariant::UpdateCRC(CRC& a_crc) const
 }
 
 //============================================================================
-void LedgerVariant::Spew(std::ostream& os) const
+void LedgerVariant::Snapshot(ledger_snapshot& snapshot) const
 {
     mcenum_run_basis b(mce_run_gen_curr_sep_full);
     set_run_basis_from_cloven_bases(b, GenBasis_, SepBasis_);
-    os << "Basis" << "==" << mc_str(b) << '\n';
-    LedgerBase::Spew(os);
+    snapshot.add("Basis", mc_str(b));
+    LedgerBase::Snapshot(snapshot);
 }
 
 ledger_map_holder::ledger_map_holder(ledger_map_t const& z)
@@ -80,7 +80,7 @@ class LMI_SO LedgerVariant final
         {return InitAnnSepAcctNetInt;}
 
     void UpdateCRC(CRC& a_crc) const override;
-    void Spew(std::ostream& os) const override;
+    void Snapshot(ledger_snapshot&) const override;
 
 // TODO ?? Make data private. Provide const accessors. Some of these
 // values could be calculated dynamically instead of stored.
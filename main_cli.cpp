@@ -23,13 +23,17 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "batch_scheduler.hpp"
 #include "calendar_date.hpp"
+#include "ce_product_name.hpp"
+#include "census_import.hpp"            // import_census_file()
 #include "contains.hpp"
+#include "database.hpp"
 #include "dbdict.hpp"                   // print_databases()
 #include "getopt.hpp"
 #include "global_settings.hpp"
 #include "gpt_server.hpp"
-#include "handle_exceptions.hpp"        // report_exception()
+#include "illustration_service.hpp"
 #include "illustrator.hpp"
 #include "input.hpp"
 #include "ledger.hpp"
@@ -40,21 +44,29 @@
 #include "main_common.hpp"
 #include "mc_enum.hpp"
 #include "mc_enum_types.hpp"
-#include "mc_enum_types_aux.hpp"        // allowed_strings_emission(), mc_emission_from_string()
+#include "mc_enum_types_aux.hpp"        // all_strings_*(), allowed_strings_emission()...
 #include "mec_server.hpp"
 #include "miscellany.hpp"
+#include "parallel_for.hpp"
 #include "path.hpp"
 #include "path_utility.hpp"
+#include "scenario_sweep.hpp"
+#include "shared_table_store.hpp"
 #include "so_attributes.hpp"
+#include "ssize_lmi.hpp"
 #include "timer.hpp"
+#include "unix_socket_server.hpp"
 #include "value_cast.hpp"
 #include "verify_products.hpp"
+#include "yare_input.hpp"
 
-#include <algorithm>                    // for_each()
+#include <algorithm>                    // all_of(), for_each(), unique()
 #include <cmath>                        // fabs()
 #include <cstdio>                       // printf()
+#include <exception>
 #include <functional>                   // bind()
 #include <ios>
+#include <iterator>                     // back_inserter()
 #include <iostream>
 #include <ostream>
 #include <sstream>
@@ -138,6 +150,49 @@ void self_test()
             ;
         }
 
+    // A sweep yields the same values as projecting each variant by
+    // itself, whether or not the variant shares a prototype's rates.
+    if(!antediluvian)
+        {
+        std::vector<sweep_variant> const variants
+            {{{"GeneralAccountRate", "0.04"}}
+            ,{{"Payment", "10000.0"}, {"SpecifiedAmount", "500000.0"}}
+            ,{{"Smoking", "Smoker"}}
+            };
+        std::vector<std::string> const columns
+            {"LapseYear"
+            ,"CSVNet@10"
+            ,"EOYDeathBft@10"
+            ,"AcctVal@20"
+            };
+        std::vector<sweep_result> const results =
+            run_scenario_sweep(naic_no_solve, variants, columns);
+        for(int j = 0; j < lmi::ssize(variants); ++j)
+            {
+            Input standalone {naic_no_solve};
+            for(auto const& i : variants[j])
+                {
+                standalone[i.first] = i.second;
+                }
+            z("CLI_selftest", standalone);
+            std::vector<std::string> expected;
+            for(auto const& c : columns)
+                {
+                expected.push_back(sweep_value(*z.principal_ledger(), c));
+                }
+            if(!results[j].succeeded || expected != results[j].values)
+                {
+                warning()
+                    << "Sweep variant "
+                    << 1 + j
+                    << " differs from its standalone projection: "
+                    << results[j].status
+                    << LMI_FLUSH
+                    ;
+                }
+            }
+        }
+
     Input finra_no_solve      {naic_no_solve};
     Input finra_solve_specamt {naic_solve_specamt};
     Input finra_solve_ee_prem {naic_solve_ee_prem};
@@ -167,14 +222,89 @@ void self_test()
 #endif // !defined _GLIBCXX_DEBUG
 }
 
+/// One illustration run by product_test().
+
+struct product_test_job
+{
+    std::string description;
+    std::string product;
+    Input       input;
+    std::string failure  {};
+    std::string warnings {};
+    bool        failed   {false};
+};
+
+/// Expand one product-gender-class-smoking combination to jobs for
+/// the minimum, midpoint, and maximum issue ages, or to no jobs at
+/// all if the product doesn't allow that combination.
+///
+/// Harmonization coerces any disallowed choice to an allowed one, so
+/// a combination is disallowed iff reconciling it changes it.
+
+std::vector<product_test_job> product_test_grid_jobs
+    (Input              input
+    ,std::string const& product
+    ,std::string const& gender
+    ,std::string const& uw_class
+    ,std::string const& smoking
+    )
+{
+    input["Gender"           ] = gender;
+    input["UnderwritingClass"] = uw_class;
+    input["Smoking"          ] = smoking;
+    input.Reconcile();
+    if
+        (  gender   != input["Gender"           ].str()
+        || uw_class != input["UnderwritingClass"].str()
+        || smoking  != input["Smoking"          ].str()
+        )
+        {
+        return {};
+        }
+
+    product_database const database {yare_input(input)};
+    int const min_age = database.query<int>(DB_MinIssAge);
+    int const max_age = database.query<int>(DB_MaxIssAge);
+    std::vector<int> ages {min_age, (min_age + max_age) / 2, max_age};
+    ages.erase(std::unique(ages.begin(), ages.end()), ages.end());
+
+    std::vector<product_test_job> z;
+    for(auto const& age : ages)
+        {
+        input["IssueAge"] = value_cast<std::string>(age);
+        z.push_back
+            ({product
+                + ", " + input["StateOfJurisdiction"].str()
+                + ", " + gender
+                + ", " + uw_class
+                + ", " + smoking
+                + ", " + value_cast<std::string>(age)
+            ,product
+            ,input
+            });
+        }
+    return z;
+}
+
 /// Validate products.
 ///
 /// Run an illustration for every product in every state (whether
 /// approved there or not), reporting any conflict in parameters
 /// that would make that impossible. See:
 ///   https://lists.nongnu.org/archive/html/lmi/2020-11/msg00020.html
+///
+/// Optionally, instead sweep a grid of every gender, underwriting
+/// class, and smoking status that each product allows, at its
+/// minimum, midpoint, and maximum issue ages. To keep that sweep's
+/// runtime bearable, it uses only the default state.
+///
+/// Each illustration is an independent job, run concurrently. Any
+/// failures or warnings are collected per job and reported after all
+/// jobs have finished, grouped by product and in the same order as
+/// for a serial run. Each illustration's run bases are projected on
+/// its job's thread, because parallel_for() doesn't nest.
 
-void product_test()
+void product_test(bool grid)
 {
     // Allow unapproved states.
     global_settings::instance().set_regression_testing(true);
@@ -184,29 +314,144 @@ void product_test()
     input["Payment"           ] = "0.0";
     input["SolveType"         ] = "No solve";
 
-    illustrator z(mce_emit_nothing);
+    std::vector<std::string> const& p = ce_product_name().all_strings();
 
-    ce_product_name c;
-    std::vector<std::string> const& p = c.all_strings();
-    std::vector<std::string> const& s = all_strings_state();
-    for(auto const& i : p)
+    std::vector<product_test_job> jobs;
+    int skipped = 0;
+    if(!grid)
+        {
+        for(auto const& i : p)
+            {
+            input["ProductName"        ] = i;
+            for(auto const& j : all_strings_state())
+                {
+                input["StateOfJurisdiction"] = j;
+                jobs.push_back({i + ", " + j, i, input});
+                }
+            }
+        }
+    else
         {
-        std::cout << "Testing product " << i << std::endl;
-        input["ProductName"        ] = i;
-        for(auto const& j : s)
+        struct combination
+        {
+            std::string product;
+            std::string gender;
+            std::string uw_class;
+            std::string smoking;
+        };
+        std::vector<combination> c;
+        for(auto const& i : p)
+            {
+            for(auto const& g : all_strings_gender())
+                {
+                for(auto const& u : all_strings_class())
+                    {
+                    for(auto const& s : all_strings_smoking())
+                        {
+                        c.push_back({i, g, u, s});
+                        }
+                    }
+                }
+            }
+        skipped = lmi::ssize(c);
+        // Reconciliation reads product files, so it's worth doing
+        // concurrently too.
+        std::vector<std::vector<product_test_job>> expanded(c.size());
+        std::vector<std::string> warnings(c.size());
+        parallel_for
+            (lmi::ssize(c)
+            ,[&](int j)
+                {
+                scoped_alert_capture const capture;
+                Input z(input);
+                z["ProductName"] = c[j].product;
+                expanded[j] = product_test_grid_jobs
+                    (z
+                    ,c[j].product
+                    ,c[j].gender
+                    ,c[j].uw_class
+                    ,c[j].smoking
+                    );
+                warnings[j] = capture.warnings();
+                }
+            );
+        for(int j = 0; j < lmi::ssize(c); ++j)
+            {
+            if(!warnings[j].empty())
+                {
+                std::cout
+                    << c[j].product
+                    << ", " << c[j].gender
+                    << ", " << c[j].uw_class
+                    << ", " << c[j].smoking
+                    << ":\n" << warnings[j]
+                    ;
+                }
+            }
+        for(auto& i : expanded)
             {
-            input["StateOfJurisdiction"] = j;
+            if(i.empty())
+                {
+                continue;
+                }
+            --skipped;
+            std::move(i.begin(), i.end(), std::back_inserter(jobs));
+            }
+        }
+
+    parallel_for
+        (lmi::ssize(jobs)
+        ,[&jobs](int j)
+            {
+            product_test_job& z = jobs[j];
+            scoped_alert_capture const capture;
             try
                 {
-                z("eraseme", input);
+                illustrator i(mce_emit_nothing);
+                i("eraseme", z.input);
+                }
+            catch(std::exception const& e)
+                {
+                z.failed  = true;
+                z.failure = e.what();
                 }
             catch(...)
                 {
-                std::cout << i << ", " << j << ":" << std::endl;
-                report_exception();
+                z.failed  = true;
+                z.failure = "Unknown exception.";
                 }
+            z.warnings = capture.warnings();
+            }
+        );
+
+    int failures = 0;
+    std::string product;
+    for(auto const& z : jobs)
+        {
+        if(product != z.product)
+            {
+            product = z.product;
+            std::cout << "Testing product " << product << '\n';
+            }
+        if(z.failed)
+            {
+            ++failures;
+            std::cout << z.description << ":\n" << z.failure << '\n';
             }
+        if(!z.warnings.empty())
+            {
+            std::cout << z.description << ":\n" << z.warnings;
+            }
+        }
+    std::cout
+        << jobs.size() << " illustrations, "
+        << failures << " failed"
+        ;
+    if(grid)
+        {
+        std::cout << "; " << skipped << " disallowed combinations skipped";
         }
+    std::cout << std::endl;
 }
 
 void process_command_line(int argc, char* argv[])
@@ -220,27 +465,67 @@ void process_command_line(int argc, char* argv[])
         {"mello"        ,NO_ARG   ,nullptr ,077 ,nullptr ,"fraud"},
         {"prospicience" ,REQD_ARG ,nullptr ,003 ,nullptr ,"validation date"},
         {"accept"       ,NO_ARG   ,nullptr ,'a' ,nullptr ,"accept license (-l to display)"},
+        {"batch"        ,NO_ARG   ,nullptr ,'b' ,nullptr ,"run all files concurrently, then summarize"},
+        {"sweep_columns",REQD_ARG ,nullptr ,'c' ,nullptr ,"ledger values for '--sweep' to show"},
         {"data_path"    ,REQD_ARG ,nullptr ,'d' ,nullptr ,"path to data files"},
         {"emit"         ,REQD_ARG ,nullptr ,'e' ,nullptr ,"choose what output to emit"},
         {"file"         ,REQD_ARG ,nullptr ,'f' ,nullptr ,"input file to run"},
+        {"product_grid" ,NO_ARG   ,nullptr ,'g' ,nullptr ,"validate products over a grid and exit"},
         {"help"         ,NO_ARG   ,nullptr ,'h' ,nullptr ,"display this help and exit"},
+        {"import_census",REQD_ARG ,nullptr ,'i' ,nullptr ,"tab-delimited census to convert to .cns"},
         {"license"      ,NO_ARG   ,nullptr ,'l' ,nullptr ,"display license and exit"},
+        {"manifest"     ,REQD_ARG ,nullptr ,'m' ,nullptr ,"file listing input files to run"},
         {"product_test" ,NO_ARG   ,nullptr ,'o' ,nullptr ,"validate products and exit"},
         {"print_db"     ,NO_ARG   ,nullptr ,'p' ,nullptr ,"print products and exit"},
+        {"request"      ,REQD_ARG ,nullptr ,'r' ,nullptr ,"send '--file's to server on this socket"},
         {"selftest"     ,NO_ARG   ,nullptr ,'s' ,nullptr ,"perform self test and exit"},
         {"test_db"      ,NO_ARG   ,nullptr ,'t' ,nullptr ,"test products and exit"},
+        {"share_tables" ,NO_ARG   ,nullptr ,'u' ,nullptr ,"publish rate tables in shared memory and exit"},
+        {"serve"        ,REQD_ARG ,nullptr ,'v' ,nullptr ,"serve requests on this socket"},
+        {"sweep"        ,REQD_ARG ,nullptr ,'w' ,nullptr ,"run each '.ill', '.ini', or '.inix' file with these variants"},
         {"pyx"          ,REQD_ARG ,nullptr ,'x' ,nullptr ,"for docimasy"},
         {nullptr        ,NO_ARG   ,nullptr ,000 ,nullptr ,""}
       };
 
     bool license_accepted    = false;
+    bool run_as_batch        = false;
+    bool share_tables        = false;
 
     mcenum_emission emission(mce_emit_nothing);
+    std::string emission_names;
 
+    std::string request_socket;
+    std::string serve_socket;
+
+    std::string sweep_name;
+    std::string sweep_columns = "LapseYear,CSVNet@10,EOYDeathBft@10";
+
+    std::vector<std::string> census_import_names;
     std::vector<std::string> illustrator_names;
     std::vector<std::string> mec_server_names;
     std::vector<std::string> gpt_server_names;
 
+    // Route each input file to the class that runs it.
+    auto add_file = [&](std::string const& s)
+        {
+        switch(input_file_runner(s))
+            {
+            case e_run_illustrator: illustrator_names.push_back(s); break;
+            case e_run_mec_server:  mec_server_names .push_back(s); break;
+            case e_run_gpt_server:  gpt_server_names .push_back(s); break;
+            case e_unrecognized_input:
+                {
+                warning()
+                    << "'"
+                    << s
+                    << "': unrecognized file extension."
+                    << LMI_FLUSH
+                    ;
+                }
+                break;
+            }
+        };
+
     int digit_optind = 0;
     int this_option_optind = 1;
     int option_index = 0;
@@ -330,6 +615,12 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'b':
+                {
+                run_as_batch = true;
+                }
+                break;
+
             case 'd':
                 {
                 global_settings::instance().set_data_directory
@@ -338,10 +629,18 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'c':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                sweep_columns = getopt_long.optarg;
+                }
+                break;
+
             case 'e':
                 {
                 LMI_ASSERT(nullptr != getopt_long.optarg);
                 std::string const s(getopt_long.optarg);
+                emission_names += "," + s;
                 std::istringstream iss(s);
                 for(;EOF != iss.peek();)
                     {
@@ -373,29 +672,14 @@ void process_command_line(int argc, char* argv[])
             case 'f':
                 {
                 LMI_ASSERT(nullptr != getopt_long.optarg);
-                std::string const s(getopt_long.optarg);
-                std::string const e = fs::path{s}.extension().string();
-                if(".cns" == e || ".ill" == e || ".ini" == e || ".inix" == e)
-                    {
-                    illustrator_names.push_back(getopt_long.optarg);
-                    }
-                else if(".mec" == e)
-                    {
-                    mec_server_names.push_back(getopt_long.optarg);
-                    }
-                else if(".gpt" == e)
-                    {
-                    gpt_server_names.push_back(getopt_long.optarg);
-                    }
-                else
-                    {
-                    warning()
-                        << "'"
-                        << s
-                        << "': unrecognized file extension."
-                        << LMI_FLUSH
-                        ;
-                    }
+                add_file(getopt_long.optarg);
+                }
+                break;
+
+            case 'g':
+                {
+                product_test(true);
+                return;
                 }
                 break;
 
@@ -411,6 +695,13 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'i':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                census_import_names.push_back(getopt_long.optarg);
+                }
+                break;
+
             case 'l':
                 {
                 std::cerr << license_as_text() << "\n\n";
@@ -418,9 +709,19 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'm':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                for(auto const& i : read_batch_manifest(getopt_long.optarg))
+                    {
+                    add_file(i);
+                    }
+                }
+                break;
+
             case 'o':
                 {
-                product_test();
+                product_test(false);
                 return;
                 }
                 break;
@@ -432,6 +733,13 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'r':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                request_socket = getopt_long.optarg;
+                }
+                break;
+
             case 's':
                 {
                 self_test();
@@ -446,6 +754,26 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'u':
+                {
+                share_tables = true;
+                }
+                break;
+
+            case 'v':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                serve_socket = getopt_long.optarg;
+                }
+                break;
+
+            case 'w':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                sweep_name = getopt_long.optarg;
+                }
+                break;
+
             case 'x':
                 {
                 global_settings::instance().set_pyx(getopt_long.optarg);
@@ -483,6 +811,106 @@ void process_command_line(int argc, char* argv[])
         std::cerr << license_notices_as_text() << "\n\n";
         }
 
+    // Publish tables for other processes, which use them until they
+    // are published again. The data directory may have been given
+    // after this option, so this is done only after all are read.
+    if(share_tables)
+        {
+        std::cout
+            << publish_actuarial_tables(global_settings::instance().data_directory())
+            << " tables published in shared memory."
+            << std::endl
+            ;
+        return;
+        }
+
+    // Serve until told to shut down. Product files and tables are
+    // cached as they are first used, and remain cached.
+    if(!serve_socket.empty())
+        {
+        serve_unix_socket(serve_socket, illustration_service());
+        return;
+        }
+
+    // Write each imported census as a '.cns' file. Run it, too, if
+    // any output is wanted.
+    for(auto const& i : census_import_names)
+        {
+        fs::path const cns = import_census_file(i, default_cell());
+        if(mce_emit_nothing != emission)
+            {
+            illustrator_names.push_back(cns.string());
+            }
+        }
+
+    // Let a server run the files instead, and show its responses.
+    if(!request_socket.empty())
+        {
+        for(auto const& v : {illustrator_names, mec_server_names, gpt_server_names})
+            {
+            for(auto const& i : v)
+                {
+                std::string const path = fs::absolute(i).string();
+                std::cout
+                    << path
+                    << '\t'
+                    << request_via_unix_socket
+                        (request_socket
+                        ,"run\t" + emission_names + "\t" + path
+                        )
+                    << std::endl
+                    ;
+                }
+            }
+        return;
+        }
+
+    // Project each input file with every variant in the sweep, and
+    // show a matrix of the requested ledger values.
+    if(!sweep_name.empty())
+        {
+        std::vector<sweep_variant> const variants = read_sweep_variants(sweep_name);
+        std::vector<std::string> columns;
+        std::istringstream iss(sweep_columns);
+        for(std::string token; std::getline(iss, token, ',');)
+            {
+            if(!token.empty())
+                {
+                columns.push_back(token);
+                }
+            }
+        for(auto const& i : illustrator_names)
+            {
+            Input const base = read_sweep_base(i);
+            std::cout << i << '\n';
+            write_sweep_results
+                (std::cout
+                ,columns
+                ,run_scenario_sweep(base, variants, columns)
+                );
+            }
+        return;
+        }
+
+    // Run every file in one process, then summarize.
+    if(run_as_batch)
+        {
+        std::vector<std::string> names;
+        for(auto const& v : {illustrator_names, mec_server_names, gpt_server_names})
+            {
+            names.insert(names.end(), v.begin(), v.end());
+            }
+        Timer timer;
+        std::vector<batch_job_result> const results = run_batch(names, emission);
+        write_batch_summary(std::cout, results, timer.stop().elapsed_seconds());
+        auto const succeeded = [](batch_job_result const& r) {return r.succeeded;};
+        if(!std::all_of(results.begin(), results.end(), succeeded))
+            {
+            alarum() << "Not every file was run successfully." << LMI_FLUSH;
+            }
+        return;
+        }
+
     std::for_each
         (illustrator_names.begin()
         ,illustrator_names.end()
@@ -24,6 +24,7 @@
 #include "math_functions.hpp"
 
 #include "fdlibm.hpp"                   // fdlibm_expm1(), fdlibm_log1p()
+#include "ssize_lmi.hpp"
 
 // expm1() and log1p()
 //
@@ -34,6 +35,10 @@
 // are x87 code.
 //
 // For 'float' and 'long double', simply forward to the C RTL.
+//
+// The in-place vector overloads for 'double' use fdlibm batch
+// kernels, which vectorize the common case without changing any
+// result.
 
 namespace lmi
 {
@@ -43,4 +48,14 @@ namespace lmi
      double log1p(     double z) {return fdlibm_log1p(z);}
 long double expm1(long double z) {return std::expm1(z);}
 long double log1p(long double z) {return std::log1p(z);}
+
+void expm1_in_place(std::vector<double>& z)
+{
+    fdlibm_expm1_n(z.data(), z.data(), lmi::ssize(z));
+}
+
+void log1p_in_place(std::vector<double>& z)
+{
+    fdlibm_log1p_n(z.data(), z.data(), lmi::ssize(z));
+}
 } // namespace lmi
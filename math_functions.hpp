@@ -24,7 +24,7 @@
 
 #include "config.hpp"
 
-#include <algorithm>                    // max(), min(), transform()
+#include <algorithm>                    // any_of(), max(), min(), transform()
 #include <cmath>                        // fabs(), signbit()
 #include <limits>
 #include <numeric>                      // midpoint(), partial_sum()
@@ -40,6 +40,27 @@ namespace lmi
      double log1p(     double z);
 long double expm1(long double z);
 long double log1p(long double z);
+
+/// Elementwise expm1() and log1p(), in place.
+///
+/// The 'double' overloads use vectorized kernels whose results are
+/// bit-identical to those of the scalar functions. Others merely
+/// apply the scalar functions to each element.
+
+void expm1_in_place(std::vector<double>& z);
+void log1p_in_place(std::vector<double>& z);
+
+template<typename T>
+void expm1_in_place(std::vector<T>& z)
+{
+    for(auto& i : z) {i = expm1(i);}
+}
+
+template<typename T>
+void log1p_in_place(std::vector<T>& z)
+{
+    for(auto& i : z) {i = log1p(i);}
+}
 } // namespace lmi
 
 // TODO ?? Write functions here for other refactorable uses of
@@ -223,6 +244,11 @@ constexpr std::make_unsigned_t<T> u_abs(T t)
 // applying the transformation
 //   (1+i)^n - 1 <-> expm1(log1p(i) * n)
 // to naive power-based formulas.
+//
+// Most of these functions are often applied to every element of a
+// vector, so they provide overloads that take a whole vector, which
+// use lmi::expm1_in_place() and lmi::log1p_in_place(). Results are
+// identical to those of the scalar overloads.
 
 template<typename T, int n>
 struct i_upper_n_over_n_from_i
@@ -244,6 +270,18 @@ struct i_upper_n_over_n_from_i
         // naively:    (1+i)^(1/n) - 1
         return lmi::expm1(lmi::log1p(i) / n);
         }
+    std::vector<T> operator()(std::vector<T> i) const
+        {
+        if(std::any_of(i.begin(), i.end(), [](T t) {return t < -1.0;}))
+            {
+            throw std::domain_error("i is less than -100%.");
+            }
+
+        lmi::log1p_in_place(i);
+        for(auto& j : i) {j = j / n;}
+        lmi::expm1_in_place(i);
+        return i;
+        }
 };
 
 template<typename T>
@@ -256,6 +294,10 @@ struct i_upper_12_over_12_from_i
         {
         return i_upper_n_over_n_from_i<T,12>()(i);
         }
+    std::vector<T> operator()(std::vector<T> const& i) const
+        {
+        return i_upper_n_over_n_from_i<T,12>()(i);
+        }
 };
 
 template<typename T, int n>
@@ -268,6 +310,13 @@ struct i_from_i_upper_n_over_n
         // naively:    (1+i)^n - 1
         return lmi::expm1(lmi::log1p(i) * n);
         }
+    std::vector<T> operator()(std::vector<T> i) const
+        {
+        lmi::log1p_in_place(i);
+        for(auto& j : i) {j = j * n;}
+        lmi::expm1_in_place(i);
+        return i;
+        }
 };
 
 template<typename T>
@@ -278,6 +327,10 @@ struct i_from_i_upper_12_over_12
         {
         return i_from_i_upper_n_over_n<T,12>()(i);
         }
+    std::vector<T> operator()(std::vector<T> const& i) const
+        {
+        return i_from_i_upper_n_over_n<T,12>()(i);
+        }
 };
 
 template<typename T, int n>
@@ -300,6 +353,27 @@ struct d_upper_n_from_i
         // naively:    n * (1 - (1+i)^(-1/n))
         return -n * lmi::expm1(lmi::log1p(i) / -n);
         }
+    std::vector<T> operator()(std::vector<T> i) const
+        {
+        for(auto const& j : i)
+            {
+            if(j < -1.0)
+                {
+                throw std::domain_error("i is less than -100%.");
+                }
+
+            if(-1.0 == j)
+                {
+                throw std::range_error("i equals -100%.");
+                }
+            }
+
+        lmi::log1p_in_place(i);
+        for(auto& j : i) {j = j / -n;}
+        lmi::expm1_in_place(i);
+        for(auto& j : i) {j = -n * j;}
+        return i;
+        }
 };
 
 template<typename T>
@@ -310,6 +384,10 @@ struct d_upper_12_from_i
         {
         return d_upper_n_from_i<T,12>()(i);
         }
+    std::vector<T> operator()(std::vector<T> const& i) const
+        {
+        return d_upper_n_from_i<T,12>()(i);
+        }
 };
 
 /// Annual net from annual gross rate, with two different kinds of
@@ -404,6 +482,64 @@ struct coi_rate_from_q
             return std::min(max_coi, monthly_q);
             }
         }
+    std::vector<T> operator()
+        (std::vector<T> const& q
+        ,std::vector<T> const& max_coi
+        ) const
+        {
+        if(q.size() != max_coi.size())
+            {
+            throw std::runtime_error("Vector arguments are of unequal length.");
+            }
+
+        for(typename std::vector<T>::size_type j = 0; j < q.size(); ++j)
+            {
+            if(!(0.0 <= max_coi[j] && max_coi[j] <= 1.0))
+                {
+                throw std::runtime_error("Maximum COI rate out of range.");
+                }
+
+            if(q[j] < 0.0)
+                {
+                throw std::domain_error("q is negative.");
+                }
+            }
+
+        // Transform every element, even where the result is to be
+        // ignored, so that whole vectors are passed to the kernels.
+        std::vector<T> z(q.size());
+        std::transform(q.begin(), q.end(), z.begin(), [](T t) {return -t;});
+        lmi::log1p_in_place(z);
+        for(auto& j : z) {j = j / 12;}
+        lmi::expm1_in_place(z);
+
+        for(typename std::vector<T>::size_type j = 0; j < q.size(); ++j)
+            {
+            if(0.0 == q[j])
+                {
+                z[j] = 0.0;
+                }
+            else if(1.0 <= q[j])
+                {
+                z[j] = max_coi[j];
+                }
+            else
+                {
+                T monthly_q = -z[j];
+                if(T(1) == monthly_q)
+                    {
+                    throw std::logic_error("Monthly q equals unity.");
+                    }
+                monthly_q = monthly_q / (T(1) - monthly_q);
+                z[j] = std::min(max_coi[j], monthly_q);
+                }
+            }
+        return z;
+        }
+    std::vector<T> operator()(std::vector<T> const& q, T max_coi) const
+        {
+        return (*this)(q, std::vector<T>(q.size(), max_coi));
+        }
 };
 
 /// Midpoint for illustration reg.
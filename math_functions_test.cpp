@@ -27,17 +27,22 @@
 #include "fenv_lmi.hpp"
 #include "materially_equal.hpp"
 #include "miscellany.hpp"               // stifle_unused_warning()
+#include "ssize_lmi.hpp"
 #include "test_tools.hpp"
 #include "timer.hpp"
 
-#include <algorithm>                    // min()
+#include <algorithm>                    // min(), transform()
+#include <bit>                          // bit_cast()
 #include <cfloat>                       // DBL_EPSILON
 #include <climits>                      // CHAR_BIT
 #include <cmath>                        // fabs(), isnan(), pow()
 #include <cstdint>
 #include <iomanip>
 #include <limits>
+#include <random>
+#include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 // Some of these tests may raise hardware exceptions. That means that
 // edge cases are tested, not that the code tested is invalid for
@@ -263,6 +268,44 @@ void mete9()
     stifle_unused_warning(x);
 }
 
+// These 'mete1[01]' functions convert a vector of annual rates to
+// monthly, element by element and all at once.
+
+std::vector<double> const annual_rates = []
+    {
+    std::vector<double> z(1000);
+    for(int j = 0; j < lmi::ssize(z); ++j)
+        {
+        z[j] = 0.0001 * (j % 300);
+        }
+    return z;
+    }();
+
+void mete10()
+{
+    std::vector<double> x(annual_rates.size());
+    for(int j = 0; j < 100; ++j)
+        {
+        std::transform
+            (annual_rates.begin()
+            ,annual_rates.end()
+            ,x.begin()
+            ,i_upper_12_over_12_from_i<double>()
+            );
+        }
+    stifle_unused_warning(x);
+}
+
+void mete11()
+{
+    std::vector<double> x;
+    for(int j = 0; j < 100; ++j)
+        {
+        x = i_upper_12_over_12_from_i<double>()(annual_rates);
+        }
+    stifle_unused_warning(x);
+}
+
 void test_assign_midpoint()
 {
     constexpr double smallnum = std::numeric_limits<double>::denorm_min();
@@ -845,9 +888,161 @@ void assay_speed()
     std::cout << "  std::expm1()     " << TimeAnAliquot(mete7) << '\n';
     std::cout << "  lmi::log1p()     " << TimeAnAliquot(mete8) << '\n';
     std::cout << "  std::log1p()     " << TimeAnAliquot(mete9) << '\n';
+    std::cout << "  i12 elementwise  " << TimeAnAliquot(mete10) << '\n';
+    std::cout << "  i12 vector       " << TimeAnAliquot(mete11) << '\n';
     std::cout << std::flush;
 }
 
+/// Test batch expm1() and log1p() against their scalar counterparts.
+///
+/// Results must be bit-identical, so that vectorizing calculations
+/// cannot change any regression-test output. Arguments are drawn from
+/// ranges where rates usually lie, and from the whole binary64 space,
+/// with many edge cases, so that both the vectorized path and the
+/// scalar fallback are exercised, as well as the boundary between
+/// them.
+
+void test_batch_expm1_log1p()
+{
+    std::mt19937_64 engine(20220601);
+    std::uniform_real_distribution<double> rate(-1.0, 1.0);
+    std::vector<double> const edges
+        {0.0, -0.0, 1.0, -1.0, 0.5, -0.5
+        ,0.34657359027997264, -0.34657359027997264 // 0.5 ln2
+        ,0.41421356237309503, -0.29289321881345248 // sqrt(2)-1, 1-sqrt(1/2)
+        ,0x1p-29, -0x1p-29, 0x1p-54, -0x1p-54
+        ,709.78, -709.78, 38.9, -38.9
+        ,std::numeric_limits<double>::denorm_min()
+        ,std::numeric_limits<double>::max()
+        ,std::numeric_limits<double>::infinity()
+        ,-std::numeric_limits<double>::infinity()
+        ,std::numeric_limits<double>::quiet_NaN()
+        };
+
+    std::vector<double> x;
+    for(int j = 0; j < 1 << 20; ++j)
+        {
+        std::uint64_t const u = engine();
+        switch(u % 4)
+            {
+            case 0: x.push_back(rate(engine));                    break;
+            case 1: x.push_back(0.1 * rate(engine));              break;
+            case 2: x.push_back(std::bit_cast<double>(engine()));   break;
+            case 3:
+                {
+                // An edge case, or one of its near neighbors.
+                std::uint64_t const e = std::bit_cast<std::uint64_t>
+                    (edges[(u >> 8) % edges.size()]);
+                std::uint64_t const offset = (u >> 32) % 5;
+                x.push_back(std::bit_cast<double>(e + offset - 2));
+                }
+                break;
+            }
+        }
+
+    auto const same_bits = [](double a, double b)
+        {
+        return
+               std::bit_cast<std::uint64_t>(a) == std::bit_cast<std::uint64_t>(b)
+            || (std::isnan(a) && std::isnan(b))
+            ;
+        };
+
+    std::vector<double> expm1_x(x);
+    std::vector<double> log1p_x(x);
+    lmi::expm1_in_place(expm1_x);
+    lmi::log1p_in_place(log1p_x);
+    int e_mismatches {0};
+    int l_mismatches {0};
+    for(int j = 0; j < lmi::ssize(x); ++j)
+        {
+        e_mismatches += !same_bits(lmi::expm1(x[j]), expm1_x[j]);
+        l_mismatches += !same_bits(lmi::log1p(x[j]), log1p_x[j]);
+        }
+    LMI_TEST_EQUAL(0, e_mismatches);
+    LMI_TEST_EQUAL(0, l_mismatches);
+
+    // Lengths that are not multiples of any block or vector size.
+    for(int n : {0, 1, 2, 3, 63, 64, 65, 129})
+        {
+        std::vector<double> v(x.begin(), x.begin() + n);
+        lmi::expm1_in_place(v);
+        bool all_same = true;
+        for(int j = 0; j < n; ++j)
+            {
+            all_same = all_same && same_bits(lmi::expm1(x[j]), v[j]);
+            }
+        LMI_TEST(all_same);
+        }
+
+    // Vector overloads of rate conversions match scalar overloads.
+    std::vector<double> i;
+    std::vector<double> q;
+    std::vector<double> max_coi;
+    for(int j = 0; j < 10000; ++j)
+        {
+        i      .push_back(0.5 * std::fabs(rate(engine)));
+        q      .push_back(std::fabs(rate(engine)));
+        max_coi.push_back(std::fabs(rate(engine)));
+        }
+    q[0] = 0.0;
+    q[1] = 1.0;
+    q[2] = 1.25;
+    i[0] = -1.0;
+
+    std::vector<double> const i12  = i_upper_12_over_12_from_i<double>()(i);
+    std::vector<double> const i1   = i_from_i_upper_12_over_12<double>()(i);
+    std::vector<double> const coi0 = coi_rate_from_q<double>()(q, max_coi);
+    std::vector<double> const coi1 = coi_rate_from_q<double>()(q, 0.083);
+    bool all_same = true;
+    for(int j = 0; j < lmi::ssize(i); ++j)
+        {
+        all_same = all_same
+            && same_bits(i_upper_12_over_12_from_i<double>()(i[j]), i12[j])
+            && same_bits(i_from_i_upper_12_over_12<double>()(i[j]), i1 [j])
+            && same_bits(coi_rate_from_q<double>()(q[j], max_coi[j]), coi0[j])
+            && same_bits(coi_rate_from_q<double>()(q[j], 0.083     ), coi1[j])
+            ;
+        }
+    LMI_TEST(all_same);
+
+    i[0] = 0.0;
+    std::vector<double> const d12 = d_upper_12_from_i<double>()(i);
+    all_same = true;
+    for(int j = 0; j < lmi::ssize(i); ++j)
+        {
+        all_same = all_same && same_bits(d_upper_12_from_i<double>()(i[j]), d12[j]);
+        }
+    LMI_TEST(all_same);
+
+    // Vector overloads validate arguments as scalar overloads do.
+    LMI_TEST_THROW
+        (i_upper_12_over_12_from_i<double>()(std::vector<double> {0.0, -1.5})
+        ,std::domain_error
+        ,"i is less than -100%."
+        );
+    LMI_TEST_THROW
+        (d_upper_12_from_i<double>()(std::vector<double> {0.0, -1.0})
+        ,std::range_error
+        ,"i equals -100%."
+        );
+    LMI_TEST_THROW
+        (coi_rate_from_q<double>()(std::vector<double> {0.1, -0.1}, 1.0)
+        ,std::domain_error
+        ,"q is negative."
+        );
+    LMI_TEST_THROW
+        (coi_rate_from_q<double>()(std::vector<double> {0.1}, 1.5)
+        ,std::runtime_error
+        ,"Maximum COI rate out of range."
+        );
+    LMI_TEST_THROW
+        (coi_rate_from_q<double>()(q, std::vector<double> {0.1})
+        ,std::runtime_error
+        ,"Vector arguments are of unequal length."
+        );
+}
+
 int test_main(int, char*[])
 {
     std::cout << LMI_CONTEXT << '\n' << std::endl;
@@ -874,6 +1069,8 @@ int test_main(int, char*[])
 
     test_expm1_log1p();
 
+    test_batch_expm1_log1p();
+
     sample_results();
 
     assay_speed();
@@ -61,6 +61,7 @@ template<typename T>
 mc_enum<T>& mc_enum<T>::operator=(T t)
 {
     value_ = t;
+    note_change();
     return *this;
 }
 
@@ -68,6 +69,7 @@ template<typename T>
 mc_enum<T>& mc_enum<T>::operator=(std::string const& s)
 {
     value_ = e()[ordinal(s)];
+    note_change();
     return *this;
 }
 
@@ -149,6 +151,7 @@ void mc_enum<T>::enforce_proscription()
     if(z < cardinality())
         {
         value_ = e()[z];
+        note_change();
         }
 }
 
@@ -254,6 +257,7 @@ std::istream& mc_enum<T>::read(std::istream& is)
         throw "Unreachable.";
         }
     value_ = e()[v];
+    note_change();
 
     return is;
 }
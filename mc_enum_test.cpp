@@ -37,12 +37,14 @@ struct mc_enum_test
 {
     static void test();
     static void test_product_name();
+    static void test_revisions();
 };
 
 int test_main(int, char*[])
 {
     mc_enum_test::test();
     mc_enum_test::test_product_name();
+    mc_enum_test::test_revisions();
     return 0;
 }
 
@@ -236,3 +238,25 @@ void mc_enum_test::test_product_name()
         ,"Value 'invalid product' invalid for type 'ce_product_name'."
         );
 }
+
+void mc_enum_test::test_revisions()
+{
+    e_holiday holiday(h_Easter);
+    LMI_TEST_EQUAL(0U, holiday.revision());
+    holiday = h_Easter;
+    LMI_TEST_EQUAL(1U, holiday.revision());
+    holiday = "Pentecost";
+    LMI_TEST_EQUAL(2U, holiday.revision());
+
+    // Enforcing proscription changes the value only if necessary.
+    holiday.enforce_proscription();
+    LMI_TEST_EQUAL(2U, holiday.revision());
+    holiday.allow(holiday.ordinal(), false);
+    holiday.enforce_proscription();
+    LMI_TEST_EQUAL(3U, holiday.revision());
+    LMI_TEST_EQUAL("Theophany", holiday);
+
+    e_holiday other;
+    other = holiday;
+    LMI_TEST_EQUAL(1U, other.revision());
+}
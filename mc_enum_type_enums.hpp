@@ -56,6 +56,7 @@ enum mcenum_emission
     ,mce_emit_group_quote              =  8192 // GUI only.
     ,mce_emit_calculation_summary_html = 16384
     ,mce_emit_calculation_summary_tsv  = 32768
+    ,mce_emit_test_snapshot            = 65536
     };
 
 /// Rounding styles.
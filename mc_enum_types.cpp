@@ -70,6 +70,7 @@ extern mcenum_emission const emission_enums[] =
     ,mce_emit_group_quote
     ,mce_emit_calculation_summary_html
     ,mce_emit_calculation_summary_tsv
+    ,mce_emit_test_snapshot
     };
 extern char const*const emission_strings[] =
     {"emit_nothing"
@@ -89,9 +90,10 @@ extern char const*const emission_strings[] =
     ,"emit_group_quote"
     ,"emit_calculation_summary_html"
     ,"emit_calculation_summary_tsv"
+    ,"emit_test_snapshot"
     };
 template<> struct mc_enum_key<mcenum_emission>
-  :public mc_enum_data<mcenum_emission, 17, emission_enums, emission_strings> {};
+  :public mc_enum_data<mcenum_emission, 18, emission_enums, emission_strings> {};
 template class mc_enum<mcenum_emission>;
 
 extern rounding_style const rounding_style_enums[] =
@@ -24,6 +24,7 @@
 #include "assert_lmi.hpp"
 #include "md5.hpp"
 #include "md5sum.hpp"
+#include "ssize_lmi.hpp"
 
 #include <cstddef>                      // size_t
 #include <fstream>
@@ -212,6 +213,34 @@ std::string md5_calculate_file_checksum
     return md5_calculate_stream_checksum(is, filename_string);
 }
 
+std::string md5_hmac_hex_string(std::string const& key, std::string const& message)
+{
+    constexpr int block_size = 64;
+
+    std::vector<unsigned char> sum(md5len);
+    std::string k = key;
+    if(block_size < lmi::ssize(k))
+        {
+        md5_buffer(k.data(), k.size(), sum.data());
+        k.assign(sum.begin(), sum.end());
+        }
+    k.resize(block_size, '\0');
+
+    std::string inner(k);
+    std::string outer(k);
+    for(int j = 0; j < block_size; ++j)
+        {
+        inner[j] = static_cast<char>(inner[j] ^ 0x36);
+        outer[j] = static_cast<char>(outer[j] ^ 0x5c);
+        }
+
+    inner += message;
+    md5_buffer(inner.data(), inner.size(), sum.data());
+    outer.append(sum.begin(), sum.end());
+    md5_buffer(outer.data(), outer.size(), sum.data());
+    return md5_hex_string(sum);
+}
+
 std::string md5_hex_string(std::vector<unsigned char> const& vuc)
 {
     LMI_ASSERT(md5len == vuc.size());
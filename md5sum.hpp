@@ -113,4 +113,8 @@ std::string md5_calculate_file_checksum
 
 std::string md5_hex_string(std::vector<unsigned char> const&);
 
+/// HMAC-MD5 (RFC 2104) of a message with a key, in hex.
+
+std::string md5_hmac_hex_string(std::string const& key, std::string const& message);
+
 #endif // md5sum_hpp
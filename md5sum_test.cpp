@@ -114,6 +114,7 @@ class MD5SumTest
     void TestMD5Calculation() const;
     void TestMD5Reading() const;
     void TestMD5ToHexString() const;
+    void TestHMAC() const;
 
   private:
     void RemoveTestFilesIfNecessary(char const* file, int line) const;
@@ -260,6 +261,28 @@ void MD5SumTest::TestMD5ToHexString() const
     LMI_TEST_EQUAL("0f1e2d3c4b5a69788796a5b4c3d2e1f0", md5_hex_string(v));
 }
 
+/// Test md5_hmac_hex_string function with RFC 2202 test cases.
+
+void MD5SumTest::TestHMAC() const
+{
+    LMI_TEST_EQUAL
+        ("9294727a3638bb1c13f48ef8158bfc9d"
+        ,md5_hmac_hex_string(std::string(16, '\x0b'), "Hi There")
+        );
+    LMI_TEST_EQUAL
+        ("750c783e6ab0b503eaa86e310a5db738"
+        ,md5_hmac_hex_string("Jefe", "what do ya want for nothing?")
+        );
+    // A key longer than one block is hashed first.
+    LMI_TEST_EQUAL
+        ("6b1ab7fe4bd7bf8f0b62e6ce61b9d0cd"
+        ,md5_hmac_hex_string
+            (std::string(80, '\xaa')
+            ,"Test Using Larger Than Block-Size Key - Hash Key First"
+            )
+        );
+}
+
 void MD5SumTest::RemoveTestFilesIfNecessary(char const* file, int line) const
 {
     auto const RemoveIfNecessary = [file, line](char const* filename)
@@ -320,6 +343,7 @@ int test_main(int, char*[])
     tester.TestMD5Calculation();
     tester.TestMD5Reading();
     tester.TestMD5ToHexString();
+    tester.TestHMAC();
 
     return EXIT_SUCCESS;
 }
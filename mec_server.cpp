@@ -164,7 +164,7 @@ mec_state test_one_days_7702A_transactions
     double max_coi_rate = database.query<double>(DB_MaxMonthlyCoiRate);
     LMI_ASSERT(0.0 != max_coi_rate);
     max_coi_rate = 1.0 / max_coi_rate;
-    assign(Mly7702qc, apply_binary(coi_rate_from_q<double>(), Mly7702qc, max_coi_rate));
+    Mly7702qc = coi_rate_from_q<double>()(Mly7702qc, max_coi_rate);
 
     i7702 const i7702_(database, stratified);
     ULCommFns commfns
@@ -175,14 +175,15 @@ mec_state test_one_days_7702A_transactions
         ,mce_monthly
         );
 
-    std::vector<double> analytic_Ax(input.years_to_maturity());
-    analytic_Ax += (commfns.aDomega() + commfns.kM()) / commfns.aD();
-
     std::vector<double> E7aN(commfns.aN());
     E7aN.insert(E7aN.end(), 7, 0.0);
     E7aN.erase(E7aN.begin(), 7 + E7aN.begin());
+    std::vector<double> analytic_Ax (input.years_to_maturity());
     std::vector<double> analytic_7Px(input.years_to_maturity());
-    analytic_7Px += (commfns.aDomega() + commfns.kM()) / (commfns.aN() - E7aN);
+    Fuse
+        (Deferred(analytic_Ax , OpAddAssign(), (commfns.aDomega() + commfns.kM()) / commfns.aD())
+        ,Deferred(analytic_7Px, OpAddAssign(), (commfns.aDomega() + commfns.kM()) / (commfns.aN() - E7aN))
+        );
 
     std::vector<double> const& chosen_Ax  = Use7702ATables ? tabular_Ax  : analytic_Ax ;
     std::vector<double> const& chosen_7Px = Use7702ATables ? tabular_7Px : analytic_7Px;
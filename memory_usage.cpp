@@ -0,0 +1,179 @@
+// Measure memory usage.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "memory_usage.hpp"
+
+#include <atomic>
+#include <cstdlib>                      // free(), malloc()
+#include <iomanip>                      // setprecision()
+#include <new>                          // bad_alloc
+#include <sstream>
+
+#if defined LMI_POSIX && (defined __linux__ || defined __APPLE__)
+#   include <sys/resource.h>            // getrusage()
+#endif // defined LMI_POSIX && (defined __linux__ || defined __APPLE__)
+
+#if defined __GLIBC__ || defined LMI_MSW
+#   include <malloc.h>                  // malloc_usable_size(), _msize()
+#endif // defined __GLIBC__ || defined LMI_MSW
+
+namespace
+{
+thread_local heap_usage this_thread_usage;
+
+std::atomic<bool> counting {false};
+
+/// Size of a block allocated by malloc(), or zero if unknown.
+
+std::int64_t block_size(void* p)
+{
+#if defined __GLIBC__
+    return static_cast<std::int64_t>(::malloc_usable_size(p));
+#elif defined LMI_MSW
+    return static_cast<std::int64_t>(::_msize(p));
+#else  // Unknown C library.
+    return 0;
+#endif // Unknown C library.
+}
+
+} // Unnamed namespace.
+
+/// Whether allocations are counted--i.e., whether this program links
+/// the operators in 'counting_new.cpp', and has used them.
+
+bool heap_usage_is_counted()
+{
+    return counting.load(std::memory_order_relaxed);
+}
+
+/// Allocations made, and bytes allocated but not freed, by the
+/// calling thread since it started.
+///
+/// Bytes freed by a thread other than the one that allocated them
+/// are subtracted from the freeing thread's total, which therefore
+/// may be negative. Only differences between values obtained on the
+/// same thread are meaningful.
+
+heap_usage this_thread_heap_usage()
+{
+    return this_thread_usage;
+}
+
+/// Allocations made by the calling thread since the given usage was
+/// obtained on the same thread.
+
+std::uint64_t allocations_since(heap_usage const& earlier)
+{
+    return this_thread_usage.allocations - earlier.allocations;
+}
+
+/// Usage by the calling thread since the given usage was obtained on
+/// the same thread.
+
+heap_usage heap_usage_since(heap_usage const& earlier)
+{
+    return
+        {this_thread_usage.allocations - earlier.allocations
+        ,this_thread_usage.live_bytes  - earlier.live_bytes
+        };
+}
+
+/// Attribute to the calling thread usage measured on another thread
+/// that did work on its behalf, so that the calling thread's counts
+/// include that work.
+
+void add_to_this_thread_heap_usage(heap_usage const& z)
+{
+    this_thread_usage.allocations += z.allocations;
+    this_thread_usage.live_bytes  += z.live_bytes;
+}
+
+/// Allocate memory with malloc(), counting the allocation and its
+/// size for the calling thread. For replacements of operator new().
+
+void* counted_allocation(std::size_t size)
+{
+    // malloc(0) may return a null pointer, but operator new() must not.
+    void* p = std::malloc(0 == size ? 1 : size);
+    if(!p)
+        {
+        throw std::bad_alloc();
+        }
+    if(!counting.load(std::memory_order_relaxed))
+        {
+        counting.store(true, std::memory_order_relaxed);
+        }
+    ++this_thread_usage.allocations;
+    this_thread_usage.live_bytes += block_size(p);
+    return p;
+}
+
+/// Free memory obtained from counted_allocation(), subtracting its
+/// size from the calling thread's count. For replacements of operator
+/// delete().
+
+void counted_deallocation(void* p) noexcept
+{
+    if(p)
+        {
+        this_thread_usage.live_bytes -= block_size(p);
+        std::free(p);
+        }
+}
+
+/// Peak resident set size of this process, or zero if unknown.
+///
+/// POSIX doesn't specify the units of 'ru_maxrss'. Linux reports
+/// kibibytes, and macOS bytes; other platforms are not trusted.
+
+std::uint64_t peak_resident_bytes()
+{
+#if defined LMI_POSIX && (defined __linux__ || defined __APPLE__)
+    rusage r {};
+    if(0 == ::getrusage(RUSAGE_SELF, &r) && 0 < r.ru_maxrss)
+        {
+#   if defined __linux__
+        return 1024 * static_cast<std::uint64_t>(r.ru_maxrss);
+#   else  // defined __APPLE__
+        return static_cast<std::uint64_t>(r.ru_maxrss);
+#   endif // defined __APPLE__
+        }
+#endif // defined LMI_POSIX && (defined __linux__ || defined __APPLE__)
+    return 0;
+}
+
+/// Format a number of bytes in binary units, e.g., "1.5 MiB".
+
+std::string memory_str(double bytes)
+{
+    char const* const units[] {"bytes", "KiB", "MiB", "GiB", "TiB"};
+    int j = 0;
+    for(; 1024.0 <= bytes && j < 4; ++j)
+        {
+        bytes /= 1024.0;
+        }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(0 == j ? 0 : 1) << bytes << ' ' << units[j];
+    return oss.str();
+}
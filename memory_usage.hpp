@@ -0,0 +1,95 @@
+// Measure memory usage.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#ifndef memory_usage_hpp
+#define memory_usage_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <cstddef>                      // size_t
+#include <cstdint>
+#include <string>
+
+/// Memory used by this process, for diagnosing excessive use.
+///
+/// A program that links 'counting_new.o' replaces the global operator
+/// new() and operator delete() with versions that count, for each
+/// thread separately, the number of allocations and the number of
+/// bytes allocated and freed; 'lmi_cli' does, and other programs need
+/// not bear the cost. Counting per thread costs little, because no
+/// thread waits for another, and lets a phase of work that is
+/// performed on one thread be measured even while other threads are
+/// busy. Only memory obtained through those operators, from modules
+/// that link to them, is counted: on msw, for instance, each dll has
+/// its own operators. In a program that doesn't link them, every
+/// count is zero, and heap_usage_is_counted() returns false.
+///
+/// Byte counts are the sizes that the C library reports for blocks
+/// it allocates, which may exceed the sizes requested. Where the C
+/// library cannot report them, they are zero.
+
+struct heap_usage
+{
+    std::uint64_t allocations {0};
+    std::int64_t  live_bytes  {0};
+};
+
+LMI_SO bool heap_usage_is_counted();
+
+LMI_SO heap_usage this_thread_heap_usage();
+
+LMI_SO std::uint64_t allocations_since(heap_usage const&);
+
+LMI_SO heap_usage heap_usage_since(heap_usage const&);
+
+LMI_SO void add_to_this_thread_heap_usage(heap_usage const&);
+
+LMI_SO std::uint64_t peak_resident_bytes();
+
+LMI_SO std::string memory_str(double bytes);
+
+/// Estimate an object's memory footprint: its own size, plus heap
+/// memory allocated by copying it.
+///
+/// This is exact for an object that owns all the memory it refers
+/// to; it is too low for one that shares memory with other objects,
+/// because a copy shares that memory too.
+
+LMI_SO void* counted_allocation(std::size_t);
+
+LMI_SO void counted_deallocation(void*) noexcept;
+
+template<typename T>
+std::int64_t copy_footprint(T const& t)
+{
+    heap_usage const before = this_thread_heap_usage();
+    T const copy(t);
+    return
+          static_cast<std::int64_t>(sizeof copy)
+        + this_thread_heap_usage().live_bytes
+        - before.live_bytes
+        ;
+}
+
+#endif // memory_usage_hpp
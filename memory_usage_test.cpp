@@ -0,0 +1,119 @@
+// Measure memory usage--unit test.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "memory_usage.hpp"
+
+#include "test_tools.hpp"
+
+#include <cstdint>
+#include <memory>                       // make_unique()
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+std::int64_t const vector_bytes {1000 * sizeof(double)};
+} // Unnamed namespace.
+
+void test_counting()
+{
+    heap_usage const before = this_thread_heap_usage();
+    auto p = std::make_unique<std::vector<double>>(1000);
+    heap_usage const during = this_thread_heap_usage();
+    LMI_TEST_EQUAL(2U, during.allocations - before.allocations);
+#if defined __GLIBC__ || defined LMI_MSW
+    LMI_TEST(vector_bytes < during.live_bytes - before.live_bytes);
+#endif // defined __GLIBC__ || defined LMI_MSW
+
+    p.reset();
+    heap_usage const after = this_thread_heap_usage();
+    LMI_TEST_EQUAL(2U, after.allocations - before.allocations);
+    LMI_TEST_EQUAL(before.live_bytes, after.live_bytes);
+
+    // Other threads' allocations are not counted...
+    heap_usage other;
+    std::thread t
+        ([&other, &p]
+            {
+            heap_usage const start = this_thread_heap_usage();
+            p = std::make_unique<std::vector<double>>(1000);
+            other = heap_usage_since(start);
+            }
+        );
+    heap_usage const started = this_thread_heap_usage();
+    t.join();
+    heap_usage const joined = this_thread_heap_usage();
+    LMI_TEST_EQUAL(started.live_bytes, joined.live_bytes);
+    LMI_TEST_EQUAL(2U, other.allocations);
+
+    // ...unless they are attributed to this thread.
+    add_to_this_thread_heap_usage(other);
+    p.reset();
+    heap_usage const attributed = this_thread_heap_usage();
+    LMI_TEST_EQUAL(2U, attributed.allocations - joined.allocations);
+    LMI_TEST_EQUAL(joined.live_bytes, attributed.live_bytes);
+    LMI_TEST(heap_usage_is_counted());
+}
+
+void test_footprint()
+{
+    std::vector<double> const v(1000);
+    std::int64_t const size_of_v {sizeof v};
+    LMI_TEST(size_of_v < copy_footprint(v));
+#if defined __GLIBC__ || defined LMI_MSW
+    LMI_TEST(size_of_v + vector_bytes <= copy_footprint(v));
+#endif // defined __GLIBC__ || defined LMI_MSW
+
+    // A short string needs no heap memory.
+    std::string const s("x");
+    std::int64_t const size_of_s {sizeof s};
+    LMI_TEST_EQUAL(size_of_s, copy_footprint(s));
+}
+
+void test_peak_resident_bytes()
+{
+#if defined LMI_POSIX
+    LMI_TEST(0 < peak_resident_bytes());
+#endif // defined LMI_POSIX
+}
+
+void test_memory_str()
+{
+    LMI_TEST_EQUAL("0 bytes"  , memory_str(0.0));
+    LMI_TEST_EQUAL("1023 bytes", memory_str(1023.0));
+    LMI_TEST_EQUAL("1.0 KiB"  , memory_str(1024.0));
+    LMI_TEST_EQUAL("1.5 MiB"  , memory_str(1.5 * 1024.0 * 1024.0));
+    LMI_TEST_EQUAL("2.0 GiB"  , memory_str(2.0 * 1024.0 * 1024.0 * 1024.0));
+}
+
+int test_main(int, char*[])
+{
+    test_counting();
+    test_footprint();
+    test_peak_resident_bytes();
+    test_memory_str();
+
+    return 0;
+}
@@ -26,15 +26,19 @@
 #include "alert.hpp"
 #include "assert_lmi.hpp"
 #include "data_directory.hpp"           // AddDataDir()
+#include "parallel_for.hpp"
 #include "ssize_lmi.hpp"
 #include "value_cast.hpp"
 #include "xml_lmi.hpp"
+#include "xsd_validator.hpp"
 
 #include <xmlwrapp/document.h>
 #include <xmlwrapp/nodes_view.h>
 #include <xmlwrapp/schema.h>
 #include <xsltwrapp/stylesheet.h>
 
+#include <algorithm>                    // min()
+#include <atomic>
 #include <iomanip>
 #include <istream>
 #include <ostream>
@@ -70,6 +74,25 @@ multiple_cell_document::multiple_cell_document(std::string const& filename)
     parse(parser);
 }
 
+/// Construct from case, class, and cell parameters.
+///
+/// Motivation: to write a census assembled elsewhere, e.g., by
+/// importing tab-delimited data.
+///
+/// Postconditions: asserted by assert_vector_sizes_are_sane().
+
+multiple_cell_document::multiple_cell_document
+    (std::vector<Input> const& case_parms
+    ,std::vector<Input> const& class_parms
+    ,std::vector<Input> const& cell_parms
+    )
+    :case_parms_  (case_parms )
+    ,class_parms_ (class_parms)
+    ,cell_parms_  (cell_parms )
+{
+    assert_vector_sizes_are_sane();
+}
+
 /// Verify invariants.
 ///
 /// Throws if any asserted invariant does not hold.
@@ -147,7 +170,8 @@ void multiple_cell_document::parse(xml_lmi::dom_parser const& parser)
         alarum() << "Incompatible file version." << LMI_FLUSH;
         }
 
-    if(data_source_is_external(parser.document()))
+    bool const is_external = data_source_is_external(parser.document());
+    if(is_external)
         {
         status() << "Validating..." << std::flush;
         validate_with_xsd_schema(parser.document(), xsd_schema_name(file_version));
@@ -173,7 +197,7 @@ void multiple_cell_document::parse(xml_lmi::dom_parser const& parser)
         for(auto const& j : subelements)
             {
             j >> cell;
-            if(data_source_is_external(parser.document()))
+            if(is_external)
                 {
                 cell.validate_external_data();
                 cell.Reconcile();
@@ -444,9 +468,18 @@ void multiple_cell_document::validate_with_xsd_schema
     ,std::string const&   xsd
     ) const
 {
-    xml::schema const schema(xml_lmi::dom_parser(AddDataDir(xsd)).document());
+    // Most external files are valid, and the native validator can
+    // confirm that quickly, without sorting a copy of the document.
+    // Any file it rejects is validated again by libxml2, which issues
+    // the customary diagnostics.
+    xsd_validator const* const v = cached_xsd_validator(xsd);
+    if(v && v->validate(xml).empty())
+        {
+        return;
+        }
+
     xml::error_messages errors;
-    if(!schema.validate(cell_sorter().apply(xml), errors))
+    if(!cached_xsd_schema(xsd).validate(cell_sorter().apply(xml), errors))
         {
         warning()
             << "Validation with schema '"
@@ -503,11 +536,108 @@ void multiple_cell_document::read(std::istream const& is)
 /// Write to xml file.
 ///
 /// Calls assert_vector_sizes_are_sane() to assert preconditions.
+///
+/// Cells are formatted directly as text if possible, which is much
+/// faster than building a DOM, and needs far less memory. Otherwise,
+/// they're written through a DOM as before. Either way, the result
+/// is the same.
 
 void multiple_cell_document::write(std::ostream& os) const
 {
     assert_vector_sizes_are_sane();
 
+    if(!write_text(os))
+        {
+        write_dom(os);
+        }
+}
+
+namespace
+{
+/// Format cells as xml text, in parallel chunks.
+///
+/// Returns false, leaving 'chunks' incomplete, if any cell cannot be
+/// formatted as text.
+
+bool format_cells
+    (std::vector<Input> const& cells
+    ,std::vector<std::string>& chunks
+    )
+{
+    int const cells_per_chunk = 64;
+    int const n = lmi::ssize(cells);
+    chunks.resize((n + cells_per_chunk - 1) / cells_per_chunk);
+    std::atomic<bool> okay {true};
+    parallel_for
+        (lmi::ssize(chunks)
+        ,[&](int j)
+            {
+            int const end = std::min(n, (1 + j) * cells_per_chunk);
+            for(int k = j * cells_per_chunk; k < end && okay; ++k)
+                {
+                // Depth 2: under the root, and a grouping element.
+                if(!cells[k].append_xml_text(chunks[j], 2))
+                    {
+                    okay = false;
+                    }
+                }
+            }
+        );
+    return okay;
+}
+} // Unnamed namespace.
+
+/// Write to xml file without a DOM, formatting cells concurrently.
+///
+/// The output is identical to what write_dom() would produce: tested
+/// by 'input_test'. Nothing is written if false is returned, because
+/// some cell cannot be formatted as text.
+
+bool multiple_cell_document::write_text(std::ostream& os) const
+{
+    std::vector<std::string> case_chunks;
+    std::vector<std::string> class_chunks;
+    std::vector<std::string> cell_chunks;
+    if
+        (  !format_cells(case_parms_ , case_chunks )
+        || !format_cells(class_parms_, class_chunks)
+        || !format_cells(cell_parms_ , cell_chunks )
+        )
+        {
+        return false;
+        }
+
+    auto write_group = [&os]
+        (std::string              const& tag
+        ,std::vector<std::string> const& chunks
+        )
+        {
+        os << "  <" << tag << ">\n";
+        for(auto const& i : chunks)
+            {
+            os << i;
+            }
+        os << "  </" << tag << ">\n";
+        };
+
+    os
+        << "<?xml version=\"1.0\"?>\n"
+        << '<' << xml_root_name()
+        << " version=\"" << value_cast<std::string>(class_version()) << '"'
+        << " data_source=\"1\"" // "1" means lmi.
+        << ">\n"
+        ;
+    write_group("case_default"    , case_chunks );
+    write_group("class_defaults"  , class_chunks);
+    write_group("particular_cells", cell_chunks );
+    os << "</" << xml_root_name() << ">\n";
+    return true;
+}
+
+/// Write to xml file through a DOM.
+
+void multiple_cell_document::write_dom(std::ostream& os) const
+{
     xml_lmi::xml_document document(xml_root_name());
     xml::element& root = document.root_node();
     xml_lmi::set_attr(root, "version", class_version());
@@ -85,6 +85,11 @@ class LMI_SO multiple_cell_document final
   public:
     multiple_cell_document();
     multiple_cell_document(std::string const& filename);
+    multiple_cell_document
+        (std::vector<Input> const& case_parms
+        ,std::vector<Input> const& class_parms
+        ,std::vector<Input> const& cell_parms
+        );
     ~multiple_cell_document() = default;
 
     std::vector<Input> const& case_parms() const;
@@ -103,6 +108,9 @@ class LMI_SO multiple_cell_document final
 
     void assert_vector_sizes_are_sane() const;
 
+    bool write_text(std::ostream&) const;
+    void write_dom (std::ostream&) const;
+
     int                class_version() const;
     std::string const& xml_root_name() const;
 
@@ -28,6 +28,7 @@
 #include "assert_lmi.hpp"
 #include "calendar_date.hpp"
 #include "contains.hpp"
+#include "datum_base.hpp"
 #include "global_settings.hpp"
 #include "map_lookup.hpp"
 #include "mc_enum.hpp"
@@ -41,9 +42,18 @@
 
 #include <wx/app.h>                     // wxApp::IsActive()
 #include <wx/checkbox.h>
+#include <wx/checklst.h>
+#include <wx/choice.h>
+#include <wx/combobox.h>
 #include <wx/ctrlsub.h>
 #include <wx/datectrl.h>
+#include <wx/dateevt.h>                 // wxEVT_DATE_CHANGED
+#include <wx/filepicker.h>
+#include <wx/listbox.h>
 #include <wx/radiobox.h>
+#include <wx/radiobut.h>
+#include <wx/slider.h>
+#include <wx/spinbutt.h>
 #include <wx/spinctrl.h>
 #include <wx/textctrl.h>
 #include <wx/utils.h>                   // wxBusyCursor
@@ -87,6 +97,7 @@ MvcController::MvcController
     :model_                               {model}
     ,view_                                {view}
     ,last_focused_window_                 {parent}
+    ,check_mvc_                           {contains(global_settings::instance().pyx(), "check_mvc")}
     ,unit_test_idle_processing_completed_ {false}
     ,unit_test_refocus_event_pending_     {false}
     ,unit_test_under_way_                 {false}
@@ -142,6 +153,7 @@ MvcController::MvcController
         if(FindWindow(wxXmlResource::GetXRCID(i.c_str())))
             {
             Bind(i, transfer_data_[i] = model_.Entity(i).str());
+            changed_names_.insert(i);
             }
         }
 
@@ -179,12 +191,24 @@ void MvcController::Assimilate(std::string const& name_to_ignore)
 
     for(auto const& i : transfer_data_)
         {
-        std::string const& name        = i.first;
-        std::string const& model_value = model_.Entity(name).str();
-        if(name == name_to_ignore || ModelAndViewValuesEquivalent(name))
+        std::string const& name = i.first;
+        if(name == name_to_ignore)
             {
+            consistent_revisions_.erase(name);
             continue;
             }
+        std::uint64_t const revision = ModelReference<datum_base>(name).revision();
+        auto const r = consistent_revisions_.find(name);
+        if(consistent_revisions_.end() != r && revision == r->second)
+            {
+            continue;
+            }
+        consistent_revisions_[name] = revision;
+        if(ModelAndViewValuesEquivalent(name))
+            {
+            continue;
+            }
+        std::string const& model_value = model_.Entity(name).str();
         transfer_data_       [name] = model_value;
         cached_transfer_data_[name] = model_value;
         wxWindow& w = WindowFromXrcName<wxWindow>(name);
@@ -552,6 +576,50 @@ MvcModel const& MvcController::Model() const
     return model_;
 }
 
+std::set<std::string> MvcController::TransferChangedDataFromWindow()
+{
+    std::set<std::string> names;
+    names.swap(changed_names_);
+    for(auto const& i : names)
+        {
+        WindowFromXrcName<wxWindow>(i).GetValidator()->TransferFromWindow();
+        }
+
+    if(check_mvc_)
+        {
+        std::map<std::string,std::string> const announced = transfer_data_;
+        TransferDataFromWindow();
+        for(auto const& i : transfer_data_)
+            {
+            if(i.second != map_lookup(announced, i.first))
+                {
+                warning()
+                    << "Control '"
+                    << i.first
+                    << "' changed to '"
+                    << i.second
+                    << "' without any value-change event."
+                    << LMI_FLUSH
+                    ;
+                names.insert(i.first);
+                }
+            }
+        }
+
+    std::set<std::string> z;
+    for(auto const& i : names)
+        {
+        std::string const& view_value = map_lookup(transfer_data_, i);
+        auto const j = cached_transfer_data_.find(i);
+        if(cached_transfer_data_.end() == j || view_value != j->second)
+            {
+            cached_transfer_data_[i] = view_value;
+            z.insert(i);
+            }
+        }
+    return z;
+}
+
 void MvcController::UpdateCircumscription
     (wxWindow&          control
     ,std::string const& name
@@ -583,14 +651,24 @@ void MvcController::UpdateCircumscription
         }
     else if(datepicker)
         {
+        wxDateTime const value = datepicker->GetValue();
         datepicker->SetRange
             (ConvertDateToWx(jdn_t(minimum_value))
             ,ConvertDateToWx(jdn_t(maximum_value))
             );
+        if(value != datepicker->GetValue())
+            {
+            changed_names_.insert(name);
+            }
         }
     else if(spinctrl)
         {
+        int const value = spinctrl->GetValue();
         spinctrl->SetRange(minimum_value, maximum_value);
+        if(value != spinctrl->GetValue())
+            {
+            changed_names_.insert(name);
+            }
         }
     else
         {
@@ -695,6 +773,28 @@ void MvcController::UponChildFocus(wxChildFocusEvent& event)
         }
 }
 
+/// Mark a control as changed when it announces a new value.
+///
+/// Composite controls such as InputSequenceEntry have a Transferor,
+/// but their constituent controls originate the events, which then
+/// propagate upward; hence the search through ancestors.
+
+void MvcController::UponControlChanged(wxCommandEvent& event)
+{
+    event.Skip();
+
+    wxWindow* w = dynamic_cast<wxWindow*>(event.GetEventObject());
+    for(; w && w != this; w = w->GetParent())
+        {
+        Transferor const* t = dynamic_cast<Transferor const*>(w->GetValidator());
+        if(t)
+            {
+            changed_names_.insert(t->name());
+            return;
+            }
+        }
+}
+
 void MvcController::UponInitDialog(wxInitDialogEvent& event)
 {
     event.Skip();
@@ -730,6 +830,45 @@ void MvcController::UponInitDialog(wxInitDialogEvent& event)
         ,wxXmlResource::GetXRCID(view_.MainDialogName())
         );
 
+    // Every event by which any control that Transferor supports can
+    // announce a change in its value. A wxTextCtrl announces even a
+    // change made by TransferToWindow(); no harm is done, because its
+    // contents are then found not to differ from the cached value.
+    wxEventType const value_change_events[] =
+        {wxEVT_COMMAND_CHECKBOX_CLICKED
+        ,wxEVT_COMMAND_CHECKLISTBOX_TOGGLED
+        ,wxEVT_COMMAND_CHOICE_SELECTED
+        ,wxEVT_COMMAND_COMBOBOX_SELECTED
+        ,wxEVT_COMMAND_DIRPICKER_CHANGED
+        ,wxEVT_COMMAND_FILEPICKER_CHANGED
+        ,wxEVT_COMMAND_LISTBOX_SELECTED
+        ,wxEVT_COMMAND_RADIOBOX_SELECTED
+        ,wxEVT_COMMAND_RADIOBUTTON_SELECTED
+        ,wxEVT_COMMAND_SLIDER_UPDATED
+        ,wxEVT_COMMAND_SPINCTRL_UPDATED
+        ,wxEVT_COMMAND_TEXT_UPDATED
+        ,wxEVT_DATE_CHANGED
+        ,wxEVT_SCROLL_TOP
+        ,wxEVT_SCROLL_BOTTOM
+        ,wxEVT_SCROLL_LINEUP
+        ,wxEVT_SCROLL_LINEDOWN
+        ,wxEVT_SCROLL_PAGEUP
+        ,wxEVT_SCROLL_PAGEDOWN
+        ,wxEVT_SCROLL_THUMBTRACK
+        ,wxEVT_SCROLL_THUMBRELEASE
+        ,wxEVT_SCROLL_CHANGED
+        ,wxEVT_SPIN
+        };
+    for(auto const& i : value_change_events)
+        {
+        ::Connect(this, i, &MvcController::UponControlChanged);
+        }
+
+    if(check_mvc_)
+        {
+        TestModelViewConsistency();
+        }
+
     if(contains(global_settings::instance().pyx(), "show_mvc_dims"))
         {
         int width  = 0;
@@ -805,25 +944,36 @@ void MvcController::UponUpdateUI(wxUpdateUIEvent& event)
     // already been handled. Complex processing of many inputs has
     // been observed to consume excessive CPU time when a malloc
     // debugger is running, so this optimization is significant.
+    // For the same reason, only controls that announced changes
+    // are read.
     //
     // The early-exit condition cannot succeed until Assimilate() has
     // been called: therefore, Assimilate() is guaranteed to be called
     // here by the time the user can interact with the GUI.
-    TransferDataFromWindow();
-    if(cached_transfer_data_ == transfer_data_)
+    std::set<std::string> names = TransferChangedDataFromWindow();
+    if(names.empty())
         {
         unit_test_idle_processing_completed_ = true;
         return;
         }
-    cached_transfer_data_ = transfer_data_;
+
+    // Every other name's View value was made equivalent to its Model
+    // value when changes were last processed.
+    if(!deferred_name_.empty())
+        {
+        names.insert(deferred_name_);
+        }
 
     DiagnosticsWindow().SetLabel("");
     std::vector<std::string> control_changes;
     std::string const name_to_ignore = NameOfControlToDeferEvaluating();
-    for(auto const& i : transfer_data_)
+    deferred_name_ = name_to_ignore;
+    for(auto const& name : names)
         {
-        std::string const& name        = i.first;
-        std::string const& view_value  = i.second;
+        // The View value has changed, so Assimilate() must compare it
+        // even if the Model value does not change.
+        consistent_revisions_.erase(name);
+        std::string const& view_value  = map_lookup(transfer_data_, name);
         std::string const& model_value = model_.Entity(name).str();
         if(name == name_to_ignore || ModelAndViewValuesEquivalent(name))
             {
@@ -28,7 +28,9 @@
 #include <wx/dialog.h>
 #include <wx/stattext.h>
 
+#include <cstdint>                      // uint64_t
 #include <map>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -215,16 +217,21 @@ class MvcView;
 /// Class Transferor, implemented and documented elsewhere, performs
 /// this pairing and implements bidirectional data transfer.
 ///
-/// The Controller essentially polls controls and reacts to changes in
-/// their values. The polling is performed within wx, which generates
-/// wxUpdateUIEvent pseudoevents. The resemblance to an event-driven
-/// style is accidental: a fundamentally event-driven Controller would
-/// need to anticipate all the value-change events that the View might
-/// beget, and would suffer from the problems described above. Along
-/// with wxUpdateUIEvent pseudoevents, the Controller also handles
-/// focus and notebook-page-change events, merely so that it can force
-/// a wxTextCtrl with invalid data to retain focus--a capability that
-/// wx does not natively provide.
+/// The Controller reacts to changes in control values when wx
+/// generates wxUpdateUIEvent pseudoevents in idle time. Reading every
+/// control on every such pseudoevent was found to consume noticeable
+/// CPU time with large dialogs, so value-change events merely mark
+/// their controls as changed, and only those controls are read. This
+/// is not a fundamentally event-driven style, which would suffer from
+/// the problems described above: value-change events do nothing but
+/// mark controls, and all processing remains in one place. Because a
+/// control that changed without a known event would be overlooked,
+/// the 'check_mvc' option (see global_settings::pyx()) reads every
+/// control on every pseudoevent as before, and reports any changes
+/// that were not announced. Along with wxUpdateUIEvent pseudoevents,
+/// the Controller also handles focus and notebook-page-change events,
+/// merely so that it can force a wxTextCtrl with invalid data to
+/// retain focus--a capability that wx does not natively provide.
 ///
 /// When control values change, the Controller passes them to the
 /// Model. The Model validates the change (described separately below)
@@ -263,12 +270,15 @@ namespace model_view_controller{} // doxygen workaround.
 /// TestModelViewConsistency(): Diagnose inconsistencies between the
 /// Model and the View. This function is designed for developers
 /// rather than end users, and makes little attempt to avoid false
-/// positives.
+/// positives. It is called upon initialization if the 'check_mvc'
+/// option is given.
 ///
 /// Private member functions.
 ///
 /// Assimilate(): Enforce relationships among entities in the Model,
-/// and update the View to reflect consequent changes.
+/// and update the View to reflect consequent changes. Only entities
+/// whose Model values may have changed (as datum_base::revision()
+/// tells), or whose View values changed, are compared.
 ///
 /// Bind(): Associate a string key (shared with the Model) with a
 /// string in data member transfer_data_, the latter being passed by
@@ -327,8 +337,19 @@ namespace model_view_controller{} // doxygen workaround.
 ///
 /// RefocusLastFocusedWindow(): Move focus to last_focused_window_.
 ///
+/// TransferChangedDataFromWindow(): Read controls marked as changed
+/// into transfer_data_ (or all controls, given 'check_mvc'), and
+/// return the names of those whose contents differ from
+/// cached_transfer_data_, which is then updated.
+///
 /// UpdateCircumscription(): Update numeric range limits for controls
-/// that have them.
+/// that have them. Changing its limits may force a control's value
+/// into the new range without any value-change event, so a control
+/// whose value is thus changed is marked as needing to be read.
+///
+/// UponControlChanged(): Mark the control that a value-change event
+/// comes from (or its nearest ancestor with a Transferor, for
+/// composite controls) as needing to be read.
 ///
 /// UponChildFocus(): Trigger validation of a text control when it
 /// loses focus. This event handler is needed because UponUpdateUI()
@@ -392,6 +413,21 @@ namespace model_view_controller{} // doxygen workaround.
 /// when the latter is refreshed. This caching makes it possible to
 /// determine which controls have changed.
 ///
+/// changed_names_: Names of controls that announced changes since
+/// they were last read. Initially, all names: the first update must
+/// read every control, and assimilate all data.
+///
+/// deferred_name_: The name NameOfControlToDeferEvaluating() gave
+/// when changes were last processed. Its View value might not have
+/// been passed to the Model, so it is examined again at the next
+/// change, as it would have been if every name were examined.
+///
+/// consistent_revisions_: For each name, the datum_base::revision()
+/// of the Model datum when its View value was last known to be
+/// equivalent. An absent entry means the View must be compared.
+///
+/// check_mvc_: True iff the 'check_mvc' option is given.
+///
 /// unit_test_idle_processing_completed_: True iff the Controller has
 /// determined that it has no more work to do, absent any user input
 /// changes, because the Model and the View are consistent. Useful
@@ -444,9 +480,11 @@ class MvcController final
 
     std::string NameOfControlToDeferEvaluating() const;
     void RefocusLastFocusedWindow();
+    std::set<std::string> TransferChangedDataFromWindow();
     void UpdateCircumscription(wxWindow&, std::string const&);
 
     void UponChildFocus            (wxChildFocusEvent&   );
+    void UponControlChanged        (wxCommandEvent&      );
     void UponInitDialog            (wxInitDialogEvent&   );
     void UponPageChanged           (wxBookCtrlBaseEvent& );
     void UponPageChanging          (wxBookCtrlBaseEvent& );
@@ -475,6 +513,11 @@ class MvcController final
 
     std::map<std::string,std::string> transfer_data_;
     std::map<std::string,std::string> cached_transfer_data_;
+    std::set<std::string> changed_names_;
+    std::string deferred_name_;
+    std::map<std::string,std::uint64_t> consistent_revisions_;
+
+    bool check_mvc_;
 
     bool unit_test_idle_processing_completed_;
     bool unit_test_refocus_event_pending_;
@@ -26,6 +26,10 @@
 #include "alert.hpp"
 #include "any_entity.hpp"
 #include "assert_lmi.hpp"
+#include "datum_base.hpp"
+#include "ssize_lmi.hpp"
+
+#include <cstdint>                      // uint64_t
 
 namespace
 {
@@ -64,6 +68,92 @@ void ComplainAboutAnyDiscrepancies
 }
 } // Unnamed namespace.
 
+/// Remember a Model's state, and find what has changed since.
+///
+/// Only data whose datum_base::revision() has changed are converted
+/// to string again. A copy shares nothing with its original, so two
+/// trackers can remember states at different times.
+
+class MvcModel::ChangeTracker final
+{
+  public:
+    explicit ChangeTracker(MvcModel const&);
+
+    bool Differences(StateType& old_values, StateType& new_values) const;
+    bool Update();
+
+  private:
+    MvcModel const&                 model_;
+    std::vector<datum_base const*>  data_;
+    std::vector<std::uint64_t>      revisions_;
+    std::vector<std::string>        values_;
+};
+
+MvcModel::ChangeTracker::ChangeTracker(MvcModel const& model)
+    :model_ {model}
+{
+    for(auto const& i : model_.Names())
+        {
+        datum_base const* d = model_.BaseDatumPointer(i);
+        LMI_ASSERT(nullptr != d);
+        data_     .push_back(d);
+        revisions_.push_back(d->revision());
+        values_   .push_back(model_.Entity(i).str());
+        }
+}
+
+/// Report every datum whose value differs from what was remembered,
+/// without remembering the new value. Return true iff any differs.
+
+bool MvcModel::ChangeTracker::Differences
+    (StateType& old_values
+    ,StateType& new_values
+    ) const
+{
+    NamesType const& names = model_.Names();
+    LMI_ASSERT(lmi::ssize(names) == lmi::ssize(data_));
+    for(int j = 0; j < lmi::ssize(data_); ++j)
+        {
+        if(data_[j]->revision() == revisions_[j])
+            {
+            continue;
+            }
+        std::string const s = model_.Entity(names[j]).str();
+        if(s != values_[j])
+            {
+            old_values[names[j]] = values_[j];
+            new_values[names[j]] = s;
+            }
+        }
+    return !old_values.empty();
+}
+
+/// Remember the current state. Return true iff any datum's value
+/// differs from what was remembered.
+
+bool MvcModel::ChangeTracker::Update()
+{
+    NamesType const& names = model_.Names();
+    LMI_ASSERT(lmi::ssize(names) == lmi::ssize(data_));
+    bool changed = false;
+    for(int j = 0; j < lmi::ssize(data_); ++j)
+        {
+        std::uint64_t const r = data_[j]->revision();
+        if(r == revisions_[j])
+            {
+            continue;
+            }
+        revisions_[j] = r;
+        std::string s = model_.Entity(names[j]).str();
+        if(s != values_[j])
+            {
+            values_[j].swap(s);
+            changed = true;
+            }
+        }
+    return changed;
+}
+
 datum_base const* MvcModel::BaseDatumPointer(std::string const& name) const
 {
     return DoBaseDatumPointer(name);
@@ -89,10 +179,15 @@ MvcModel::StateType MvcModel::State() const
     return DoState();
 }
 
+/// Iterate until an iteration changes no datum's value.
+///
+/// One tracker remembers the state at the end of each iteration, and
+/// another the state before each Harmonize() call.
+
 void MvcModel::Reconcile()
 {
-    StateType new_values = State();
-    StateType old_values;
+    ChangeTracker iteration(*this);
+    ChangeTracker harmony(iteration);
 
     bool okay = false;
     int j = 0;
@@ -101,11 +196,9 @@ void MvcModel::Reconcile()
     for(; !okay && j < maximum_iterations; ++j)
         {
         AdaptExternalities();
-        Harmonize();
+        Harmonize(harmony);
         Transmogrify();
-        old_values.swap(new_values);
-        new_values = State();
-        okay = new_values == old_values;
+        okay = !iteration.Update();
         }
 
     if(!okay)
@@ -158,11 +251,24 @@ void MvcModel::CustomizeInitialValues()
 
 void MvcModel::Harmonize()
 {
-    StateType const old_values = State();
+    ChangeTracker tracker(*this);
+    Harmonize(tracker);
+}
+
+/// Harmonize(), comparing values to what the given tracker remembers
+/// after bringing it up to date.
+
+void MvcModel::Harmonize(ChangeTracker& tracker)
+{
+    tracker.Update();
     DoHarmonize();
-    StateType const new_values = State();
-    std::string description = "Harmonize() improperly forces values to change:";
-    ComplainAboutAnyDiscrepancies(old_values, new_values, description);
+    StateType old_values;
+    StateType new_values;
+    if(tracker.Differences(old_values, new_values))
+        {
+        std::string description = "Harmonize() improperly forces values to change:";
+        ComplainAboutAnyDiscrepancies(old_values, new_values, description);
+        }
 }
 
 void MvcModel::Transmogrify()
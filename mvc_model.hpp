@@ -85,6 +85,16 @@ class datum_base;
 /// Reconcile() calls Harmonize() and Transmogrify() one or more
 /// times, until neither changes any data member's value.
 ///
+/// Reconcile() compares states without constructing State() anew for
+/// every comparison. A ChangeTracker records each datum's string
+/// representation along with its datum_base::revision(), and later
+/// converts to string only data whose revision has since changed.
+/// Comparing those strings gives the same answer as comparing whole
+/// State() objects would, so convergence is detected exactly as
+/// before, and no datum's final value can differ. This assumes that
+/// State() is simply the string representation of each Entity(), as
+/// member_state() constructs it.
+///
 /// TODO ?? Is that actually sufficient? Shouldn't the stopping
 /// criterion be more stringent? Why not require that iteration
 /// continue until no data member changes in any way?
@@ -135,11 +145,14 @@ class LMI_SO MvcModel
     void TestInitialConsistency();
 
   private:
+    class ChangeTracker;
+
     void AdaptExternalities();
     void CustomizeInitialValues();
     void EnforceCircumscription(std::string const&);
     void EnforceProscription   (std::string const&);
     void Harmonize();
+    void Harmonize(ChangeTracker&);
     void Transmogrify();
 
     virtual datum_base const* DoBaseDatumPointer(std::string const&) const = 0;
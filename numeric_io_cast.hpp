@@ -87,6 +87,12 @@ struct numeric_converter;
 /// possible floating-point decimal precision. And it is faster than
 /// the std::stringstream technique for all compilers tested in 2004.
 ///
+/// Where the standard library supports <charconv> fully, conversions
+/// use std::to_chars() and std::from_chars() instead, but produce the
+/// same results as the strtoX() and std::snprintf() implementation,
+/// which remains available for comparison: see the accompanying unit
+/// test, which verifies that, and measures the speed difference.
+///
 /// The behavior of numeric_io_cast() with builtin character types
 /// (e.g., char, as opposed to char const*, which is a pointer type,
 /// or std::string, which is not a builtin type) may seem surprising
@@ -137,6 +143,22 @@ struct numeric_converter<To, std::string>
     typedef std::string From;
     To operator()(From const& from) const
         {
+#if defined LMI_NUMERIC_IO_CHARCONV
+        To value;
+        if(numeric_from_chars(from.data(), from.data() + from.size(), value))
+            {
+            return value;
+            }
+#endif // defined LMI_NUMERIC_IO_CHARCONV
+        return strtoT_backend(from);
+        }
+
+    /// Convert with strtoT(), which is authoritative, but slower than
+    /// std::from_chars(). Public only so that the two can be compared
+    /// in unit tests.
+
+    static To strtoT_backend(From const& from)
+        {
         char const* nptr = from.c_str();
         // Pointer to which strtoT()'s 'endptr' argument refers.
         char* rendptr;
@@ -206,6 +228,40 @@ struct numeric_converter<std::string, From>
     typedef std::string To;
     To operator()(From const& from) const
         {
+#if defined LMI_NUMERIC_IO_CHARCONV
+        return to_chars_backend(from);
+#else  // !defined LMI_NUMERIC_IO_CHARCONV
+        return snprintf_backend(from);
+#endif // !defined LMI_NUMERIC_IO_CHARCONV
+        }
+
+    // The two backends are public only so that they can be compared
+    // in unit tests.
+
+#if defined LMI_NUMERIC_IO_CHARCONV
+    static To to_chars_backend(From const& from)
+        {
+        int const buffer_length = 10000;
+        char buffer[buffer_length];
+        char* const end = numeric_to_chars(buffer, buffer + buffer_length, from);
+        if(nullptr == end)
+            {
+            std::ostringstream err;
+            err
+                << "Attempt to convert '"
+                << from
+                << "' to string failed: buffer length is only "
+                << buffer_length
+                << "."
+                ;
+            throw std::runtime_error(err.str());
+            }
+        return To(buffer, end);
+        }
+#endif // defined LMI_NUMERIC_IO_CHARCONV
+
+    static To snprintf_backend(From const& from)
+        {
         int const buffer_length = 10000;
         // Add one to buffer length, and append a null at the end of
         // the buffer, to work around a known problem in the ms C rtl.
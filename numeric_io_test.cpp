@@ -23,6 +23,7 @@
 
 #include "numeric_io_cast.hpp"
 
+#include "global_settings.hpp"
 #include "handle_exceptions.hpp"        // report_exception()
 #include "ieee754.hpp"                  // infinity<>()
 #include "miscellany.hpp"               // stifle_unused_warning()
@@ -42,11 +43,15 @@
 #   pragma clang diagnostic pop
 #endif // defined LMI_CLANG
 
-#include <cmath>                        // exp()
+#include <cmath>                        // exp(), nextafter()
+#include <cstdint>                      // uint32_t, uint64_t
+#include <cstring>                      // memcpy()
 #include <limits>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #if __has_include(<valgrind/valgrind.h>)
 #   include <valgrind/valgrind.h>
@@ -115,6 +120,350 @@ void mete_infinity()
     stifle_unused_warning(d);
 }
 
+#if defined LMI_NUMERIC_IO_CHARCONV
+void mete_two_thirds_snprintf()
+{
+    using converter = numeric_converter<std::string,double>;
+    std::string s = converter::snprintf_backend(2.0 / 3.0);
+    stifle_unused_warning(s);
+}
+
+void mete_two_thirds_to_chars()
+{
+    using converter = numeric_converter<std::string,double>;
+    std::string s = converter::to_chars_backend(2.0 / 3.0);
+    stifle_unused_warning(s);
+}
+
+void mete_currency_snprintf()
+{
+    using converter = numeric_converter<std::string,double>;
+    std::string s = converter::snprintf_backend(1234567.89);
+    stifle_unused_warning(s);
+}
+
+void mete_currency_to_chars()
+{
+    using converter = numeric_converter<std::string,double>;
+    std::string s = converter::to_chars_backend(1234567.89);
+    stifle_unused_warning(s);
+}
+
+void mete_int_snprintf()
+{
+    using converter = numeric_converter<std::string,int>;
+    std::string s = converter::snprintf_backend(1234567);
+    stifle_unused_warning(s);
+}
+
+void mete_int_to_chars()
+{
+    using converter = numeric_converter<std::string,int>;
+    std::string s = converter::to_chars_backend(1234567);
+    stifle_unused_warning(s);
+}
+
+void mete_strtod()
+{
+    static std::string const s("0.666666666666667");
+    double d = numeric_converter<double,std::string>::strtoT_backend(s);
+    stifle_unused_warning(d);
+}
+
+void mete_from_chars()
+{
+    static std::string const s("0.666666666666667");
+    double d = numeric_converter<double,std::string>()(s);
+    stifle_unused_warning(d);
+}
+
+/// Two values are the same if they're equal or both NaN.
+
+template<typename T>
+bool same_value(T t, T u)
+{
+    return t == u || (t != t && u != u);
+}
+
+/// Test that both string-to-number backends agree, even on errors.
+
+template<typename T>
+void test_parsing_backends(std::string const& s, char const* file, int line)
+{
+    numeric_converter<T,std::string> const converter;
+    std::string what0 {"no exception"};
+    std::string what1 {"no exception"};
+    T t0 {};
+    T t1 {};
+    try {t0 = converter.strtoT_backend(s);}
+    catch(std::exception const& e) {what0 = e.what();}
+    try {t1 = converter(s);}
+    catch(std::exception const& e) {what1 = e.what();}
+    INVOKE_LMI_TEST_EQUAL(what0, what1, file, line);
+    INVOKE_LMI_TEST(same_value(t0, t1), file, line);
+}
+
+/// Test that both number-to-string backends agree, and that the
+/// result is parsed identically by both string-to-number backends.
+
+template<typename T>
+void test_formatting_backends(T t, char const* file, int line)
+{
+    using converter = numeric_converter<std::string,T>;
+    std::string const s0 = converter::snprintf_backend(t);
+    std::string const s1 = converter::to_chars_backend(t);
+    INVOKE_LMI_TEST_EQUAL(s0, s1, file, line);
+    test_parsing_backends<T>(s0, file, line);
+}
+
+template<typename T>
+void test_integral_backends()
+{
+    using limits = std::numeric_limits<T>;
+    for
+        (T t :
+            {limits::lowest()
+            ,T(limits::lowest() + 1)
+            ,T(-1)
+            ,T(0)
+            ,T(1)
+            ,T(limits::max() - 1)
+            ,limits::max()
+            }
+        )
+        {
+        test_formatting_backends(t, __FILE__, __LINE__);
+        }
+    // Test all values of types no wider than sixteen bits.
+    if(limits::digits <= 16)
+        {
+        for(long int i = limits::lowest(); i <= limits::max(); ++i)
+            {
+            test_formatting_backends(static_cast<T>(i), __FILE__, __LINE__);
+            }
+        }
+    else
+        {
+        std::mt19937_64 g;
+        for(int i = 0; i < 100000; ++i)
+            {
+            std::uint64_t const u = g();
+            T t;
+            std::memcpy(&t, &u, sizeof t);
+            test_formatting_backends(t, __FILE__, __LINE__);
+            }
+        }
+}
+
+template<typename T>
+void test_floating_backends_near(T t)
+{
+    T u = t;
+    T v = t;
+    for(int i = 0; i < 4; ++i)
+        {
+        test_formatting_backends( u, __FILE__, __LINE__);
+        test_formatting_backends(-u, __FILE__, __LINE__);
+        test_formatting_backends( v, __FILE__, __LINE__);
+        test_formatting_backends(-v, __FILE__, __LINE__);
+        u = std::nextafter(u, std::numeric_limits<T>::infinity());
+        v = std::nextafter(v, T(0));
+        }
+}
+
+/// Test decimal fractions typical of monetary amounts and rates.
+
+template<typename T>
+void test_decimal_fraction_backends()
+{
+    for(int i = 0; i < 200000; ++i)
+        {
+        test_formatting_backends(T(i / 100.0), __FILE__, __LINE__);
+        test_formatting_backends(T(i / 10000.0), __FILE__, __LINE__);
+        test_formatting_backends(T(i / 3.0), __FILE__, __LINE__);
+        test_formatting_backends(T(i / 7.0), __FILE__, __LINE__);
+        }
+}
+
+template<typename T, typename Bits>
+void test_floating_backends()
+{
+    using limits = std::numeric_limits<T>;
+    for
+        (T t :
+            {T(0)
+            ,limits::denorm_min()
+            ,limits::min()
+            ,limits::epsilon()
+            ,limits::max()
+            ,limits::infinity()
+            ,limits::quiet_NaN()
+            ,T(1.0 / 3.0)
+            ,T(2.0 / 3.0)
+            ,T(0.1)
+            ,T(0.5)
+            ,T(1.5)
+            ,T(1999.995)
+            }
+        )
+        {
+        test_floating_backends_near(t);
+        }
+
+    // Powers of two and of ten, and their neighbors.
+    for(int i = limits::min_exponent; i < limits::max_exponent; ++i)
+        {
+        test_floating_backends_near(std::ldexp(T(1), i));
+        }
+    for(int i = limits::min_exponent10; i <= limits::max_exponent10; ++i)
+        {
+        test_floating_backends_near(numeric_io_cast<T>("1e" + std::to_string(i)));
+        }
+
+    test_decimal_fraction_backends<T>();
+
+    // Uniformly random values, and uniformly random bit patterns.
+    std::mt19937_64 g;
+    std::uniform_real_distribution<T> d(T(0), T(1.0e7));
+    for(int i = 0; i < 200000; ++i)
+        {
+        test_formatting_backends(d(g), __FILE__, __LINE__);
+        Bits const b = static_cast<Bits>(g());
+        T t;
+        std::memcpy(&t, &b, sizeof t);
+        test_formatting_backends(t, __FILE__, __LINE__);
+        }
+}
+
+/// Test that the <charconv> backend gives the traditional results.
+///
+/// The floating-point tests take a few seconds, because std::snprintf()
+/// must write hundreds of digits for tiny numbers.
+
+void test_backends()
+{
+#if defined LMI_GCC
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wuseless-cast"
+#endif // defined LMI_GCC
+    test_integral_backends<char              >();
+    test_integral_backends<signed char       >();
+    test_integral_backends<unsigned char     >();
+    test_integral_backends<short int         >();
+    test_integral_backends<unsigned short int>();
+    test_integral_backends<int               >();
+    test_integral_backends<unsigned int      >();
+    test_integral_backends<long int          >();
+    test_integral_backends<unsigned long int >();
+    test_integral_backends<long long int     >();
+    test_integral_backends<unsigned long long int>();
+    test_formatting_backends(true , __FILE__, __LINE__);
+    test_formatting_backends(false, __FILE__, __LINE__);
+#if defined LMI_GCC
+#   pragma GCC diagnostic pop
+#endif // defined LMI_GCC
+
+    test_floating_backends<float , std::uint32_t>();
+    test_floating_backends<double, std::uint64_t>();
+
+    // Regression testing deliberately reduces precision. (It also
+    // makes floating_point_decimals() fail for values so tiny that
+    // their product with epsilon underflows, so test only values in
+    // the normal range of interest.)
+    global_settings::instance().set_regression_testing(true);
+    test_decimal_fraction_backends<double>();
+    global_settings::instance().set_regression_testing(false);
+
+    std::vector<std::string> const strings
+        {""
+        ," "
+        ,"0"
+        ,"-0"
+        ,"+0"
+        ," 1"
+        ,"1 "
+        ,"+1"
+        ,"-1"
+        ,"--1"
+        ,"077"
+        ,"0099"
+        ,"1."
+        ,".1"
+        ,"."
+        ,"-.5"
+        ,"1e"
+        ,"1e+"
+        ,"1e5"
+        ,"1E5"
+        ,"1e-5"
+        ,"1.e0"
+        ,"0x10"
+        ,"0x1p3"
+        ,"1,5"
+        ,"inf"
+        ,"-INF"
+        ,"infinity"
+        ,"nan"
+        ,"-nan"
+        ,"true"
+        ,"127"
+        ,"128"
+        ,"255"
+        ,"256"
+        ,"32768"
+        ,"65536"
+        ,"2147483648"
+        ,"-2147483649"
+        ,"4294967296"
+        ,"9223372036854775808"
+        ,"18446744073709551616"
+        ,"99999999999999999999999"
+        ,"1e38"
+        ,"1e39"
+        ,"1e-45"
+        ,"1e-46"
+        ,"1e308"
+        ,"1e309"
+        ,"4.9406564584124654e-324"
+        ,"2.4703282292062327e-324"
+        ,"2.4703282292062328e-324"
+        ,"1e-400"
+        ,"0.1000000000000000055511151231257827"
+        ,"9007199254740993"
+        ,"0.3333333333333333"
+        ,"2.718281828459045"
+        };
+    for(auto const& i : strings)
+        {
+        test_parsing_backends<bool         >(i, __FILE__, __LINE__);
+        test_parsing_backends<char         >(i, __FILE__, __LINE__);
+        test_parsing_backends<signed char  >(i, __FILE__, __LINE__);
+        test_parsing_backends<unsigned char>(i, __FILE__, __LINE__);
+        test_parsing_backends<short int    >(i, __FILE__, __LINE__);
+        test_parsing_backends<int          >(i, __FILE__, __LINE__);
+        test_parsing_backends<unsigned int >(i, __FILE__, __LINE__);
+        test_parsing_backends<long int     >(i, __FILE__, __LINE__);
+        test_parsing_backends<unsigned long int>(i, __FILE__, __LINE__);
+        test_parsing_backends<float        >(i, __FILE__, __LINE__);
+        test_parsing_backends<double       >(i, __FILE__, __LINE__);
+        test_parsing_backends<long double  >(i, __FILE__, __LINE__);
+        }
+
+    std::cout
+        << "Backends:"
+        << "\n  2/3 to string, snprintf  : " << TimeAnAliquot(mete_two_thirds_snprintf)
+        << "\n  2/3 to string, to_chars  : " << TimeAnAliquot(mete_two_thirds_to_chars)
+        << "\n  money to string, snprintf: " << TimeAnAliquot(mete_currency_snprintf  )
+        << "\n  money to string, to_chars: " << TimeAnAliquot(mete_currency_to_chars  )
+        << "\n  int to string, snprintf  : " << TimeAnAliquot(mete_int_snprintf       )
+        << "\n  int to string, to_chars  : " << TimeAnAliquot(mete_int_to_chars       )
+        << "\n  string to 2/3, strtod    : " << TimeAnAliquot(mete_strtod             )
+        << "\n  string to 2/3, from_chars: " << TimeAnAliquot(mete_from_chars         )
+        << std::endl
+        ;
+}
+#endif // defined LMI_NUMERIC_IO_CHARCONV
+
 // These tests generally assume IEC 60559 floating point. Hardware
 // that deviates from that standard is probably so rare that it can
 // reasonably be ignored, with an appropriate runtime message.
@@ -205,6 +554,10 @@ int test_main(int, char*[])
         << std::endl
         ;
 
+#if defined LMI_NUMERIC_IO_CHARCONV
+    test_backends();
+#endif // defined LMI_NUMERIC_IO_CHARCONV
+
     // Infinities.
 
     double const volatile inf_dbl = std::numeric_limits<double>::infinity();
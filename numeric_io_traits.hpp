@@ -29,15 +29,28 @@
 #include "ieee754.hpp"                  // is_infinite<>()
 #include "miscellany.hpp"               // rtrim()
 
-#include <algorithm>                    // max()
+#include <algorithm>                    // find(), max()
+#include <charconv>                     // from_chars(), to_chars()
 #include <cmath>                        // fabs(), log10()
 #include <cstdlib>                      // strto*()
 #include <cstring>                      // strcmp(), strlen()
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <system_error>                 // errc
 #include <type_traits>
 
+/// Convert numbers with <charconv> rather than <cstdio> and <cstdlib>
+/// wherever the standard library fully supports it.
+///
+/// std::to_chars() and std::from_chars() are much faster than
+/// std::snprintf() and std::strtod(), and are unaffected by the C
+/// locale (whose decimal point could otherwise wreak havoc).
+
+#if defined __cpp_lib_to_chars && !defined LMI_MSVCRT
+#   define LMI_NUMERIC_IO_CHARCONV
+#endif // defined __cpp_lib_to_chars && !defined LMI_MSVCRT
+
 /// Number of exact decimal digits to the right of the decimal point.
 ///
 /// Returns the maximum number of fractional decimal digits, q, such
@@ -376,4 +389,106 @@ template<> struct numeric_conversion_traits<long double>
 #endif // !defined LMI_MSVCRT
 };
 
+#if defined LMI_NUMERIC_IO_CHARCONV
+/// Format a number exactly as numeric_io_cast() traditionally has.
+///
+/// The traditional method formats with std::snprintf(), using fmt()
+/// and digits(), and then applies simplify(). This function produces
+/// the same characters, but uses std::to_chars(), which is specified
+/// to produce the same digits as std::printf() for a given precision.
+///
+/// For a floating-point value, the shortest representation that
+/// round-trips is tried first. If it has fewer fractional digits
+/// than digits() returns, then it is the traditional result, too.
+/// Proof: let the shortest representation S of value V have fewer
+/// than P = digits(V) fractional digits. Then |V-S| is at most half
+/// an ulp, which is less than half of 10^-P (because digits() is
+/// chosen so that an ulp does not exceed 10^-P, and no power of two
+/// equals a negative power of ten). Therefore, rounding V to P
+/// decimals yields S padded with zeros, which simplify() would strip.
+/// Otherwise, as happens for instance with
+///   1.0000000000000002 (i.e., one plus epsilon)
+/// for which the traditional result is "1", V is formatted to the
+/// traditional precision, and trailing zeros are removed.
+///
+/// Returns a pointer one past the last character written, or null
+/// if [first, last) is too small.
+
+template<typename T>
+char* numeric_to_chars(char* first, char* last, T t)
+{
+    static_assert(std::is_arithmetic_v<T>);
+    if constexpr(std::is_integral_v<T>)
+        {
+        // Promote bool and char, just as snprintf()'s varargs do.
+        std::to_chars_result const r = std::to_chars(first, last, +t);
+        return std::errc() == r.ec ? r.ptr : nullptr;
+        }
+    else
+        {
+        int const p = numeric_conversion_traits<T>::digits(t);
+        if(0 < p)
+            {
+            std::to_chars_result const r = std::to_chars
+                (first
+                ,last
+                ,t
+                ,std::chars_format::fixed
+                );
+            if(std::errc() == r.ec && r.ptr - std::find(first, r.ptr, '.') <= p)
+                {
+                return r.ptr;
+                }
+            }
+        std::to_chars_result const r = std::to_chars
+            (first
+            ,last
+            ,t
+            ,std::chars_format::fixed
+            ,p
+            );
+        if(std::errc() != r.ec)
+            {
+            return nullptr;
+            }
+        char* z = r.ptr;
+        if(r.ptr != std::find(first, r.ptr, '.'))
+            {
+            while('0' == z[-1]) {--z;}
+            if('.' == z[-1]) {--z;}
+            }
+        return z;
+        }
+}
+
+/// Convert a string to a number with std::from_chars(), if the result
+/// is certainly the same as strtoT() would produce.
+///
+/// That is the case when std::from_chars() succeeds and consumes the
+/// entire string, because strtoT() then accepts the same characters
+/// and, just as std::from_chars() does, rounds to nearest. Returns
+/// false otherwise--e.g., for leading whitespace, a '+' sign, a
+/// hexadecimal floating-point number, or a value out of range--so
+/// that the caller can call strtoT() and preserve its behavior and
+/// diagnostics in every edge case.
+///
+/// std::from_chars() has no overload for bool, so for that type this
+/// always defers to strtoT().
+
+template<typename T>
+bool numeric_from_chars(char const* first, char const* last, T& t)
+{
+    static_assert(std::is_arithmetic_v<T>);
+    if constexpr(std::is_same_v<bool,T>)
+        {
+        return false;
+        }
+    else
+        {
+        std::from_chars_result const r = std::from_chars(first, last, t);
+        return std::errc() == r.ec && last == r.ptr;
+        }
+}
+#endif // defined LMI_NUMERIC_IO_CHARCONV
+
 #endif // numeric_io_traits_hpp
@@ -43,6 +43,7 @@ class modal_outlay final
         ,round_to<double> const& round_withdrawal
         ,round_to<double> const& round_loan
         );
+    modal_outlay(modal_outlay const&) = default;
     ~modal_outlay() = default;
 
     currency                        dumpin               () const;
@@ -56,7 +57,6 @@ class modal_outlay final
     std::vector<currency>    const& new_cash_loans       () const;
 
   private:
-    modal_outlay(modal_outlay const&) = delete;
     modal_outlay& operator=(modal_outlay const&) = delete;
 
     void block_dumpin              ();
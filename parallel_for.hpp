@@ -0,0 +1,154 @@
+// Apply a function to a range of indices on several threads.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef parallel_for_hpp
+#define parallel_for_hpp
+
+#include "config.hpp"
+
+#include "fenv_guard.hpp"
+
+#include <algorithm>                    // min()
+#include <atomic>
+#include <exception>                    // exception_ptr, rethrow_exception()
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Number of threads to use by default: the hardware concurrency, or
+/// one if that cannot be determined.
+
+inline int lmi_concurrency()
+{
+    int const n = static_cast<int>(std::thread::hardware_concurrency());
+    return 0 < n ? n : 1;
+}
+
+/// Whether the current thread is running a parallel_for() invocation.
+
+inline bool& within_parallel_for()
+{
+    thread_local bool z {false};
+    return z;
+}
+
+/// Call f(i) for each i in [0, n), distributing indices across threads.
+///
+/// Indices are claimed in increasing order, so a caller that sorts
+/// its work by decreasing cost gets the longest jobs started first.
+/// Invocations must be independent of each other: typically, f(i)
+/// reads shared data that no thread modifies, and writes only into
+/// element i of a container that was sized in advance.
+///
+/// If any invocation throws, indices not yet claimed are abandoned,
+/// and the first exception is rethrown on the calling thread after
+/// all workers have been joined. Callers that want a diagnostic for
+/// every item should therefore catch exceptions inside f.
+///
+/// If 'max_threads' is not positive, lmi_concurrency() is used. If
+/// only one thread would be used, f is called serially on the calling
+/// thread, and no thread is created at all.
+///
+/// A parallel_for() called from within another's f is likewise run
+/// serially: the outer call already occupies the threads it ought to
+/// use, and nesting would multiply their number. Thus, for example,
+/// illustrations run concurrently as batch jobs do not each spawn yet
+/// more threads to project their run bases.
+///
+/// Each new thread establishes lmi's floating-point environment with
+/// an fenv_guard, because threads inherit their creator's environment
+/// on some platforms but not on others. Thus, calculations are not
+/// affected by the choice of thread.
+
+template<typename F>
+void parallel_for(int n, F f, int max_threads = 0)
+{
+    if(max_threads <= 0)
+        {
+        max_threads = lmi_concurrency();
+        }
+    int const number_of_threads = std::min(n, max_threads);
+    if(number_of_threads <= 1 || within_parallel_for())
+        {
+        for(int i = 0; i < n; ++i)
+            {
+            f(i);
+            }
+        return;
+        }
+
+    std::atomic<int>   next      {0};
+    std::atomic<bool>  failed    {false};
+    std::exception_ptr exception {};
+    std::mutex         exception_mutex;
+
+    auto worker = [&]
+        {
+        within_parallel_for() = true;
+        for(;;)
+            {
+            int const i = next++;
+            if(n <= i || failed)
+                {
+                within_parallel_for() = false;
+                return;
+                }
+            try
+                {
+                f(i);
+                }
+            catch(...)
+                {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if(!exception)
+                    {
+                    exception = std::current_exception();
+                    }
+                failed = true;
+                }
+            }
+        };
+
+    std::vector<std::thread> threads;
+    threads.reserve(number_of_threads - 1);
+    for(int j = 1; j < number_of_threads; ++j)
+        {
+        threads.emplace_back
+            ([&worker]
+                {
+                fenv_guard fg;
+                worker();
+                }
+            );
+        }
+    worker();
+    for(auto& t : threads)
+        {
+        t.join();
+        }
+
+    if(exception)
+        {
+        std::rethrow_exception(exception);
+        }
+}
+
+#endif // parallel_for_hpp
@@ -0,0 +1,132 @@
+// Apply a function to a range of indices on several threads--unit test.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "parallel_for.hpp"
+
+#include "test_tools.hpp"
+
+#include <atomic>
+#include <numeric>                      // accumulate()
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+void test_every_index_visited_once()
+{
+    for(int threads : {0, 1, 2, 3, 64})
+        {
+        std::vector<int> v(1000);
+        parallel_for
+            (static_cast<int>(v.size())
+            ,[&v](int i) {v[i] += 1 + i;}
+            ,threads
+            );
+        for(int i = 0; i < static_cast<int>(v.size()); ++i)
+            {
+            LMI_TEST_EQUAL(1 + i, v[i]);
+            }
+        }
+
+    // Empty and singleton ranges.
+    int calls = 0;
+    parallel_for(0, [&calls](int) {++calls;});
+    LMI_TEST_EQUAL(0, calls);
+    parallel_for(1, [&calls](int) {++calls;});
+    LMI_TEST_EQUAL(1, calls);
+}
+
+void test_serial_fallback()
+{
+    std::thread::id const caller = std::this_thread::get_id();
+    std::vector<int> order;
+    parallel_for
+        (5
+        ,[&](int i)
+            {
+            LMI_TEST(caller == std::this_thread::get_id());
+            order.push_back(i);
+            }
+        ,1
+        );
+    LMI_TEST(std::vector<int>({0, 1, 2, 3, 4}) == order);
+}
+
+void test_nesting()
+{
+    std::vector<int> v(4 * 8);
+    parallel_for
+        (4
+        ,[&v](int i)
+            {
+            std::thread::id const outer = std::this_thread::get_id();
+            LMI_TEST(within_parallel_for());
+            parallel_for
+                (8
+                ,[&](int j)
+                    {
+                    LMI_TEST(outer == std::this_thread::get_id());
+                    v[8 * i + j] = 1;
+                    }
+                ,8
+                );
+            }
+        ,4
+        );
+    LMI_TEST_EQUAL(32, std::accumulate(v.begin(), v.end(), 0));
+    LMI_TEST(!within_parallel_for());
+}
+
+void test_exceptions()
+{
+    std::atomic<int> calls {0};
+    LMI_TEST_THROW
+        (parallel_for
+            (100
+            ,[&calls](int i)
+                {
+                ++calls;
+                if(7 == i) throw std::runtime_error("Seven.");
+                }
+            ,4
+            )
+        ,std::runtime_error
+        ,"Seven."
+        );
+    LMI_TEST(8 <= calls);
+
+    LMI_TEST_THROW
+        (parallel_for(3, [](int) {throw std::logic_error("Serial.");}, 1)
+        ,std::logic_error
+        ,"Serial."
+        );
+}
+
+int test_main(int, char*[])
+{
+    test_every_index_visited_once();
+    test_serial_fallback();
+    test_nesting();
+    test_exceptions();
+
+    return 0;
+}
@@ -26,6 +26,7 @@
 #include "alert.hpp"
 #include "assert_lmi.hpp"
 #include "bourn_cast.hpp"
+#include "cache_file_reads.hpp"
 #include "data_directory.hpp"           // AddDataDir()
 #include "force_linking.hpp"
 #include "html.hpp"
@@ -59,6 +60,7 @@
 #include <fstream>
 #include <map>
 #include <memory>                       // make_unique(), unique_ptr
+#include <mutex>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
@@ -104,6 +106,56 @@ std::string ir_suffix(interest_rate zero_or_not)
     throw "Unreachable--unknown interest_rate value";
 }
 
+// Every PDF uses the same few templates and images, so read them only
+// once for the whole process.
+
+// Template partial, stored obfuscated in an '.xst' file, and reread
+// if the file changes on disk.
+class xst_template final
+    :public cache_file_reads<xst_template>
+{
+  public:
+    explicit xst_template(fs::path const& filename)
+    {
+        std::ifstream ifs(filename.string());
+        istream_to_string(ifs, text_);
+        for(auto& i : text_) i = static_cast<unsigned char>(i ^ 0xff);
+    }
+
+    std::string const& text() const {return text_;}
+
+  private:
+    std::string text_;
+};
+
+// Image named by an <img> tag, as loaded by load_image(), which finds
+// the file and diagnoses any failure. Only images that loaded
+// successfully are retained, so that a missing or damaged image is
+// diagnosed each time it's used, and found if it's later installed.
+wxImage cached_image(std::string const& src)
+{
+    static std::map<std::string,wxImage> cache;
+    static std::mutex cache_mutex;
+    {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto const i = cache.find(src);
+    if(cache.end() != i)
+        {
+        return i->second;
+        }
+    }
+
+    // Load without holding the lock, because load_image() may issue
+    // a warning, which can wait for the main thread.
+    wxImage const image(load_image(src.c_str()));
+    if(image.IsOk())
+        {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        cache.emplace(src, image);
+        }
+    return image;
+}
+
 // Helper class grouping functions for dealing with interpolating strings
 // containing variable references.
 class html_interpolator
@@ -316,8 +368,8 @@ class html_interpolator
 
     std::string load_partial_from_file(std::string const& file) const
     {
-        std::ifstream ifs(AddDataDir(file + ".xst"));
-        if(!ifs)
+        fs::path const filename(AddDataDir(file + ".xst"));
+        if(!fs::exists(filename))
             {
             alarum()
                 << "Template file \""
@@ -326,10 +378,7 @@ class html_interpolator
                 << std::flush
                 ;
             }
-        std::string partial;
-        istream_to_string(ifs, partial);
-        for(auto& i : partial) i = static_cast<unsigned char>(i ^ 0xff);
-        return partial;
+        return xst_template::read_via_cache(filename)->text();
     }
 
     // Object used for variables expansion.
@@ -720,7 +769,7 @@ TAG_HANDLER_BEGIN(scaled_image, "IMG")
             scale_factor = 1.0 / inv_factor;
             }
 
-        wxImage image(load_image(src.c_str()));
+        wxImage const image(cached_image(src.ToStdString()));
         if(image.IsOk())
             {
             m_WParser->GetContainer()->InsertCell
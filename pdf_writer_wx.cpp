@@ -34,7 +34,9 @@
 #include <wx/html/htmlcell.h>
 #include <wx/html/htmprint.h>
 
+#include <cstddef>                      // size_t
 #include <exception>                    // uncaught_exceptions()
+#include <tuple>
 
 namespace
 {
@@ -88,6 +90,30 @@ class dc_font_preserver
     wxFont const font_;
 };
 
+/// Heights of HTML measured by any writer, keyed by everything that
+/// determines them: font sizes, width, and the HTML text itself.
+///
+/// Every illustration in a census has nearly the same headers and
+/// footers, so measuring them anew for each page of each PDF would
+/// be wasteful. Because text such as an insured's name can make every
+/// key distinct, the cache is simply cleared when it grows large.
+///
+/// Like everything else here, this is used only on the main thread.
+
+using measurement_key = std::tuple
+    <pdf_writer_wx::html_font_sizes
+    ,int
+    ,std::string
+    >;
+
+std::map<measurement_key,int>& measured_heights()
+{
+    static std::map<measurement_key,int> z;
+    return z;
+}
+
+constexpr std::size_t maximum_measured_heights = 10000;
+
 } // Unnamed namespace.
 
 pdf_writer_wx::pdf_writer_wx
@@ -297,6 +323,10 @@ int pdf_writer_wx::output_html
 ///
 /// In this case "from" and "to" parameters are not needed and we can take
 /// html::text directly as it won't be used any more.
+///
+/// Text like this is typically a header or footer that recurs on every
+/// page, so it is parsed only once for each document, and a height
+/// that has already been measured is reused without laying it out.
 
 int pdf_writer_wx::output_html
     (int                          x
@@ -306,10 +336,40 @@ int pdf_writer_wx::output_html
     ,oenum_render_or_only_measure output_mode
     )
 {
-    auto const cell{parse_html(std::move(html))};
-    LMI_ASSERT(cell);
+    std::string const text {std::move(html).as_html()};
 
-    return output_html(x, y, width, *cell, output_mode);
+    switch(output_mode)
+        {
+        case oe_render:
+            {
+            return output_html(x, y, width, parse_html_once(text), output_mode);
+            }
+        case oe_only_measure:
+            {
+            auto& heights = measured_heights();
+            measurement_key key {html_font_sizes_, width, text};
+            if(auto const i = heights.find(key); heights.end() != i)
+                {
+                return i->second;
+                }
+
+            int const height = output_html
+                (x
+                ,y
+                ,width
+                ,parse_html_once(text)
+                ,output_mode
+                );
+            if(maximum_measured_heights <= heights.size())
+                {
+                heights.clear();
+                }
+            heights.emplace(std::move(key), height);
+            return height;
+            }
+        }
+
+    throw "Unreachable--silences a compiler diagnostic.";
 }
 
 int pdf_writer_wx::output_html
@@ -372,6 +432,20 @@ std::unique_ptr<wxHtmlContainerCell> pdf_writer_wx::parse_html(html::text&& html
         );
 }
 
+/// Parse the given HTML, or return the cell it was parsed into before.
+
+wxHtmlContainerCell& pdf_writer_wx::parse_html_once(std::string const& html)
+{
+    auto i = parsed_html_.find(html);
+    if(parsed_html_.end() == i)
+        {
+        auto cell {parse_html(html::text::from_html(html))};
+        LMI_ASSERT(cell);
+        i = parsed_html_.emplace(html, std::move(cell)).first;
+        }
+    return *i->second;
+}
+
 /// Construct a self-contained HTML document from the given cell.
 ///
 /// The function takes ownership of its argument and attaches it to the new,
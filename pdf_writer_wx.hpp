@@ -32,7 +32,9 @@
 #include <wx/pdfdc.h>
 
 #include <array>
+#include <map>
 #include <memory>                       // unique_ptr
+#include <string>
 
 class wxFileSystem;
 
@@ -126,6 +128,8 @@ class pdf_writer_wx
   private:
     void initialize_html_parser(wxHtmlWinParser& html_parser);
 
+    wxHtmlContainerCell& parse_html_once(std::string const& html);
+
     wxPrintData print_data_;
     wxPdfDC pdf_dc_;
 
@@ -134,6 +138,10 @@ class pdf_writer_wx
     std::unique_ptr<wxFileSystem> html_vfs_;
     wxHtmlWinParser html_parser_;
 
+    // HTML parsed by parse_html_once(), keyed by its text. Declared
+    // after html_parser_ so that it is destroyed first.
+    std::map<std::string, std::unique_ptr<wxHtmlContainerCell>> parsed_html_;
+
     html_font_sizes const html_font_sizes_;
 
     wxSize const total_page_size_;
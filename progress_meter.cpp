@@ -24,6 +24,7 @@
 #include "progress_meter.hpp"
 
 #include "alert.hpp"
+#include "calculation_channel.hpp"
 #include "timer.hpp"                    // lmi_sleep()
 
 #include <exception>                    // uncaught_exceptions()
@@ -43,6 +44,13 @@ std::unique_ptr<progress_meter> create_progress_meter
     ,progress_meter::enum_display_mode display_mode
     )
 {
+    // A calculation on a worker thread must not touch the user
+    // interface, so its progress is posted to its channel instead.
+    if(calculation_channel* c = current_calculation_channel())
+        {
+        return create_channel_progress_meter(*c, max_count, title, display_mode);
+        }
+
     if(nullptr == progress_meter_creator)
         {
         alarum() << "Function pointer not yet initialized." << LMI_FLUSH;
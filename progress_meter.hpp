@@ -114,7 +114,9 @@
 /// Nonmember functions.
 ///
 /// create_progress_meter(): Create an instance of a derived class by
-/// invoking its ctor.
+/// invoking its ctor. On a thread that has a current channel (see
+/// 'calculation_channel.hpp'), that derived class is one that posts
+/// progress to the channel, and the function pointer is not used.
 ///
 /// set_progress_meter_creator(): Set the function pointer used by
 /// create_progress_meter().
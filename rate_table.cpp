@@ -26,12 +26,12 @@
 #include "alert.hpp"
 #include "bourn_cast.hpp"
 #include "crc32.hpp"
-#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary()
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary(), stifle_unused_warning()
 #include "path.hpp"
 #include "path_utility.hpp"
 #include "value_cast.hpp"
 
-#include <algorithm>                    // count()
+#include <algorithm>                    // count(), find()
 #if 202002 <= __cplusplus
 #   include <bit>                       // endian
 #endif //  202002 <= __cplusplus
@@ -49,6 +49,11 @@
 #include <stdexcept>
 #include <utility>                      // make_pair(), swap()
 
+#if defined LMI_POSIX
+#   include <fcntl.h>                   // open(), O_RDONLY
+#   include <unistd.h>                  // close(), fsync()
+#endif // defined LMI_POSIX
+
 // Note about error handling in this code: with a few exceptions (e.g.
 // strict_parse_number), most of the functions in this file throw on error.
 // If the exception is thrown from a low level function, it is caught and
@@ -198,6 +203,27 @@ void remove_nothrow(fs::path const& path)
     fs::remove(path, deliberately_ignored);
 }
 
+// Flush a file, or a directory's entries, from the OS cache to the disk, so
+// that a later rename() can't become durable before the data it refers to.
+// Elsewhere than on POSIX systems, this does nothing.
+void sync_to_disk(fs::path const& path)
+{
+#if defined LMI_POSIX
+    int const fd = ::open(path.string().c_str(), O_RDONLY);
+    if(fd < 0 || 0 != ::fsync(fd))
+        {
+        if(0 <= fd)
+            {
+            ::close(fd);
+            }
+        alarum() << "failed to synchronize \"" << path << "\"" << std::flush;
+        }
+    ::close(fd);
+#else  // !defined LMI_POSIX
+    stifle_unused_warning(path);
+#endif // !defined LMI_POSIX
+}
+
 // Helper function wrapping std::strtoull() and hiding its peculiarities:
 //
 //  - It uses base 10 and doesn't handle leading "0x" as hexadecimal nor,
@@ -2356,6 +2382,7 @@ class database_impl final
     void delete_table(table::Number number);
     void save(fs::path const& path);
     void save(std::ostream& index_os, std::ostream& data_os);
+    void save_in_place(fs::path const& path);
 
   private:
     database_impl(database_impl const&) = delete;
@@ -2377,8 +2404,18 @@ class database_impl final
 
     void read_index(std::istream& index_is);
 
-    // We don't currently use the name stored in the index, so this struct
-    // doesn't include it.
+    // Write a single index record.
+    static void write_index_record
+        (std::ostream&      index_os
+        ,std::uint32_t      number
+        ,std::string const& name
+        ,std::uint32_t      offset
+        );
+
+    // Return the current output position, checking that it is still
+    // representable as a 4 byte offset (i.e. the file is less than 4GiB).
+    static std::uint32_t get_output_offset(std::ostream& os);
+
     struct IndexEntry
     {
         IndexEntry
@@ -2386,9 +2423,10 @@ class database_impl final
             ,std::uint32_t               offset
             ,std::shared_ptr<table_impl> table
             )
-            :number_ {bourn_cast<std::uint32_t>(number.value())}
-            ,offset_ {offset}
-            ,table_  {table}
+            :number_   {bourn_cast<std::uint32_t>(number.value())}
+            ,offset_   {offset}
+            ,table_    {table}
+            ,modified_ {static_cast<bool>(table)}
         {
         }
 
@@ -2402,6 +2440,14 @@ class database_impl final
         // table pointer may be empty for the tables present in the input
         // database file but not loaded yet.
         mutable std::shared_ptr<table_impl> table_;
+
+        // The name stored in the index file, which is used only when the
+        // index is rewritten by save_in_place() without loading the table.
+        std::string name_;
+
+        // True iff the table was added or replaced, and so isn't (yet)
+        // stored at offset_ in the database file.
+        bool modified_;
     };
 
     // Add an entry to the index. This function should be always used instead of
@@ -2583,9 +2629,58 @@ void database_impl::read_index(std::istream& index_is)
                 << std::flush
                 ;
             }
+
+        char const* const name = &index_record[e_index_pos_name];
+        index_.back().name_.assign
+            (name
+            ,std::find(name, name + e_index_pos_offset - e_index_pos_name, '\0')
+            );
         }
 }
 
+void database_impl::write_index_record
+    (std::ostream&      index_os
+    ,std::uint32_t      number
+    ,std::string const& name
+    ,std::uint32_t      offset
+    )
+{
+    char index_record[e_index_pos_max] = {0};
+
+    to_bytes(&index_record[e_index_pos_number], number);
+
+    // We need to pad the name with NUL bytes if it's shorter than maximum
+    // length, so use strncpy() to do it.
+    strncpy
+        (&index_record[e_index_pos_name]
+        ,name.c_str()
+        ,e_index_pos_offset - e_index_pos_name - 1
+        );
+
+    // However (mainly for compatibility with the existing files as this
+    // code doesn't rely on it) the name still has to be NUL-terminated, in
+    // spite of being fixed size, so ensure this is the case.
+    index_record[e_index_pos_offset - 1] = '\0';
+
+    to_bytes(&index_record[e_index_pos_offset], offset);
+
+    stream_write(index_os, index_record, sizeof(index_record));
+}
+
+std::uint32_t database_impl::get_output_offset(std::ostream& os)
+{
+    std::streamoff const offset = os.tellp();
+    std::uint32_t const offset32 = static_cast<std::uint32_t>(offset);
+    if(static_cast<std::streamoff>(offset32) != offset)
+        {
+        alarum()
+            << "database is too large to be stored in SOA v3 format."
+            << std::flush
+            ;
+        }
+    return offset32;
+}
+
 int database_impl::tables_count() const
 {
     return static_cast<int>(index_.size());
@@ -2686,6 +2781,7 @@ void database_impl::add_or_replace_table(table const& table)
     if(entry)
         {
         entry->table_ = table.impl_;
+        entry->modified_ = true;
         }
     else
         {
@@ -2938,45 +3034,126 @@ void database_impl::save(fs::path const& path)
 
 void database_impl::save(std::ostream& index_os, std::ostream& data_os)
 {
-    char index_record[e_index_pos_max] = {0};
-
     for(auto const& i : index_)
         {
         std::shared_ptr<table_impl> const t = do_get_table_impl(i);
 
         // The offset of this table is just the current position of the output
-        // stream, so get it before it changes and check that it is still
-        // representable as a 4 byte offset (i.e. the file is less than 4GiB).
-        std::streamoff const offset = data_os.tellp();
-        std::uint32_t const offset32 = static_cast<std::uint32_t>(offset);
-        if(static_cast<std::streamoff>(offset32) != offset)
+        // stream, so get it before it changes.
+        std::uint32_t const offset = get_output_offset(data_os);
+
+        write_index_record(index_os, t->number(), t->name(), offset);
+
+        t->write_as_binary(data_os);
+        }
+}
+
+// Unlike save(), this function doesn't rewrite the tables that haven't been
+// modified: it only appends new and replaced tables to the existing data
+// file, and then replaces the index file with one pointing to them. Until
+// the index is replaced, the original index still describes the original
+// tables, which are left intact, so an error at any point leaves a valid
+// database (with, at worst, some unreferenced data at the end of the data
+// file). The space occupied by replaced or deleted tables is not reclaimed
+// until the database is compacted by saving it with save().
+void database_impl::save_in_place(fs::path const& path)
+{
+    if(path_.empty() || get_data_path(path) != get_data_path(path_))
+        {
+        alarum()
+            << "only the database '" << path_ << "' from which the tables"
+            << " were read can be updated in place"
+            << std::flush
+            ;
+        }
+
+    fs::path const data_path = get_data_path(path);
+    fs::path const index_path = get_index_path(path);
+
+    std::vector<std::uint32_t> offsets;
+    offsets.reserve(index_.size());
+    {
+    fs::ofstream data_os
+        (data_path
+        ,std::ios_base::in | std::ios_base::out | std::ios_base::binary
+        );
+    if(!data_os) alarum() << "Unable to open '" << data_path << "'." << LMI_FLUSH;
+    data_os.seekp(0, std::ios_base::end);
+
+    for(auto const& i : index_)
+        {
+        if(i.modified_)
             {
-            alarum()
-                << "database is too large to be stored in SOA v3 format."
-                << std::flush
-                ;
+            offsets.push_back(get_output_offset(data_os));
+            i.table_->write_as_binary(data_os);
+            }
+        else
+            {
+            offsets.push_back(i.offset_);
             }
+        }
 
-        to_bytes(&index_record[e_index_pos_number], t->number());
+    data_os.close();
+    if(!data_os)
+        {
+        alarum()
+            << "failed to append to the database file \"" << data_path << "\""
+            << std::flush
+            ;
+        }
+    }
 
-        // We need to pad the name with NUL bytes if it's shorter than maximum
-        // length, so use strncpy() to do it.
-        strncpy
-            (&index_record[e_index_pos_name]
-            ,t->name().c_str()
-            ,e_index_pos_offset - e_index_pos_name - 1
-            );
+    // The new index refers to the appended tables, so they must reach the
+    // disk before it does: otherwise, a crash soon after the rename below
+    // could leave an index pointing past the end of the data file.
+    sync_to_disk(data_path);
 
-        // However (mainly for compatibility with the existing files as this
-        // code doesn't rely on it) the name still has to be NUL-terminated, in
-        // spite of being fixed size, so ensure this is the case.
-        index_record[e_index_pos_offset - 1] = '\0';
+    fs::path const temp_path = unique_filepath(index_path, ".ndx.tmp");
+    try
+        {
+        fs::ofstream index_os(temp_path, ios_out_trunc_binary());
+        if(!index_os) alarum() << "Unable to open '" << temp_path << "'." << LMI_FLUSH;
+        for(std::size_t j = 0; j != index_.size(); ++j)
+            {
+            IndexEntry const& e = index_[j];
+            write_index_record
+                (index_os
+                ,e.number_
+                ,e.modified_ ? e.table_->name() : e.name_
+                ,offsets[j]
+                );
+            }
+        index_os.close();
+        if(!index_os)
+            {
+            alarum()
+                << "failed to close the output index file \"" << temp_path << "\""
+                << std::flush
+                ;
+            }
 
-        to_bytes(&index_record[e_index_pos_offset], offset32);
+        // Renaming replaces the original index atomically.
+        sync_to_disk(temp_path);
+        fs::rename(temp_path, index_path);
+        }
+    catch(...)
+        {
+        remove_nothrow(temp_path);
+        throw;
+        }
 
-        stream_write(index_os, index_record, sizeof(index_record));
+    fs::path const directory = index_path.parent_path();
+    sync_to_disk(directory.empty() ? fs::path(".") : directory);
 
-        t->write_as_binary(data_os);
+    for(std::size_t j = 0; j != index_.size(); ++j)
+        {
+        IndexEntry& e = index_[j];
+        if(e.modified_)
+            {
+            e.name_     = e.table_->name();
+            e.offset_   = offsets[j];
+            e.modified_ = false;
+            }
         }
 }
 
@@ -3144,6 +3321,23 @@ void database::save(fs::path const& path)
         }
 }
 
+void database::save_in_place(fs::path const& path)
+{
+    try
+        {
+        return impl_->save_in_place(path);
+        }
+    catch(std::runtime_error const& e)
+        {
+        alarum()
+            << "Error updating database '" << path << "' in place: "
+            << e.what()
+            << "."
+            << LMI_FLUSH
+            ;
+        }
+}
+
 void database::save(std::ostream& index_os, std::ostream& data_os)
 {
     try
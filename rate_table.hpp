@@ -179,6 +179,16 @@ class database final
     void save(fs::path const& path);
     void save(std::ostream& index_os, std::ostream& data_os);
 
+    // Save the changes made to the database read from the given path, which
+    // must not be different, without rewriting the tables that are unchanged.
+    //
+    // New and replaced tables are appended to the .dat file, which is synced
+    // to disk before the .ndx file is atomically replaced with one referring
+    // to them, so that the database remains valid even if an error or a crash
+    // occurs. Space occupied by the replaced or deleted tables is not
+    // reclaimed: call save() to compact the database.
+    void save_in_place(fs::path const& path);
+
   private:
     database(database const&) = delete;
     database& operator=(database const&) = delete;
@@ -33,6 +33,7 @@
 #include <iomanip>                      // setw(), setfill()
 #include <ios>
 #include <sstream>
+#include <string>
 #include <stdexcept>
 #include <streambuf>
 
@@ -392,6 +393,95 @@ void test_delete()
     LMI_TEST_EQUAL(db_tmp.tables_count(), initial_count - 2);
 }
 
+namespace
+{
+/// Minimal valid SOA table with the given number, and a name.
+
+table numbered_table(int number)
+{
+    std::string const text =
+          "Table name: Table " + std::to_string(number) + "\n"
+        + "Table number: " + std::to_string(number) + "\n"
+        + simple_table_text.substr(simple_table_text.find('\n') + 1)
+        ;
+    return table::read_from_text(text);
+}
+} // Unnamed namespace.
+
+void test_save_in_place()
+{
+    test_file_eraser erase_ndx0("eraseme0.ndx");
+    test_file_eraser erase_dat0("eraseme0.dat");
+    test_file_eraser erase_ndx1("eraseme1.ndx");
+    test_file_eraser erase_dat1("eraseme1.dat");
+
+    {
+    database db;
+    db.append_table(numbered_table(1));
+    db.append_table(numbered_table(2));
+    db.save("eraseme0");
+    }
+    auto const ndx_size = fs::file_size("eraseme0.ndx");
+    auto const dat_size = fs::file_size("eraseme0.dat");
+
+    table replacement = numbered_table(2);
+    replacement.name("Replaced");
+
+    {
+    database db("eraseme0");
+    db.add_or_replace_table(replacement);
+    db.append_table(numbered_table(3));
+
+    LMI_TEST_THROW
+        (db.save_in_place("eraseme1")
+        ,std::runtime_error
+        ,lmi_test::what_regex("can be updated in place")
+        );
+
+    db.save_in_place("eraseme0");
+    // The database remains usable after saving.
+    LMI_TEST(replacement == db.find_table(table::Number(2)));
+    }
+
+    // Only the two new tables were appended; one index record was added.
+    std::ostringstream index_os;
+    std::ostringstream data_os;
+    {
+    database db;
+    db.append_table(replacement);
+    db.append_table(numbered_table(3));
+    db.save(index_os, data_os);
+    }
+    auto const appended_size = data_os.str().size();
+    LMI_TEST_EQUAL(ndx_size + ndx_size / 2 , fs::file_size("eraseme0.ndx"));
+    LMI_TEST_EQUAL(dat_size + appended_size, fs::file_size("eraseme0.dat"));
+
+    {
+    database db("eraseme0");
+    LMI_TEST_EQUAL(3, db.tables_count());
+    LMI_TEST(numbered_table(1) == db.find_table(table::Number(1)));
+    LMI_TEST(replacement       == db.find_table(table::Number(2)));
+    LMI_TEST(numbered_table(3) == db.find_table(table::Number(3)));
+    db.delete_table(table::Number(1));
+    db.save_in_place("eraseme0");
+    }
+
+    // Compacting by saving yields the same files as saving afresh.
+    {
+    database db("eraseme0");
+    LMI_TEST_EQUAL(2, db.tables_count());
+    db.save("eraseme0");
+    }
+    {
+    database db;
+    db.append_table(replacement);
+    db.append_table(numbered_table(3));
+    db.save("eraseme1");
+    }
+    LMI_TEST(files_are_identical("eraseme0.ndx", "eraseme1.ndx"));
+    LMI_TEST(files_are_identical("eraseme0.dat", "eraseme1.dat"));
+}
+
 void do_test_copy(std::string const& path)
 {
     database db_orig(path);
@@ -486,6 +576,7 @@ int test_main(int, char*[])
     test_from_text();
     test_add_table();
     test_delete();
+    test_save_in_place();
     test_copy();
     test_decimal_deduction();
 
@@ -25,11 +25,14 @@
 #include "getopt.hpp"
 #include "license.hpp"
 #include "main_common.hpp"
+#include "parallel_for.hpp"
 #include "path.hpp"
 #include "path_utility.hpp"
 #include "rate_table.hpp"
+#include "ssize_lmi.hpp"
 
 #include <algorithm>                    // sort()
+#include <cstdint>                      // uintmax_t
 #include <cstdio>                       // fflush()
 #include <cstdlib>                      // atoi()
 #include <exception>
@@ -38,6 +41,7 @@
 #include <iostream>                     // cout, cerr
 #include <map>
 #include <memory>                       // unique_ptr
+#include <optional>
 #include <ostream>                      // endl
 #include <sstream>
 #include <stdexcept>
@@ -104,6 +108,45 @@ void list_tables(fs::path const& database_filename)
         }
 }
 
+/// Read tables from text files, parsing several files at once.
+///
+/// If any file cannot be read, the error for the first such file, in
+/// the order given, is reported, just as if the files had been read
+/// one at a time.
+
+std::vector<table> read_tables_from_text(std::vector<fs::path> const& paths)
+{
+    int const n = lmi::ssize(paths);
+    std::vector<std::optional<table>> tables(paths.size());
+    std::vector<std::exception_ptr> errors(paths.size());
+    parallel_for
+        (n
+        ,[&](int i)
+            {
+            try
+                {
+                tables[i] = table::read_from_text(paths[i]);
+                }
+            catch(...)
+                {
+                errors[i] = std::current_exception();
+                }
+            }
+        );
+
+    std::vector<table> z;
+    z.reserve(paths.size());
+    for(int i = 0; i < n; ++i)
+        {
+        if(errors[i])
+            {
+            std::rethrow_exception(errors[i]);
+            }
+        z.push_back(*tables[i]);
+        }
+    return z;
+}
+
 /// Merge 'path_to_merge' into 'database_filename'.
 ///
 /// If no 'database_filename' exists, create it, as an incidental side
@@ -115,14 +158,20 @@ void list_tables(fs::path const& database_filename)
 /// a directory, then merge all '*.rates' files in that directory.
 /// Rationale:
 ///   https://lists.nongnu.org/archive/html/lmi/2016-11/msg00025.html
+///
+/// If 'in_place' is true, and the database already exists, then only
+/// the merged tables are written, at the end of the existing data
+/// file, and only the index is rewritten: see '--compact'.
 
 void merge
     (fs::path const& database_filename
     ,fs::path const& path_to_merge
+    ,bool            in_place
     )
 {
+    bool const exists = database::exists(database_filename);
     std::unique_ptr<database> table_file;
-    if(database::exists(database_filename))
+    if(exists)
         {
         table_file.reset(::new database(database_filename));
         }
@@ -151,9 +200,8 @@ void merge
                 }
             }
         std::sort(table_names.begin(), table_names.end());
-        for(auto const& j : table_names)
+        for(auto const& t : read_tables_from_text(table_names))
             {
-            table const& t = table::read_from_text(j);
             table_file->add_or_replace_table(t);
             ++count;
             }
@@ -165,11 +213,33 @@ void merge
         ++count;
         }
 
-    table_file->save(database_filename);
+    if(in_place && exists)
+        {
+        table_file->save_in_place(database_filename);
+        }
+    else
+        {
+        table_file->save(database_filename);
+        }
 
     std::cout << "Number of tables merged: " << count << "\n";
 }
 
+/// Rewrite a database, reclaiming space left by '--append'.
+
+void compact(fs::path const& database_filename)
+{
+    fs::path const data_path = fs::path{database_filename}.replace_extension(".dat");
+    std::uintmax_t const old_size = fs::file_size(data_path);
+    {
+    database table_file(database_filename);
+    table_file.save(database_filename);
+    }
+    std::uintmax_t const new_size = fs::file_size(data_path);
+
+    std::cout << "Bytes reclaimed: " << old_size - new_size << "\n";
+}
+
 void delete_table
     (fs::path database_filename
     ,int      table_number_to_delete
@@ -317,6 +387,34 @@ void rename_tables
     table_file.save(database_filename);
 }
 
+/// Check that a table can be converted to and from text losslessly.
+
+void verify_text_round_trip(table const& orig_table)
+{
+    auto const orig_text = orig_table.save_as_text();
+    table const& new_table = table::read_from_text(orig_text);
+    auto const new_text = new_table.save_as_text();
+    if(new_text != orig_text)
+        {
+        alarum()
+            << "After loading and saving the original table '\n"
+            << orig_text
+            << "' became '\n"
+            << new_text
+            << "'\n"
+            << LMI_FLUSH
+            ;
+        }
+    if(new_table != orig_table)
+        {
+        alarum()
+            << "After loading and saving the original table \n"
+            << "binary contents differed.\n"
+            << LMI_FLUSH
+            ;
+        }
+}
+
 /// Return the number of tables that failed verification.
 
 int verify(fs::path const& database_filename)
@@ -328,41 +426,49 @@ int verify(fs::path const& database_filename)
     // Check that each table can be loaded and converted to/from text
     // losslessly.
     //
-    // Make the output ordered by table numbers.
+    // Tables are loaded serially, because the database reads them on
+    // demand from a single stream, but are then verified in parallel.
+    // Diagnostics are collected and written in order of table number.
     auto const numbers = get_all_tables_numbers(orig_db);
-    for(auto const& num : numbers)
+    int const n = lmi::ssize(numbers);
+    std::vector<std::optional<table>> tables(numbers.size());
+    std::vector<std::string> failures(numbers.size());
+    for(int i = 0; i < n; ++i)
         {
         try
             {
-            table const& orig_table = orig_db.find_table(num);
-            auto const orig_text = orig_table.save_as_text();
-            table const& new_table = table::read_from_text(orig_text);
-            auto const new_text = new_table.save_as_text();
-            if(new_text != orig_text)
+            tables[i] = orig_db.find_table(numbers[i]);
+            }
+        catch(std::exception const& e)
+            {
+            failures[i] = e.what();
+            }
+        }
+    parallel_for
+        (n
+        ,[&](int i)
+            {
+            if(!tables[i])
                 {
-                alarum()
-                    << "After loading and saving the original table '\n"
-                    << orig_text
-                    << "' became '\n"
-                    << new_text
-                    << "'\n"
-                    << LMI_FLUSH
-                    ;
+                return;
                 }
-            if(new_table != orig_table)
+            try
                 {
-                alarum()
-                    << "After loading and saving the original table \n"
-                    << "binary contents differed.\n"
-                    << LMI_FLUSH
-                    ;
+                verify_text_round_trip(*tables[i]);
+                }
+            catch(std::exception const& e)
+                {
+                failures[i] = e.what();
                 }
             }
-        catch(std::exception const& e)
+        );
+    for(int i = 0; i < n; ++i)
+        {
+        if(!tables[i] || !failures[i].empty())
             {
             std::cout
-                << "Verification failed for table #" << num << ": "
-                << e.what()
+                << "Verification failed for table #" << numbers[i] << ": "
+                << failures[i]
                 << std::endl
                 ;
 
@@ -449,6 +555,8 @@ int try_main(int argc, char* argv[])
         {"crc"         ,NO_ARG   ,nullptr ,'c' ,nullptr ,"show CRCs of all tables"},
         {"list"        ,NO_ARG   ,nullptr ,'t' ,nullptr ,"list all tables"},
         {"merge=PATH"  ,REQD_ARG ,nullptr ,'m' ,nullptr ,"merge PATH (file or dir) into database"},
+        {"append=PATH" ,REQD_ARG ,nullptr ,'p' ,nullptr ,"merge PATH, appending to database in place"},
+        {"compact"     ,NO_ARG   ,nullptr ,'k' ,nullptr ,"reclaim space left by --append"},
         {"extract=n"   ,REQD_ARG ,nullptr ,'e' ,nullptr ,"extract table #n into '0000n.rates'"},
         {"extract-all" ,NO_ARG   ,nullptr ,'x' ,nullptr ,"extract all tables to '.rates' files"},
         {"rename=FILE" ,REQD_ARG ,nullptr ,'r' ,nullptr ,"rename tables from FILE"},
@@ -461,6 +569,8 @@ int try_main(int argc, char* argv[])
     bool run_crc          = false;
     bool run_list         = false;
     bool run_merge        = false;
+    bool run_append       = false;
+    bool run_compact      = false;
     bool run_delete       = false;
     bool run_extract      = false;
     bool run_extract_all  = false;
@@ -542,6 +652,21 @@ int try_main(int argc, char* argv[])
             }
             break;
 
+          case 'p':
+            {
+            run_append = true;
+            ++num_to_do;
+            path_to_merge = getopt_long.optarg;
+            }
+            break;
+
+          case 'k':
+            {
+            run_compact = true;
+            ++num_to_do;
+            }
+            break;
+
           case 'd':
             {
             run_delete = true;
@@ -619,7 +744,8 @@ int try_main(int argc, char* argv[])
                 {
                 std::cerr
                     << "Please use exactly one of the following options:\n"
-                    << "--crc, --list, --rename, --merge, --extract or --verify.\n";
+                    << "--crc, --list, --rename, --merge, --append, --compact,\n"
+                    << "--extract or --verify.\n";
                 command_line_syntax_error = true;
                 }
             break;
@@ -695,7 +821,19 @@ int try_main(int argc, char* argv[])
 
     if(run_merge)
         {
-        merge(database_filename, path_to_merge);
+        merge(database_filename, path_to_merge, false);
+        return EXIT_SUCCESS;
+        }
+
+    if(run_append)
+        {
+        merge(database_filename, path_to_merge, true);
+        return EXIT_SUCCESS;
+        }
+
+    if(run_compact)
+        {
+        compact(database_filename);
         return EXIT_SUCCESS;
         }
 
@@ -0,0 +1,300 @@
+// Project one cell across many variants of its input.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "scenario_sweep.hpp"
+
+#include "account_value.hpp"
+#include "alert.hpp"
+#include "basic_values.hpp"             // is_rate_neutral()
+#include "contains.hpp"
+#include "custom_io_0.hpp"
+#include "custom_io_1.hpp"
+#include "fenv_guard.hpp"
+#include "input.hpp"
+#include "ledger.hpp"
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "parallel_for.hpp"
+#include "single_cell_document.hpp"
+#include "ssize_lmi.hpp"
+#include "value_cast.hpp"
+
+#include <algorithm>                    // all_of(), any_of(), replace()
+#include <exception>
+#include <fstream>
+#include <memory>                       // make_unique(), unique_ptr
+#include <ostream>
+#include <sstream>
+
+namespace
+{
+/// Split a line at each tab, keeping empty fields.
+
+std::vector<std::string> split_at_tabs(std::string const& s)
+{
+    std::vector<std::string> z;
+    std::string::size_type begin = 0;
+    for(;;)
+        {
+        std::string::size_type const end = s.find('\t', begin);
+        z.push_back(s.substr(begin, end - begin));
+        if(std::string::npos == end)
+            {
+            return z;
+            }
+        begin = 1 + end;
+        }
+}
+
+std::string one_line(std::string s)
+{
+    std::replace(s.begin(), s.end(), '\n', ' ');
+    return s;
+}
+
+bool is_rate_neutral(sweep_variant const& variant)
+{
+    return std::all_of
+        (variant.begin()
+        ,variant.end()
+        ,[](auto const& i) {return BasicValues::is_rate_neutral(i.first);}
+        );
+}
+
+} // Unnamed namespace.
+
+std::vector<sweep_variant> read_sweep_variants(fs::path const& file_path)
+{
+    std::ifstream ifs(file_path.string());
+    if(!ifs)
+        {
+        alarum() << "Cannot open sweep '" << file_path << "'." << LMI_FLUSH;
+        }
+
+    std::vector<std::string> names;
+    std::vector<sweep_variant> z;
+    std::string line;
+    for(int line_number = 1; std::getline(ifs, line); ++line_number)
+        {
+        if(!line.empty() && '\r' == line.back())
+            {
+            line.pop_back();
+            }
+        if(line.empty() || '#' == line.front())
+            {
+            continue;
+            }
+        std::vector<std::string> const fields = split_at_tabs(line);
+        if(names.empty())
+            {
+            names = fields;
+            continue;
+            }
+        if(fields.size() != names.size())
+            {
+            alarum()
+                << "Sweep '"
+                << file_path
+                << "', line "
+                << line_number
+                << ": "
+                << fields.size()
+                << " values for "
+                << names.size()
+                << " fields."
+                << LMI_FLUSH
+                ;
+            }
+        sweep_variant v;
+        for(int j = 0; j < lmi::ssize(names); ++j)
+            {
+            if(!fields[j].empty())
+                {
+                v.emplace_back(names[j], fields[j]);
+                }
+            }
+        z.push_back(v);
+        }
+    return z;
+}
+
+Input read_sweep_base(fs::path const& file_path)
+{
+    std::string const extension = file_path.extension().string();
+    Input z;
+    if(".ill" == extension)
+        {
+        z = single_cell_document(file_path.string()).input_data();
+        }
+    else if(".ini" == extension)
+        {
+        custom_io_0_read(z, file_path.string());
+        }
+    else if(".inix" == extension)
+        {
+        custom_io_1_read(z, file_path.string());
+        }
+    else
+        {
+        alarum()
+            << "'--sweep' needs '.ill', '.ini', or '.inix' files, not '"
+            << file_path
+            << "'."
+            << LMI_FLUSH
+            ;
+        }
+    return z;
+}
+
+std::vector<sweep_result> run_scenario_sweep
+    (Input                      const& base
+    ,std::vector<sweep_variant> const& variants
+    ,std::vector<std::string>   const& columns
+    ,int                               max_threads
+    )
+{
+    // The prototype is never projected: only its rates are used. If
+    // it can't be constructed, then every variant is constructed by
+    // itself, so that each records its own diagnostic.
+    std::unique_ptr<AccountValue> prototype;
+    if(std::any_of(variants.begin(), variants.end(), is_rate_neutral))
+        {
+        try
+            {
+            fenv_guard fg;
+            prototype = std::make_unique<AccountValue>(base);
+            }
+        catch(std::exception const&)
+            {
+            prototype.reset();
+            }
+        }
+
+    std::vector<sweep_result> results(variants.size());
+    parallel_for
+        (lmi::ssize(variants)
+        ,[&](int j)
+            {
+            sweep_variant const& v = variants[j];
+            sweep_result& r = results[j];
+            try
+                {
+                Input input(base);
+                for(auto const& i : v)
+                    {
+                    input[i.first] = i.second;
+                    }
+                fenv_guard fg;
+                std::unique_ptr<AccountValue> const av =
+                      prototype && is_rate_neutral(v)
+                    ? std::make_unique<AccountValue>(input, *prototype)
+                    : std::make_unique<AccountValue>(input)
+                    ;
+                av->RunAV();
+                std::shared_ptr<Ledger const> const ledger = av->ledger_from_av();
+                for(auto const& c : columns)
+                    {
+                    r.values.push_back(sweep_value(*ledger, c));
+                    }
+                r.succeeded = true;
+                r.status = "ok";
+                }
+            catch(std::exception const& e)
+                {
+                r.values.clear();
+                r.status = "failed: " + one_line(e.what());
+                }
+            catch(...)
+                {
+                r.values.clear();
+                r.status = "failed: Unknown exception.";
+                }
+            }
+        ,max_threads
+        );
+    return results;
+}
+
+std::string sweep_value(Ledger const& ledger, std::string const& column)
+{
+    LedgerBase const& variant   = ledger.GetCurrFull();
+    LedgerBase const& invariant = ledger.GetLedgerInvariant();
+
+    std::string::size_type const at = column.find('@');
+    if(std::string::npos == at)
+        {
+        bool const is_variant = contains(variant.all_scalars(), column);
+        return (is_variant ? variant : invariant).value_str(column);
+        }
+
+    std::string const name = column.substr(0, at);
+    int const year = value_cast<int>(column.substr(1 + at));
+    LedgerBase const& z = contains(variant.all_vectors(), name) ? variant : invariant;
+    auto const i = z.all_vectors().find(name);
+    if(z.all_vectors().end() == i)
+        {
+        alarum() << "Ledger has no vector '" << name << "'." << LMI_FLUSH;
+        }
+    if(year < 1 || lmi::ssize(*i->second) < year)
+        {
+        alarum()
+            << "Column '"
+            << column
+            << "': policy year must be from 1 to "
+            << lmi::ssize(*i->second)
+            << "."
+            << LMI_FLUSH
+            ;
+        }
+    return z.value_str(name, year - 1);
+}
+void write_sweep_results
+    (std::ostream&                    os
+    ,std::vector<std::string>  const& columns
+    ,std::vector<sweep_result> const& results
+    )
+{
+    std::ostringstream oss;
+    oss << "Variant";
+    for(auto const& c : columns)
+        {
+        oss << '\t' << c;
+        }
+    oss << "\tStatus\n";
+    for(int j = 0; j < lmi::ssize(results); ++j)
+        {
+        sweep_result const& r = results[j];
+        oss << 1 + j;
+        for(int k = 0; k < lmi::ssize(columns); ++k)
+            {
+            oss << '\t';
+            if(r.succeeded)
+                {
+                oss << r.values[k];
+                }
+            }
+        oss << '\t' << r.status << '\n';
+        }
+    os << oss.str() << std::flush;
+}
@@ -0,0 +1,109 @@
+// Project one cell across many variants of its input.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#ifndef scenario_sweep_hpp
+#define scenario_sweep_hpp
+
+#include "config.hpp"
+
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <iosfwd>
+#include <string>
+#include <utility>                      // pair
+#include <vector>
+
+class Input;
+class Ledger;
+
+/// One variant of a sweep: input fields to override, by name, with
+/// values as they would be entered--e.g., "GeneralAccountRate" and
+/// "0.05", or "Payment" and "10000 retirement; 0".
+
+typedef std::vector<std::pair<std::string,std::string>> sweep_variant;
+
+/// Ledger values for one variant of a sweep, in the order of the
+/// columns requested.
+
+struct sweep_result
+{
+    std::vector<std::string> values;
+    bool                     succeeded {false};
+    std::string              status    {};
+};
+
+/// Read variants from a tab-delimited file. The first line names
+/// input fields; each later line gives their values for one variant.
+/// An empty value leaves that field as it is in the base input.
+/// Blank lines, and lines beginning with '#', are ignored.
+
+LMI_SO std::vector<sweep_variant> read_sweep_variants(fs::path const&);
+
+/// Read the base input for a sweep from an '.ill', '.ini', or
+/// '.inix' file.
+
+LMI_SO Input read_sweep_base(fs::path const&);
+
+/// Project a base input with each variant's overrides, and return
+/// selected ledger values for each.
+///
+/// Columns name ledger values: a scalar by its name alone (e.g.,
+/// "LapseYear"), and a vector by its name and a policy year counted
+/// from one (e.g., "CSVNet@10"). Values are taken from the current
+/// basis where it has them, and otherwise from the invariant ledger.
+///
+/// Variants that override only fields that don't affect rates (see
+/// BasicValues::is_rate_neutral()) share one prototype's mortality
+/// rates, loads, and 7702 interest rates, which are therefore
+/// computed only once. Any other variant is projected exactly as it
+/// would be by itself. Product files and tables are cached, so every
+/// variant shares them in either case.
+///
+/// Variants are projected concurrently, on up to 'max_threads'
+/// threads (all available cores if that argument is not positive).
+/// An exception thrown by one variant is recorded in its result, and
+/// does not prevent other variants from being projected.
+
+LMI_SO std::vector<sweep_result> run_scenario_sweep
+    (Input                      const& base
+    ,std::vector<sweep_variant> const& variants
+    ,std::vector<std::string>   const& columns
+    ,int                               max_threads = 0
+    );
+
+/// One ledger value named by a column, as run_scenario_sweep() finds
+/// it. A standalone projection's values can thus be compared to a
+/// sweep's.
+
+LMI_SO std::string sweep_value(Ledger const&, std::string const& column);
+
+/// Write a sweep's results as a tab-delimited matrix: one row for
+/// each variant, numbered from one, and one column for each value.
+
+LMI_SO void write_sweep_results
+    (std::ostream&                    os
+    ,std::vector<std::string>  const& columns
+    ,std::vector<sweep_result> const& results
+    );
+
+#endif // scenario_sweep_hpp
@@ -0,0 +1,684 @@
+// Actuarial tables shared among processes.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "shared_table_store.hpp"
+
+#include "actuarial_table.hpp"
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "bourn_cast.hpp"
+#include "deserialize_cast.hpp"
+#include "miscellany.hpp"               // ios_in_binary()
+#include "ssize_lmi.hpp"
+
+#include <algorithm>                    // sort(), unique()
+#include <atomic>                       // atomic_thread_fence()
+#include <cstddef>                      // offsetof
+#include <cstdint>
+#include <cstring>                      // memcmp(), memcpy(), strerror()
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <new>                          // launder()
+#include <ranges>                       // partition_point(), views::iota
+#include <string_view>
+#include <utility>                      // make_pair(), move(), pair
+
+#if defined LMI_POSIX
+#   include <cerrno>                    // errno
+#   include <fcntl.h>                   // O_CREAT, O_EXCL, O_RDONLY, O_RDWR
+#   include <sys/mman.h>                // mmap(), munmap(), shm_open()...
+#   include <sys/stat.h>                // fchmod(), fstat(), stat()
+#   include <unistd.h>                  // close(), ftruncate(), geteuid()
+#endif // defined LMI_POSIX
+
+char const* const actuarial_table_segment_name = "/lmi_actuarial_tables";
+
+#if defined LMI_POSIX
+
+namespace
+{
+/// Published tables are looked up by the absolute path of their
+/// files, without extension.
+
+std::string key_of(std::string const& filename)
+{
+    fs::path z = fs::absolute(filename);
+    z.replace_extension();
+    return z.string();
+}
+
+/// Table numbers in a '.ndx' file, as actuarial_table::find_table()
+/// reads them.
+
+std::vector<int> table_numbers(std::string const& filename)
+{
+    fs::path index_path(filename);
+    index_path.replace_extension(".ndx");
+    std::ifstream ifs(index_path.string(), ios_in_binary());
+    if(!ifs)
+        {
+        alarum() << "Cannot open '" << index_path << "'." << LMI_FLUSH;
+        }
+
+    std::vector<int> z;
+    int const index_record_length(58);
+    char index_record[index_record_length] = {0};
+    while(ifs.read(index_record, index_record_length))
+        {
+        int const n = deserialize_cast<std::int32_t>(index_record);
+        if(0 != n)
+            {
+            z.push_back(n);
+            }
+        }
+    return z;
+}
+
+/// Identity of a file: if any of these changes, so may its contents.
+///
+/// Unlike a checksum, it costs only a stat() call, so a process that
+/// attaches to a segment need not read the files it vouches for.
+
+struct file_identity
+{
+    std::uint64_t device;
+    std::uint64_t inode;
+    std::uint64_t size;
+    std::int64_t  mtime_sec;
+    std::int64_t  mtime_nsec;
+
+    bool operator==(file_identity const&) const = default;
+};
+
+std::optional<file_identity> identity_of(std::string const& key, char const* extension)
+{
+    fs::path path(key);
+    path.replace_extension(extension);
+    struct stat st;
+    if(0 != ::stat(path.string().c_str(), &st))
+        {
+        return {};
+        }
+    return file_identity
+        {bourn_cast<std::uint64_t>(st.st_dev)
+        ,bourn_cast<std::uint64_t>(st.st_ino)
+        ,bourn_cast<std::uint64_t>(st.st_size)
+        ,bourn_cast<std::int64_t >(st.st_mtim.tv_sec)
+        ,bourn_cast<std::int64_t >(st.st_mtim.tv_nsec)
+        };
+}
+
+/// Layout of a published segment:
+///   segment_header
+///   file_record [file_count], sorted by name
+///   table_record[table_count], sorted by file and table number
+///   names of files
+///   values of tables, aligned for double
+/// All offsets are in bytes from the beginning of the segment.
+///
+/// The magic string is written last, so a segment that is still
+/// being written is never used.
+
+char const segment_magic[8] = {'l', 'm', 'i', '.', 's', 'h', 'm', '\n'};
+
+std::uint32_t const segment_version = 2;
+
+struct segment_header
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t file_count;
+    std::uint32_t table_count;
+    std::uint32_t reserved;
+    std::uint64_t size;
+};
+
+struct file_record
+{
+    std::uint64_t name_offset;
+    std::uint32_t name_length;
+    std::uint32_t reserved;
+    file_identity index;
+    file_identity data;
+};
+
+struct table_record
+{
+    std::uint32_t file_index;
+    std::int32_t  table_number;
+    std::int32_t  table_type;
+    std::int32_t  min_age;
+    std::int32_t  max_age;
+    std::int32_t  select_period;
+    std::int32_t  max_select_age;
+    std::int32_t  reserved;
+    std::uint64_t data_offset;
+    std::uint64_t data_count;
+    std::uint64_t select_offset;
+    std::uint64_t select_count;
+};
+
+std::size_t aligned(std::size_t n)
+{
+    return (n + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+}
+
+/// Whether a table record describes a table that actuarial_table
+/// could have read: its value counts follow from its ages, as they
+/// do in actuarial_table::parse_table().
+
+bool is_consistent(table_record const& r)
+{
+    if
+        (  !('A' == r.table_type || 'D' == r.table_type || 'S' == r.table_type)
+        || r.min_age < 0
+        || r.max_age < r.min_age
+        || r.select_period < 0
+        || r.max_select_age < r.min_age
+        )
+        {
+        return false;
+        }
+    std::int64_t const n = 1 + std::int64_t {r.max_age} - r.min_age;
+    std::int64_t data_count = n;
+    if(r.select_period)
+        {
+        data_count =
+              (1 + std::int64_t {r.max_select_age} - r.min_age) * r.select_period
+          +   n - r.select_period
+          ;
+        }
+    std::int64_t const select_count = ('S' == r.table_type) ? n * (n + 1) / 2 : 0;
+    return
+           static_cast<std::uint64_t>(data_count  ) == r.data_count
+        && static_cast<std::uint64_t>(select_count) == r.select_count
+        ;
+}
+
+/// View a segment's records and values.
+///
+/// Records are copied out of the segment rather than addressed in
+/// place, because their offsets are not known to be suitably aligned
+/// for their types. Values are addressed in place, through a pointer
+/// to double derived from the segment's (page-aligned) address; their
+/// offsets are multiples of sizeof(double).
+///
+/// A view that would lie even partly outside the segment is empty,
+/// so a malformed segment is never read beyond its end.
+
+class segment_reader final
+{
+  public:
+    segment_reader(void const* segment, std::size_t size)
+        :segment_ {segment}
+        ,size_    {size}
+    {
+        if(sizeof(segment_header) <= size_)
+            {
+            std::memcpy(&header_, segment_, sizeof header_);
+            }
+    }
+
+    bool is_valid() const
+    {
+        std::uint64_t const records_end =
+              sizeof(segment_header)
+            + std::uint64_t {header_.file_count } * sizeof(file_record )
+            + std::uint64_t {header_.table_count} * sizeof(table_record)
+            ;
+        return
+               sizeof(segment_header) <= size_
+            && 0 == std::memcmp(header_.magic, segment_magic, sizeof segment_magic)
+            && segment_version == header_.version
+            && size_ == header_.size
+            && records_end <= size_
+            ;
+    }
+
+    std::uint32_t file_count () const {return header_.file_count ;}
+    std::uint32_t table_count() const {return header_.table_count;}
+
+    /// Precondition: is_valid() and j < file_count().
+
+    file_record file(std::uint32_t j) const
+    {
+        LMI_ASSERT(j < header_.file_count);
+        return record<file_record>(sizeof(segment_header) + j * sizeof(file_record));
+    }
+
+    /// Precondition: is_valid() and j < table_count().
+
+    table_record table(std::uint32_t j) const
+    {
+        LMI_ASSERT(j < header_.table_count);
+        std::uint64_t const offset =
+              sizeof(segment_header)
+            + std::uint64_t {header_.file_count} * sizeof(file_record)
+            + j * sizeof(table_record)
+            ;
+        return record<table_record>(offset);
+    }
+
+    std::string_view name(file_record const& f) const
+    {
+        if(!fits(f.name_offset, f.name_length, 1))
+            {
+            return {};
+            }
+        return {bytes() + f.name_offset, f.name_length};
+    }
+
+    std::span<double const> values(std::uint64_t offset, std::uint64_t count) const
+    {
+        if(!fits(offset, count, sizeof(double)) || 0 != offset % sizeof(double))
+            {
+            return {};
+            }
+        double const* const p = static_cast<double const*>(segment_) + offset / sizeof(double);
+        return {std::launder(p), bourn_cast<std::size_t>(count)};
+    }
+
+  private:
+    char const* bytes() const {return static_cast<char const*>(segment_);}
+
+    bool fits(std::uint64_t offset, std::uint64_t count, std::size_t size) const
+    {
+        return offset <= size_ && count <= (size_ - offset) / size;
+    }
+
+    template<typename T>
+    T record(std::uint64_t offset) const
+    {
+        LMI_ASSERT(fits(offset, 1, sizeof(T)));
+        T z;
+        std::memcpy(&z, bytes() + offset, sizeof z);
+        return z;
+    }
+
+    void const*    segment_;
+    std::size_t    size_;
+    segment_header header_ {};
+};
+
+/// Close a file descriptor when it goes out of scope.
+
+class descriptor final
+{
+  public:
+    explicit descriptor(int fd) : fd_ {fd} {}
+    ~descriptor() {if(0 <= fd_) ::close(fd_);}
+
+    int get() const {return fd_;}
+
+  private:
+    descriptor(descriptor const&) = delete;
+    descriptor& operator=(descriptor const&) = delete;
+
+    int fd_;
+};
+
+std::shared_ptr<void const> map_segment(int fd, std::size_t size, int protection)
+{
+    void* const p = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+    if(MAP_FAILED == p)
+        {
+        return {};
+        }
+    return std::shared_ptr<void const>(p, [size](void const* q)
+        {::munmap(const_cast<void*>(q), size);}
+        );
+}
+
+/// Attach to a published segment, or return null if there is none.
+///
+/// Only a segment that this user published, and that no one else
+/// can write, is trusted.
+///
+/// The segment is mapped only once in each process, until it is
+/// published again.
+
+std::shared_ptr<void const> attach(char const* segment_name)
+{
+    static std::map<std::string,std::pair<ino_t,std::shared_ptr<void const>>> attached;
+    static std::mutex mutex;
+
+    descriptor const fd(::shm_open(segment_name, O_RDONLY, 0));
+    struct stat st;
+    if(fd.get() < 0 || 0 != ::fstat(fd.get(), &st))
+        {
+        return {};
+        }
+    if(::geteuid() != st.st_uid || 0600 != (st.st_mode & 07777))
+        {
+        return {};
+        }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& a = attached[segment_name];
+    if(a.second && st.st_ino == a.first)
+        {
+        return a.second;
+        }
+
+    std::size_t const size = bourn_cast<std::size_t>(st.st_size);
+    if(size < sizeof(segment_header))
+        {
+        return {};
+        }
+    std::shared_ptr<void const> const z = map_segment(fd.get(), size, PROT_READ);
+    if(!z || !segment_reader(z.get(), size).is_valid())
+        {
+        return {};
+        }
+    a = {st.st_ino, z};
+    return z;
+}
+} // Unnamed namespace.
+
+int publish_actuarial_tables
+    (std::vector<std::string> const& filenames
+    ,char const*                     segment_name
+    )
+{
+    struct file_tables
+    {
+        std::string                                         key;
+        file_identity                                       index;
+        file_identity                                       data;
+        std::vector<std::shared_ptr<actuarial_table const>> tables;
+    };
+
+    std::vector<std::string> keys;
+    for(auto const& i : filenames)
+        {
+        keys.push_back(key_of(i));
+        }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    // Read everything before creating the segment, so that a table
+    // that cannot be read leaves any earlier segment in place.
+    //
+    // Files are identified before they're read: if either is written
+    // while it's being read, its identity no longer matches, and the
+    // tables published here are never used.
+    std::vector<file_tables> files;
+    std::size_t names_size = 0;
+    std::size_t value_count = 0;
+    int table_count = 0;
+    for(auto const& key : keys)
+        {
+        auto const index = identity_of(key, ".ndx");
+        auto const data  = identity_of(key, ".dat");
+        if(!index || !data)
+            {
+            alarum() << "Cannot find table file '" << key << "'." << LMI_FLUSH;
+            }
+        file_tables f {key, *index, *data, {}};
+        std::vector<int> numbers = table_numbers(key);
+        std::sort(numbers.begin(), numbers.end());
+        numbers.erase(std::unique(numbers.begin(), numbers.end()), numbers.end());
+        for(auto const& n : numbers)
+            {
+            auto const t = std::make_shared<actuarial_table const>(key, n);
+            value_count += t->stored_values().size() + t->tabulated_select_values().size();
+            f.tables.push_back(t);
+            }
+        names_size  += key.size();
+        table_count += lmi::ssize(f.tables);
+        files.push_back(std::move(f));
+        }
+
+    std::size_t const names_offset =
+          sizeof(segment_header)
+        + files.size() * sizeof(file_record)
+        + bourn_cast<std::size_t>(table_count) * sizeof(table_record)
+        ;
+    std::size_t const values_offset = aligned(names_offset + names_size);
+    std::size_t const size = values_offset + value_count * sizeof(double);
+
+    // Only this user may read the segment: attach() rejects any other
+    // mode, so set it explicitly whatever the umask.
+    ::shm_unlink(segment_name);
+    descriptor const fd(::shm_open(segment_name, O_CREAT | O_EXCL | O_RDWR, 0600));
+    if
+        (  fd.get() < 0
+        || 0 != ::fchmod(fd.get(), 0600)
+        || 0 != ::ftruncate(fd.get(), bourn_cast<off_t>(size))
+        )
+        {
+        alarum()
+            << "Cannot create shared memory '"
+            << segment_name
+            << "': "
+            << std::strerror(errno)
+            << LMI_FLUSH
+            ;
+        }
+    std::shared_ptr<void const> const segment = map_segment(fd.get(), size, PROT_READ | PROT_WRITE);
+    if(!segment)
+        {
+        ::shm_unlink(segment_name);
+        alarum()
+            << "Cannot map shared memory '"
+            << segment_name
+            << "': "
+            << std::strerror(errno)
+            << LMI_FLUSH
+            ;
+        }
+
+    // Records are copied into place, because their offsets are not
+    // known to be suitably aligned for their types.
+    char* const base = static_cast<char*>(const_cast<void*>(segment.get()));
+    std::size_t record_offset = sizeof(segment_header);
+    auto write_record = [&](auto const& r)
+        {
+        std::memcpy(base + record_offset, &r, sizeof r);
+        record_offset += sizeof r;
+        };
+    std::size_t name_offset  = names_offset;
+    std::size_t value_offset = values_offset;
+    auto write_values = [&](std::span<double const> v)
+        {
+        std::memcpy(base + value_offset, v.data(), v.size_bytes());
+        std::uint64_t const z = value_offset;
+        value_offset += v.size_bytes();
+        return z;
+        };
+    for(auto const& f : files)
+        {
+        std::memcpy(base + name_offset, f.key.data(), f.key.size());
+        write_record
+            (file_record
+                {name_offset
+                ,bourn_cast<std::uint32_t>(f.key.size())
+                ,0
+                ,f.index
+                ,f.data
+                }
+            );
+        name_offset += f.key.size();
+        }
+    int k = 0;
+    for(std::size_t j = 0; j < files.size(); ++j)
+        {
+        for(auto const& t : files[j].tables)
+            {
+            table_record r {};
+            r.file_index     = bourn_cast<std::uint32_t>(j);
+            r.table_number   = t->table_number();
+            r.table_type     = t->table_type();
+            r.min_age        = t->min_age();
+            r.max_age        = t->max_age();
+            r.select_period  = t->select_period();
+            r.max_select_age = t->max_select_age();
+            r.reserved       = 0;
+            r.data_count     = t->stored_values().size();
+            r.data_offset    = write_values(t->stored_values());
+            r.select_count   = t->tabulated_select_values().size();
+            r.select_offset  = write_values(t->tabulated_select_values());
+            write_record(r);
+            ++k;
+            }
+        }
+    LMI_ASSERT(table_count == k);
+    LMI_ASSERT(names_offset == record_offset);
+    LMI_ASSERT(size == value_offset);
+
+    segment_header header {};
+    header.version     = segment_version;
+    header.file_count  = bourn_cast<std::uint32_t>(files.size());
+    header.table_count = bourn_cast<std::uint32_t>(table_count);
+    header.reserved    = 0;
+    header.size        = size;
+    std::memcpy(base, &header, sizeof header);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(base + offsetof(segment_header, magic), segment_magic, sizeof segment_magic);
+    return table_count;
+}
+
+void withdraw_actuarial_tables(char const* segment_name)
+{
+    ::shm_unlink(segment_name);
+}
+
+/// Find a published table.
+///
+/// Anything amiss--a table that wasn't published, files that have
+/// changed since, or a segment that is malformed--just means that
+/// the caller must read the files itself.
+
+std::optional<shared_actuarial_table> find_shared_actuarial_table
+    (std::string const& filename
+    ,int                table_number
+    ,char const*        segment_name
+    )
+{
+    std::shared_ptr<void const> const segment = attach(segment_name);
+    if(!segment)
+        {
+        return {};
+        }
+    segment_header header;
+    std::memcpy(&header, segment.get(), sizeof header);
+    segment_reader const reader(segment.get(), bourn_cast<std::size_t>(header.size));
+
+    // Files are sorted by name, and tables by file and table number.
+    std::string const key = key_of(filename);
+    auto const files = std::views::iota(std::uint32_t {0}, reader.file_count());
+    auto const f = std::ranges::partition_point
+        (files
+        ,[&](std::uint32_t j) {return reader.name(reader.file(j)) < key;}
+        );
+    if(f == files.end() || key != reader.name(reader.file(*f)))
+        {
+        return {};
+        }
+    file_record const file = reader.file(*f);
+    if(identity_of(key, ".ndx") != file.index || identity_of(key, ".dat") != file.data)
+        {
+        return {};
+        }
+
+    auto const file_index = *f;
+    auto const k = std::make_pair(file_index, table_number);
+    auto const tables = std::views::iota(std::uint32_t {0}, reader.table_count());
+    auto const i = std::ranges::partition_point
+        (tables
+        ,[&](std::uint32_t j)
+            {
+            table_record const r = reader.table(j);
+            return std::make_pair(r.file_index, r.table_number) < k;
+            }
+        );
+    if(i == tables.end())
+        {
+        return {};
+        }
+    table_record const table = reader.table(*i);
+    if(file_index != table.file_index || table_number != table.table_number)
+        {
+        return {};
+        }
+
+    auto const data          = reader.values(table.data_offset  , table.data_count  );
+    auto const select_values = reader.values(table.select_offset, table.select_count);
+    if
+        (  !is_consistent(table)
+        || data.size()          != table.data_count
+        || select_values.size() != table.select_count
+        )
+        {
+        return {};
+        }
+
+    return shared_actuarial_table
+        {segment
+        ,static_cast<char>(table.table_type)
+        ,table.min_age
+        ,table.max_age
+        ,table.select_period
+        ,table.max_select_age
+        ,data
+        ,select_values
+        };
+}
+
+#else  // !defined LMI_POSIX
+
+int publish_actuarial_tables(std::vector<std::string> const&, char const*)
+{
+    alarum() << "Shared memory is not supported on this platform." << LMI_FLUSH;
+    throw "Unreachable--silences a compiler diagnostic.";
+}
+
+void withdraw_actuarial_tables(char const*)
+{
+}
+
+std::optional<shared_actuarial_table> find_shared_actuarial_table
+    (std::string const&
+    ,int
+    ,char const*
+    )
+{
+    return {};
+}
+
+#endif // !defined LMI_POSIX
+
+int publish_actuarial_tables(fs::path const& directory)
+{
+    std::vector<std::string> filenames;
+    for(auto const& i : fs::directory_iterator(directory))
+        {
+        if(".ndx" == i.path().extension())
+            {
+            filenames.push_back(i.path().string());
+            }
+        }
+    return publish_actuarial_tables(filenames);
+}
@@ -0,0 +1,96 @@
+// Actuarial tables shared among processes.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#ifndef shared_table_store_hpp
+#define shared_table_store_hpp
+
+#include "config.hpp"
+
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <memory>                       // shared_ptr
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/// Name of the shared-memory segment that holds published tables.
+
+extern LMI_SO char const* const actuarial_table_segment_name;
+
+/// An actuarial table that another process has published.
+///
+/// Its values lie in a read-only shared-memory segment, which remains
+/// mapped as long as 'segment' or any copy of it exists.
+
+struct shared_actuarial_table
+{
+    std::shared_ptr<void const> segment        ;
+    char                        table_type     ;
+    int                         min_age        ;
+    int                         max_age        ;
+    int                         select_period  ;
+    int                         max_select_age ;
+    std::span<double const>     data           ;
+    std::span<double const>     select_values  ;
+};
+
+/// Read every table in the given files, and publish them all in a new
+/// shared-memory segment, replacing any that was published earlier.
+/// Return the number of tables published.
+///
+/// Each file is named as for class actuarial_table. The identity of
+/// its '.ndx' and '.dat' files--device, inode, size, and modification
+/// time--is published with its tables, so that tables in files that
+/// have changed since then are never used.
+///
+/// The segment can be read only by the user who published it, and is
+/// used only by that user's processes.
+
+LMI_SO int publish_actuarial_tables
+    (std::vector<std::string> const& filenames
+    ,char const*                     segment_name = actuarial_table_segment_name
+    );
+
+/// Publish the tables in every '.ndx' file in the given directory.
+
+LMI_SO int publish_actuarial_tables(fs::path const& directory);
+
+/// Remove a published segment. Processes that have already attached
+/// to it may continue to use it.
+
+LMI_SO void withdraw_actuarial_tables
+    (char const* segment_name = actuarial_table_segment_name
+    );
+
+/// Find a published table, if there is one, and if the files it was
+/// read from are unchanged. Otherwise, the caller should read the
+/// table itself.
+
+LMI_SO std::optional<shared_actuarial_table> find_shared_actuarial_table
+    (std::string const& filename
+    ,int                table_number
+    ,char const*        segment_name = actuarial_table_segment_name
+    );
+
+#endif // shared_table_store_hpp
@@ -0,0 +1,218 @@
+// Actuarial tables shared among processes--unit test.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "shared_table_store.hpp"
+
+#include "actuarial_table.hpp"
+#include "test_tools.hpp"
+
+#include <cstdint>
+#include <cstdio>                       // remove()
+#include <cstring>                      // memcpy()
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#if defined LMI_POSIX
+#   include <fcntl.h>                   // O_CREAT, O_EXCL, O_RDWR
+#   include <sys/mman.h>                // shm_open()
+#   include <sys/stat.h>                // fchmod()
+#   include <unistd.h>                  // close(), write()
+#endif // defined LMI_POSIX
+
+namespace
+{
+std::string const qx_cso("/opt/lmi/data/qx_cso");
+std::string const qx_ins("/opt/lmi/data/qx_ins");
+
+char const* const segment_name = "/lmi_shared_table_store_test";
+
+#if defined LMI_POSIX
+/// Copy of 'qx_cso', which can be modified.
+
+std::string const copy("/tmp/shared_table_store_test");
+
+std::vector<double> all_values(actuarial_table const& t, int issue_age)
+{
+    return t.values(issue_age, 1 + t.max_age() - issue_age);
+}
+
+void copy_file(std::string const& from, std::string const& to)
+{
+    std::ifstream ifs(from, std::ios_base::binary);
+    std::ofstream ofs(to  , std::ios_base::binary);
+    ofs << ifs.rdbuf();
+}
+#endif // defined LMI_POSIX
+} // Unnamed namespace.
+
+#if defined LMI_POSIX
+
+/// Shared tables have the same values as tables read privately:
+/// one each of type 'A', 'S', and 'D'.
+
+void test_publication()
+{
+    withdraw_actuarial_tables(segment_name);
+    LMI_TEST(!find_shared_actuarial_table(qx_cso, 42, segment_name).has_value());
+
+    LMI_TEST(0 < publish_actuarial_tables({qx_cso, qx_ins, qx_cso}, segment_name));
+
+    for(int n : {42, 256, 750})
+        {
+        std::string const& f = (42 == n) ? qx_cso : qx_ins;
+        auto const shared = find_shared_actuarial_table(f, n, segment_name);
+        LMI_TEST(shared.has_value());
+        if(!shared)
+            {
+            continue;
+            }
+        actuarial_table const private_table(f, n);
+        actuarial_table const shared_table (f, n, *shared);
+        LMI_TEST_EQUAL(private_table.table_type    (), shared_table.table_type    ());
+        LMI_TEST_EQUAL(private_table.min_age       (), shared_table.min_age       ());
+        LMI_TEST_EQUAL(private_table.max_age       (), shared_table.max_age       ());
+        LMI_TEST_EQUAL(private_table.select_period (), shared_table.select_period ());
+        LMI_TEST_EQUAL(private_table.max_select_age(), shared_table.max_select_age());
+        for(int x = private_table.min_age(); x <= private_table.max_age(); ++x)
+            {
+            LMI_TEST(all_values(private_table, x) == all_values(shared_table, x));
+            }
+        }
+
+    // Files are found by absolute path, whatever extension is given.
+    LMI_TEST(find_shared_actuarial_table(qx_cso + ".ndx", 42, segment_name).has_value());
+    LMI_TEST(find_shared_actuarial_table("/opt/lmi/data/../data/qx_cso", 42, segment_name).has_value());
+
+    // Tables and files that weren't published aren't found.
+    LMI_TEST(!find_shared_actuarial_table(qx_cso, 999999, segment_name).has_value());
+    LMI_TEST(!find_shared_actuarial_table("/opt/lmi/data/nonexistent", 42, segment_name).has_value());
+
+    // A segment remains usable after it is withdrawn.
+    auto const shared = find_shared_actuarial_table(qx_cso, 42, segment_name);
+    withdraw_actuarial_tables(segment_name);
+    LMI_TEST(!find_shared_actuarial_table(qx_cso, 42, segment_name).has_value());
+    LMI_TEST(shared.has_value());
+    if(shared)
+        {
+        actuarial_table const private_table(qx_cso, 42);
+        actuarial_table const shared_table (qx_cso, 42, *shared);
+        LMI_TEST(all_values(private_table, 0) == all_values(shared_table, 0));
+        }
+}
+
+/// Tables whose files have changed since they were published are not
+/// used: the caller reads them itself.
+
+void test_staleness()
+{
+    copy_file(qx_cso + ".ndx", copy + ".ndx");
+    copy_file(qx_cso + ".dat", copy + ".dat");
+    LMI_TEST(0 < publish_actuarial_tables({copy}, segment_name));
+    LMI_TEST(find_shared_actuarial_table(copy, 42, segment_name).has_value());
+
+    std::ofstream(copy + ".dat", std::ios_base::binary | std::ios_base::app) << '\0';
+    LMI_TEST(!find_shared_actuarial_table(copy, 42, segment_name).has_value());
+
+    // Publishing again replaces the stale segment.
+    LMI_TEST(0 < publish_actuarial_tables({copy}, segment_name));
+    LMI_TEST(find_shared_actuarial_table(copy, 42, segment_name).has_value());
+
+    withdraw_actuarial_tables(segment_name);
+    LMI_TEST(0 == std::remove((copy + ".ndx").c_str()));
+    LMI_TEST(0 == std::remove((copy + ".dat").c_str()));
+}
+
+/// A segment that anyone else could write is not trusted.
+
+void test_permissions()
+{
+    LMI_TEST(0 < publish_actuarial_tables({qx_cso}, segment_name));
+    LMI_TEST(find_shared_actuarial_table(qx_cso, 42, segment_name).has_value());
+
+    int const fd = ::shm_open(segment_name, O_RDWR, 0);
+    LMI_TEST(0 <= fd);
+    LMI_TEST(0 == ::fchmod(fd, 0666));
+    LMI_TEST(!find_shared_actuarial_table(qx_cso, 42, segment_name).has_value());
+    LMI_TEST(0 == ::fchmod(fd, 0600));
+    LMI_TEST(find_shared_actuarial_table(qx_cso, 42, segment_name).has_value());
+    ::close(fd);
+
+    withdraw_actuarial_tables(segment_name);
+}
+
+/// A malformed segment is ignored, rather than read beyond its end:
+/// here, a header that promises more records than follow it.
+
+void test_malformed_segment()
+{
+    withdraw_actuarial_tables(segment_name);
+    int const fd = ::shm_open(segment_name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    LMI_TEST(0 <= fd);
+    char header[32] = {'l', 'm', 'i', '.', 's', 'h', 'm', '\n'};
+    std::uint32_t const version    = 2;
+    std::uint32_t const file_count = 1000;
+    std::uint64_t const size       = sizeof header;
+    std::memcpy(header +  8, &version   , sizeof version   );
+    std::memcpy(header + 12, &file_count, sizeof file_count);
+    std::memcpy(header + 24, &size      , sizeof size      );
+    LMI_TEST(sizeof header == static_cast<std::size_t>(::write(fd, header, sizeof header)));
+    ::close(fd);
+
+    LMI_TEST(!find_shared_actuarial_table(qx_cso, 42, segment_name).has_value());
+    withdraw_actuarial_tables(segment_name);
+}
+
+#else  // !defined LMI_POSIX
+
+/// Without shared memory, tables cannot be published, and callers
+/// always read them themselves.
+
+void test_fallback()
+{
+    LMI_TEST_THROW
+        (publish_actuarial_tables({qx_cso}, segment_name)
+        ,std::runtime_error
+        ,"Shared memory is not supported on this platform."
+        );
+    withdraw_actuarial_tables(segment_name);
+    LMI_TEST(!find_shared_actuarial_table(qx_cso, 42, segment_name).has_value());
+}
+
+#endif // !defined LMI_POSIX
+
+int test_main(int, char*[])
+{
+#if defined LMI_POSIX
+    test_publication();
+    test_staleness();
+    test_permissions();
+    test_malformed_segment();
+#else  // !defined LMI_POSIX
+    test_fallback();
+#endif // !defined LMI_POSIX
+
+    return EXIT_SUCCESS;
+}
@@ -27,6 +27,7 @@
 #include "assert_lmi.hpp"
 #include "data_directory.hpp"           // AddDataDir()
 #include "xml_lmi.hpp"
+#include "xsd_validator.hpp"
 
 #include <xmlwrapp/document.h>
 #include <xmlwrapp/nodes_view.h>
@@ -189,9 +190,18 @@ void single_cell_document::validate_with_xsd_schema
     ,std::string const&   xsd
     ) const
 {
-    xml::schema const schema(xml_lmi::dom_parser(AddDataDir(xsd)).document());
+    // Most external files are valid, and the native validator can
+    // confirm that quickly, without sorting a copy of the document.
+    // Any file it rejects is validated again by libxml2, which issues
+    // the customary diagnostics.
+    xsd_validator const* const v = cached_xsd_validator(xsd);
+    if(v && v->validate(xml).empty())
+        {
+        return;
+        }
+
     xml::error_messages errors;
-    if(!schema.validate(cell_sorter().apply(xml), errors))
+    if(!cached_xsd_schema(xsd).validate(cell_sorter().apply(xml), errors))
         {
         warning()
             << "Validation with schema '"
@@ -307,6 +307,18 @@ void Skeleton::InitDocManager()
         ,CLASSINFO(CensusView)
         );
 
+    new(wx) wxDocTemplate
+        (doc_manager_
+        ,"Indexed census"
+        ,"*.cni"
+        ,""
+        ,"cni"
+        ,"Census document"
+        ,"Census view"
+        ,CLASSINFO(CensusDocument)
+        ,CLASSINFO(CensusView)
+        );
+
     new(wx) wxDocTemplate
         (doc_manager_
         ,"Illustration"
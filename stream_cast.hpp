@@ -120,7 +120,7 @@ To stream_cast(From from, To = To())
         throw std::runtime_error(err.str());
         };
 
-    static std::stringstream interpreter = []
+    static thread_local std::stringstream interpreter = []
         {
         std::stringstream ss {};
         ss.imbue(blank_is_not_whitespace_locale());
@@ -933,6 +933,7 @@ bool check_reserved_name_exception(std::string const& s)
         ,"__LINE__"
         ,"__STDC_IEC_559__"
         ,"__cplusplus"
+        ,"__cpp_lib_to_chars"
         ,"__func__"
         ,"__has_include"
     // Platform identification.
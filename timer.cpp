@@ -25,6 +25,15 @@
 
 #include "bourn_cast.hpp"
 
+#if defined LMI_POSIX && defined __linux__
+#   define LMI_PERF_EVENTS
+#   include <linux/perf_event.h>        // perf_event_attr, PERF_*
+#   include <sys/ioctl.h>               // ioctl()
+#   include <sys/syscall.h>             // SYS_perf_event_open
+#   include <unistd.h>                  // close(), read(), syscall()
+#   include <cstdint>                   // uint64_t
+#endif // defined LMI_POSIX && defined __linux__
+
 #if defined LMI_POSIX
 #   include <sys/time.h>                // gettimeofday()
 #elif defined LMI_MSW
@@ -211,4 +220,197 @@ double Timer::inspect() const
 #endif // Unknown platform.
 }
 
+namespace
+{
+#if defined LMI_PERF_EVENTS
+/// Events counted, in the order of hardware_counters::counts_.
+
+std::uint64_t const events[] =
+    {PERF_COUNT_HW_CPU_CYCLES
+    ,PERF_COUNT_HW_INSTRUCTIONS
+    ,PERF_COUNT_HW_CACHE_MISSES
+    ,PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+/// Open one counter, returning its descriptor, or a negative value on
+/// failure. The first counter opened is the group leader, which is
+/// created disabled; the others are enabled and disabled together
+/// with it.
+///
+/// Counters are inherited by threads created afterwards. The kernel
+/// doesn't support reading an inherited group at once, so each
+/// counter is read separately.
+
+int open_counter(std::uint64_t event, int leader)
+{
+    perf_event_attr a {};
+    a.type           = PERF_TYPE_HARDWARE;
+    a.size           = sizeof a;
+    a.config         = event;
+    a.disabled       = -1 == leader;
+    a.inherit        = 1;
+    a.exclude_kernel = 1;
+    a.exclude_hv     = 1;
+    a.read_format    =
+          PERF_FORMAT_TOTAL_TIME_ENABLED
+        | PERF_FORMAT_TOTAL_TIME_RUNNING
+        ;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &a, 0, -1, leader, 0UL));
+}
+#endif // defined LMI_PERF_EVENTS
+} // Unnamed namespace.
+
+/// Open and start counters if wanted and possible; no error is
+/// reported if not.
+///
+/// Counters are opened as one group, so that they count during the
+/// same intervals and their ratios are meaningful. If any cannot be
+/// opened, none is used.
+
+hardware_counters::hardware_counters(bool wanted)
+{
+    for(int j = 0; j < number_of_events; ++j)
+        {
+        descriptors_[j] = -1;
+        counts_     [j] = 0.0;
+        }
+
+    if(!wanted)
+        {
+        return;
+        }
+
+#if defined LMI_PERF_EVENTS
+    static_assert(number_of_events == sizeof events / sizeof events[0]);
+    for(int j = 0; j < number_of_events; ++j)
+        {
+        descriptors_[j] = open_counter(events[j], descriptors_[0]);
+        if(descriptors_[j] < 0)
+            {
+            for(int k = 0; k < j; ++k)
+                {
+                ::close(descriptors_[k]);
+                descriptors_[k] = -1;
+                }
+            descriptors_[j] = -1;
+            return;
+            }
+        }
+    restart();
+#endif // defined LMI_PERF_EVENTS
+}
+
+hardware_counters::~hardware_counters()
+{
+#if defined LMI_PERF_EVENTS
+    for(int j = 0; j < number_of_events; ++j)
+        {
+        if(0 <= descriptors_[j])
+            {
+            ::close(descriptors_[j]);
+            }
+        }
+#endif // defined LMI_PERF_EVENTS
+}
+
+bool hardware_counters::available() const
+{
+    return 0 <= descriptors_[0];
+}
+
+/// Set counts to zero, and restart counting.
+
+hardware_counters& hardware_counters::restart()
+{
+    for(auto& i : counts_)
+        {
+        i = 0.0;
+        }
+#if defined LMI_PERF_EVENTS
+    if(available())
+        {
+        ::ioctl(descriptors_[0], PERF_EVENT_IOC_RESET , PERF_IOC_FLAG_GROUP);
+        ::ioctl(descriptors_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif // defined LMI_PERF_EVENTS
+    return *this;
+}
+
+/// Stop counting, and record counts.
+///
+/// If the group was never scheduled onto the hardware, which can
+/// happen when other processes monopolize the counters, every count
+/// is zero.
+
+hardware_counters& hardware_counters::stop()
+{
+#if defined LMI_PERF_EVENTS
+    if(available())
+        {
+        ::ioctl(descriptors_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        for(int j = 0; j < number_of_events; ++j)
+            {
+            // Count, time enabled, time running.
+            std::uint64_t buffer[3] {};
+            ssize_t const n = ::read(descriptors_[j], buffer, sizeof buffer);
+            bool const valid =
+                   static_cast<ssize_t>(sizeof buffer) == n
+                && 0 != buffer[2]
+                ;
+            double const scale =
+                valid
+                ? static_cast<double>(buffer[1]) / static_cast<double>(buffer[2])
+                : 0.0
+                ;
+            counts_[j] = scale * static_cast<double>(buffer[0]);
+            }
+        }
+#endif // defined LMI_PERF_EVENTS
+    return *this;
+}
+
+double hardware_counters::cycles() const
+{
+    return counts_[0];
+}
+
+double hardware_counters::instructions() const
+{
+    return counts_[1];
+}
+
+double hardware_counters::cache_misses() const
+{
+    return counts_[2];
+}
+
+double hardware_counters::branch_misses() const
+{
+    return counts_[3];
+}
+
+/// Instructions per cycle, and cache and branch misses per thousand
+/// instructions; or an empty string if nothing was counted.
+
+std::string hardware_counters::str() const
+{
+    if(0.0 == cycles() || 0.0 == instructions())
+        {
+        return std::string();
+        }
+
+    std::ostringstream oss;
+    oss
+        << std::fixed << std::setprecision(2)
+        << instructions() / cycles()
+        << " IPC; per 1000 instructions, "
+        << 1000.0 * cache_misses() / instructions()
+        << " cache and "
+        << 1000.0 * branch_misses() / instructions()
+        << " branch misses"
+        ;
+    return oss.str();
+}
+
+#undef LMI_PERF_EVENTS
 #undef LMI_MS_HEADER_INCLUDED
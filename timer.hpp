@@ -74,6 +74,62 @@ class LMI_SO Timer
     double time_when_stopped_;
 };
 
+/// Hardware performance counters for the calling thread and its
+/// descendants.
+///
+/// Wall-clock time alone cannot say whether an operation is slow
+/// because it executes too many instructions, or because it misses
+/// the cache or mispredicts branches. Where the kernel permits, count
+/// CPU cycles, instructions retired, last-level cache misses, and
+/// mispredicted branches, using perf_event_open(2) on Linux. The
+/// calling thread is counted, along with any thread it creates while
+/// counting; but a created thread's counts are added only when it
+/// exits, so they are complete only if it has been joined before
+/// stop() is called (as parallel_for() ensures). Only user mode is
+/// counted. The kernel may disallow even that (see
+/// 'perf_event_paranoid'), and there may be no performance-monitoring
+/// unit (as in many virtual machines).
+///
+/// Opening counters takes a few system calls, so a caller that only
+/// sometimes wants counts may construct an instance with the argument
+/// 'false', which opens none and acts as though none were available.
+///
+/// If counters are not available, then available() returns false,
+/// every count is zero, and str() returns an empty string, so that
+/// callers need not test for availability.
+///
+/// Like class Timer, this class starts counting upon construction.
+/// If the kernel multiplexes the counters with other users, counts
+/// are scaled by the fraction of time they were actually counting.
+
+class LMI_SO hardware_counters final
+{
+  public:
+    explicit hardware_counters(bool wanted = true);
+    ~hardware_counters();
+
+    bool available() const;
+
+    hardware_counters& restart();
+    hardware_counters& stop();
+
+    double cycles       () const;
+    double instructions () const;
+    double cache_misses () const;
+    double branch_misses() const;
+
+    std::string str() const;
+
+  private:
+    hardware_counters(hardware_counters const&) = delete;
+    hardware_counters& operator=(hardware_counters const&) = delete;
+
+    static constexpr int number_of_events {4};
+
+    int    descriptors_[number_of_events];
+    double counts_     [number_of_events];
+};
+
 /// Time an operation over an actively-adjusted number of repetitions.
 ///
 /// Adjust the number of repetitions measured, balancing expenditure
@@ -116,6 +172,10 @@ class LMI_SO Timer
 /// Ctor parameter 'max_seconds' is the desired limit on measurement
 /// time, in seconds.
 ///
+/// Where hardware_counters are available, the repetitions after the
+/// first are counted too, and str() shows instructions per cycle and
+/// miss rates after the times.
+///
 /// This class template is a friend of class Timer so that it can
 /// access Timer::frequency_, which should not have a public accessor
 /// because its type is platform dependent.
@@ -187,6 +247,7 @@ AliquotTimer<F>& AliquotTimer<F>::operator()()
         return *this;
         }
 
+    hardware_counters counters;
     Timer timer;
     double const dbl_freq   = timer.frequency_;
     double const limit      = max_seconds_ * dbl_freq;
@@ -208,6 +269,7 @@ AliquotTimer<F>& AliquotTimer<F>::operator()()
             }
         }
     timer.stop();
+    counters.stop();
     unit_time_ = minimum / dbl_freq;
     std::ostringstream oss;
     oss
@@ -220,6 +282,11 @@ AliquotTimer<F>& AliquotTimer<F>::operator()()
         << std::setw( 3) << j
         << " runs"
         ;
+    std::string const counts = counters.str();
+    if(!counts.empty())
+        {
+        oss << "; " << counts;
+        }
     str_ = oss.str();
 
     return *this;
@@ -29,6 +29,7 @@
 
 #include <cmath>                        // log10()
 #include <functional>                   // bind()
+#include <thread>
 
 inline void do_nothing()
 {}
@@ -59,6 +60,7 @@ struct TimerTest
     static void SleepOneSec();
     static void TestExceptions();
     static void TestAliquotTimer();
+    static void TestHardwareCounters();
 };
 
 void TimerTest::WaitTenMsec()
@@ -129,9 +131,59 @@ void TimerTest::TestAliquotTimer()
     std::cout << "  " << TimeAnAliquot(SleepOneSec, 2.000) << '\n';
 }
 
+/// Counters may legitimately be unavailable, e.g., in a virtual
+/// machine, so only consistency can be tested.
+
+void TimerTest::TestHardwareCounters()
+{
+    hardware_counters counters;
+    foo();
+    counters.stop();
+    if(counters.available())
+        {
+        LMI_TEST(0.0 < counters.instructions());
+        std::cout << "  Hardware counters: " << counters.str() << '\n';
+        }
+    else
+        {
+        LMI_TEST_EQUAL(0.0, counters.cycles       ());
+        LMI_TEST_EQUAL(0.0, counters.instructions ());
+        LMI_TEST_EQUAL(0.0, counters.cache_misses ());
+        LMI_TEST_EQUAL(0.0, counters.branch_misses());
+        LMI_TEST_EQUAL("", counters.str());
+        std::cout << "  Hardware counters not available." << '\n';
+        }
+
+    counters.restart();
+    counters.stop();
+    LMI_TEST(counters.instructions() < 1.0e6);
+
+    // A thread created while counting is counted once it's joined.
+    if(counters.available())
+        {
+        counters.restart();
+        std::thread t([] {for(int j = 0; j < 1000; ++j) foo();});
+        t.join();
+        counters.stop();
+        LMI_TEST(1.0e6 < counters.instructions());
+        }
+
+    hardware_counters unwanted(false);
+    foo();
+    unwanted.stop();
+    LMI_TEST(!unwanted.available());
+    LMI_TEST_EQUAL("", unwanted.str());
+
+    LMI_TEST
+        (   counters.available()
+        ==  contains(TimeAnAliquot(foo, 0.1).str(), " IPC; ")
+        );
+}
+
 int test_main(int, char*[])
 {
     TimerTest::TestExceptions();
     TimerTest::TestAliquotTimer();
+    TimerTest::TestHardwareCounters();
     return EXIT_SUCCESS;
 }
@@ -388,6 +388,7 @@ template<typename Number, typename Trammel>
 tn_range<Number,Trammel>& tn_range<Number,Trammel>::operator=(Number n)
 {
     value_ = curb(n);
+    note_change();
     return *this;
 }
 
@@ -395,6 +396,7 @@ template<typename Number, typename Trammel>
 tn_range<Number,Trammel>& tn_range<Number,Trammel>::operator=(std::string const& s)
 {
     value_ = curb(value_cast<Number>(s));
+    note_change();
     return *this;
 }
 
@@ -727,6 +729,7 @@ template<typename Number, typename Trammel>
 void tn_range<Number,Trammel>::enforce_circumscription()
 {
     value_ = curb(value_);
+    note_change();
 }
 
 template<typename Number, typename Trammel>
@@ -128,6 +128,8 @@ struct tn_range_test
 
     static void test_nonfundamental_number_type();
 
+    static void test_revisions();
+
     static void test();
 };
 
@@ -616,8 +618,42 @@ void tn_range_test::test_nonfundamental_number_type()
     r_range_udt r0;
 }
 
+/// Every write advances the revision, whether or not the value
+/// changes; reading or changing limits does not.
+
+void tn_range_test::test_revisions()
+{
+    r_nonnegative r0(2.0);
+    r_nonnegative r1(r0);
+    LMI_TEST_EQUAL(0U, r0.revision());
+    LMI_TEST_EQUAL(0U, r1.revision());
+
+    r0 = 3.0;
+    LMI_TEST_EQUAL(1U, r0.revision());
+    r0 = std::string("3");
+    LMI_TEST_EQUAL(2U, r0.revision());
+    std::istringstream is("4");
+    is >> r0;
+    LMI_TEST_EQUAL(3U, r0.revision());
+
+    (void)r0.value();
+    (void)r0.str();
+    r0.minimum(1.0);
+    LMI_TEST_EQUAL(3U, r0.revision());
+
+    r0.enforce_circumscription();
+    LMI_TEST_EQUAL(4U, r0.revision());
+
+    // Assignment advances the target's own revision, rather than
+    // copying the source's.
+    r1 = r0;
+    LMI_TEST_EQUAL(1U, r1.revision());
+    LMI_TEST_EQUAL(4U, r0.revision());
+}
+
 int test_main(int, char*[])
 {
     tn_range_test::test();
+    tn_range_test::test_revisions();
     return 0;
 }
@@ -0,0 +1,404 @@
+// Serve one-line requests on a Unix-domain socket.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "unix_socket_server.hpp"
+
+#include "alert.hpp"
+#include "parallel_for.hpp"
+
+#include <algorithm>                    // min(), replace()
+#include <atomic>
+#include <cstddef>                      // size_t
+#include <exception>
+#include <optional>
+#include <string>
+
+#if defined LMI_POSIX
+#   include <cerrno>                    // errno, EINTR
+#   include <cstring>                   // memcpy(), strerror()
+#   include <poll.h>                    // poll()
+#   include <sys/socket.h>              // accept(), bind(), connect()...
+#   include <sys/stat.h>                // chmod(), lstat(), S_ISSOCK
+#   include <sys/un.h>                  // sockaddr_un
+#   include <unistd.h>                  // close(), geteuid(), read(), unlink()
+#endif // defined LMI_POSIX
+
+char const* const unix_socket_shutdown_request = "shutdown";
+
+#if defined LMI_POSIX
+
+namespace
+{
+/// Requests are single lines, and never need to be this long.
+
+std::string::size_type const maximum_request_length = 1 << 20;
+
+#if defined MSG_NOSIGNAL
+int const send_flags = MSG_NOSIGNAL;
+#else  // !defined MSG_NOSIGNAL
+int const send_flags = 0;
+#endif // !defined MSG_NOSIGNAL
+
+/// Close a file descriptor when it goes out of scope.
+
+class descriptor final
+{
+  public:
+    explicit descriptor(int fd) : fd_ {fd} {}
+    ~descriptor() {if(0 <= fd_) ::close(fd_);}
+
+    int get() const {return fd_;}
+
+  private:
+    descriptor(descriptor const&) = delete;
+    descriptor& operator=(descriptor const&) = delete;
+
+    int fd_;
+};
+
+sockaddr_un address_of(fs::path const& socket_path)
+{
+    std::string const s = socket_path.string();
+    sockaddr_un z {};
+    z.sun_family = AF_UNIX;
+    if(sizeof z.sun_path <= s.size())
+        {
+        alarum()
+            << "Socket path '"
+            << s
+            << "' is longer than the maximum of "
+            << sizeof z.sun_path - 1
+            << " characters."
+            << LMI_FLUSH
+            ;
+        }
+    std::memcpy(z.sun_path, s.c_str(), 1 + s.size());
+    return z;
+}
+
+int new_socket()
+{
+    int const fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0)
+        {
+        alarum() << "Cannot create socket: " << std::strerror(errno) << LMI_FLUSH;
+        }
+    return fd;
+}
+
+/// Read until newline or end of file. The newline is not returned.
+///
+/// Return nothing if the line is not complete by the deadline, so
+/// that a client that sends nothing cannot occupy a server thread.
+
+std::optional<std::string> read_line
+    (int                                   fd
+    ,std::chrono::steady_clock::time_point deadline
+    )
+{
+    std::string z;
+    char buffer[4096];
+    for(;;)
+        {
+        auto const remaining = std::chrono::duration_cast<std::chrono::milliseconds>
+            (deadline - std::chrono::steady_clock::now()
+            );
+        if(remaining.count() <= 0)
+            {
+            return {};
+            }
+        // Wait no more than a minute at a time, lest the remaining
+        // time overflow poll()'s argument.
+        auto const wait = std::min(remaining, std::chrono::milliseconds(60000));
+        pollfd p {fd, POLLIN, 0};
+        int const ready = ::poll(&p, 1, static_cast<int>(wait.count()));
+        if(ready < 0 && EINTR == errno)
+            {
+            continue;
+            }
+        if(0 == ready)
+            {
+            continue;
+            }
+        ssize_t const n = ::read(fd, buffer, sizeof buffer);
+        if(n < 0 && EINTR == errno)
+            {
+            continue;
+            }
+        if(n <= 0)
+            {
+            break;
+            }
+        z.append(buffer, static_cast<std::size_t>(n));
+        std::string::size_type const newline = z.find('\n');
+        if(std::string::npos != newline)
+            {
+            z.resize(newline);
+            break;
+            }
+        if(maximum_request_length < z.size())
+            {
+            break;
+            }
+        }
+    return z;
+}
+
+/// Write everything, or as much as the peer will accept before it
+/// disconnects, which is not an error that the writer can remedy.
+
+void write_all(int fd, std::string const& s)
+{
+    char const* p = s.data();
+    std::size_t remaining = s.size();
+    while(0 < remaining)
+        {
+        ssize_t const n = ::send(fd, p, remaining, send_flags);
+        if(n < 0 && EINTR == errno)
+            {
+            continue;
+            }
+        if(n <= 0)
+            {
+            return;
+            }
+        p         += n;
+        remaining -= static_cast<std::size_t>(n);
+        }
+}
+
+/// Whether the peer runs as the same user as this process.
+///
+/// The socket file can be opened only by its owner, but this guards
+/// against a socket that was exposed some other way, e.g. by a
+/// descriptor passed to another process.
+
+bool is_same_user(int fd)
+{
+#if defined SO_PEERCRED
+    ucred credentials {};
+    socklen_t length = sizeof credentials;
+    return
+           0 == ::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length)
+        && ::geteuid() == credentials.uid
+        ;
+#else  // !defined SO_PEERCRED
+    uid_t uid {};
+    gid_t gid {};
+    return 0 == ::getpeereid(fd, &uid, &gid) && ::geteuid() == uid;
+#endif // !defined SO_PEERCRED
+}
+
+/// Single line for the response protocol: newlines are spaces.
+
+std::string one_line(std::string s)
+{
+    std::replace(s.begin(), s.end(), '\n', ' ');
+    return s;
+}
+
+std::string respond
+    (std::function<std::string(std::string const&)> const& handler
+    ,std::string                                    const& request
+    )
+{
+    try
+        {
+        return one_line(handler(request));
+        }
+    catch(std::exception const& e)
+        {
+        return "error\t" + one_line(e.what());
+        }
+    catch(...)
+        {
+        return "error\tUnknown exception.";
+        }
+}
+} // Unnamed namespace.
+
+void serve_unix_socket
+    (fs::path                                       const& socket_path
+    ,std::function<std::string(std::string const&)> const& handler
+    ,int                                                   max_threads
+    ,std::chrono::milliseconds                             request_timeout
+    )
+{
+    if(max_threads <= 0)
+        {
+        max_threads = lmi_concurrency();
+        }
+
+    std::string const path = socket_path.string();
+    sockaddr_un const address = address_of(socket_path);
+
+    struct stat st;
+    if(0 == ::lstat(path.c_str(), &st))
+        {
+        if(!S_ISSOCK(st.st_mode))
+            {
+            alarum()
+                << "Cannot serve on '"
+                << path
+                << "', which exists and is not a socket."
+                << LMI_FLUSH
+                ;
+            }
+        ::unlink(path.c_str());
+        }
+
+    // Only the owner may connect. Until listen() is called, any
+    // attempt to connect is refused, so there's no window between
+    // creating the socket file and restricting its permissions.
+    descriptor const listener(new_socket());
+    if
+        (  0 != ::bind(listener.get(), reinterpret_cast<sockaddr const*>(&address), sizeof address)
+        || 0 != ::chmod(path.c_str(), 0600)
+        || 0 != ::listen(listener.get(), SOMAXCONN)
+        )
+        {
+        alarum()
+            << "Cannot serve on '"
+            << path
+            << "': "
+            << std::strerror(errno)
+            << LMI_FLUSH
+            ;
+        }
+
+    // Each worker accepts connections until the server stops. Then
+    // every other worker, which may be blocked in accept(), is woken
+    // by connecting once for each of them.
+    std::atomic<bool> stopping {false};
+    auto stop = [&]
+        {
+        stopping = true;
+        for(int j = 1; j < max_threads; ++j)
+            {
+            descriptor const waker(new_socket());
+            ::connect(waker.get(), reinterpret_cast<sockaddr const*>(&address), sizeof address);
+            }
+        };
+    auto worker = [&](int)
+        {
+        for(;;)
+            {
+            int const c = ::accept(listener.get(), nullptr, nullptr);
+            if(stopping)
+                {
+                descriptor const ignored(c);
+                return;
+                }
+            if(c < 0)
+                {
+                if(EINTR == errno || ECONNABORTED == errno)
+                    {
+                    continue;
+                    }
+                char const* const reason = std::strerror(errno);
+                stop();
+                alarum() << "Cannot accept: " << reason << LMI_FLUSH;
+                }
+            descriptor const connection(c);
+            if(!is_same_user(connection.get()))
+                {
+                write_all(connection.get(), "error\tPermission denied.\n");
+                continue;
+                }
+            auto const request = read_line
+                (connection.get()
+                ,std::chrono::steady_clock::now() + request_timeout
+                );
+            if(!request)
+                {
+                write_all(connection.get(), "error\tRequest timed out.\n");
+                continue;
+                }
+            if(unix_socket_shutdown_request == *request)
+                {
+                write_all(connection.get(), "ok\n");
+                stop();
+                return;
+                }
+            write_all(connection.get(), respond(handler, *request) + '\n');
+            }
+        };
+    parallel_for(max_threads, worker, max_threads);
+
+    ::unlink(path.c_str());
+}
+
+std::string request_via_unix_socket
+    (fs::path    const& socket_path
+    ,std::string const& request
+    )
+{
+    if(std::string::npos != request.find('\n'))
+        {
+        alarum() << "Request must be a single line." << LMI_FLUSH;
+        }
+
+    sockaddr_un const address = address_of(socket_path);
+    descriptor const connection(new_socket());
+    if(0 != ::connect(connection.get(), reinterpret_cast<sockaddr const*>(&address), sizeof address))
+        {
+        alarum()
+            << "Cannot connect to '"
+            << socket_path.string()
+            << "': "
+            << std::strerror(errno)
+            << LMI_FLUSH
+            ;
+        }
+    write_all(connection.get(), request + '\n');
+    ::shutdown(connection.get(), SHUT_WR);
+    // A request may take as long as it takes; only servers time out.
+    auto const response = read_line
+        (connection.get()
+        ,std::chrono::steady_clock::time_point::max()
+        );
+    return response.value_or(std::string());
+}
+
+#else  // !defined LMI_POSIX
+
+void serve_unix_socket
+    (fs::path                                       const&
+    ,std::function<std::string(std::string const&)> const&
+    ,int
+    ,std::chrono::milliseconds
+    )
+{
+    alarum() << "Unix-domain sockets are not supported on this platform." << LMI_FLUSH;
+}
+
+std::string request_via_unix_socket
+    (fs::path    const&
+    ,std::string const&
+    )
+{
+    alarum() << "Unix-domain sockets are not supported on this platform." << LMI_FLUSH;
+    throw "Unreachable--silences a compiler diagnostic.";
+}
+
+#endif // !defined LMI_POSIX
@@ -0,0 +1,86 @@
+// Serve one-line requests on a Unix-domain socket.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef unix_socket_server_hpp
+#define unix_socket_server_hpp
+
+#include "config.hpp"
+
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+/// Design notes for serve_unix_socket() and request_via_unix_socket().
+///
+/// A long-running process keeps its caches warm, so that it need not
+/// reload product files and tables for each request, as a process
+/// started anew for every request must.
+///
+/// Each connection carries exactly one request: a single line of
+/// text, terminated by a newline or by the client's closing its end
+/// for writing. The server writes the handler's one-line response,
+/// followed by a newline, and closes the connection. Because it is
+/// so simple, this protocol can be exercised from a shell, e.g.:
+///   printf 'shutdown\n' | socat - UNIX-CONNECT:/tmp/lmi.socket
+///
+/// Up to 'max_threads' connections are handled concurrently: if that
+/// argument is not positive, lmi_concurrency() is used. The handler
+/// must therefore be safe to call from several threads at once. Any
+/// exception it throws is reported to the client as
+///   error<TAB>message
+/// and does not stop the server.
+///
+/// A client that hasn't sent a complete request within
+/// 'request_timeout' is answered with an error, so that an idle
+/// client cannot occupy a thread indefinitely.
+///
+/// The request "shutdown" stops the server after every request in
+/// progress has been answered. Any socket file already at the given
+/// path is replaced, because a server that terminated abnormally
+/// leaves one behind; but any other kind of file is an error.
+///
+/// Unix-domain sockets are used only because they are local: access
+/// is governed by filesystem permissions, and no network port is
+/// exposed. The socket file is readable and writable only by its
+/// owner, and a connection from any other user is refused even if it
+/// somehow gets through; thus, only the user who started the server
+/// can make requests, including "shutdown". Sockets are supported
+/// only where LMI_POSIX is defined.
+
+extern LMI_SO char const* const unix_socket_shutdown_request;
+
+LMI_SO void serve_unix_socket
+    (fs::path                                       const& socket_path
+    ,std::function<std::string(std::string const&)> const& handler
+    ,int                                                   max_threads = 0
+    ,std::chrono::milliseconds                             request_timeout
+        = std::chrono::seconds(10)
+    );
+
+LMI_SO std::string request_via_unix_socket
+    (fs::path    const& socket_path
+    ,std::string const& request
+    );
+
+#endif // unix_socket_server_hpp
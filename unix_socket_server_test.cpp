@@ -0,0 +1,264 @@
+// Serve one-line requests on a Unix-domain socket--unit test.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "unix_socket_server.hpp"
+
+#include "test_tools.hpp"
+
+#if defined LMI_POSIX
+#   include <sys/socket.h>              // connect(), socket()
+#   include <sys/stat.h>                // stat()
+#   include <sys/un.h>                  // sockaddr_un
+#   include <unistd.h>                  // close(), read()
+#endif // defined LMI_POSIX
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>                       // remove()
+#include <exception>                    // exception_ptr
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined LMI_POSIX
+
+namespace
+{
+fs::path const socket_path("/tmp/unix_socket_server_test.socket");
+
+int const number_of_threads = 4;
+
+std::chrono::milliseconds const request_timeout {200};
+
+/// Answer every request, but only after 'number_of_threads' requests
+/// are in progress at the same time: that proves that requests are
+/// served concurrently.
+
+std::atomic<int> requests_in_progress {0};
+
+std::string handler(std::string const& request)
+{
+    if("throw" == request)
+        {
+        throw std::runtime_error("Thrown\non request.");
+        }
+    if("concurrent" == request)
+        {
+        ++requests_in_progress;
+        auto const limit = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while(requests_in_progress < number_of_threads)
+            {
+            if(limit < std::chrono::steady_clock::now())
+                {
+                return "timed out";
+                }
+            std::this_thread::yield();
+            }
+        }
+    return "echo\t" + request;
+}
+
+/// Connect, send nothing, and return whatever the server writes
+/// before it closes the connection.
+
+std::string idle_client()
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    socket_path.string().copy(address.sun_path, sizeof address.sun_path - 1);
+    int const fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::connect(fd, reinterpret_cast<sockaddr const*>(&address), sizeof address);
+    std::string z;
+    char buffer[256];
+    for(ssize_t n; 0 < (n = ::read(fd, buffer, sizeof buffer));)
+        {
+        z.append(buffer, static_cast<std::size_t>(n));
+        }
+    ::close(fd);
+    return z;
+}
+
+/// Start a server on its own thread, and wait until it is listening.
+
+std::thread start_server(std::exception_ptr& failure)
+{
+    std::thread server
+        ([&failure]
+            {
+            try
+                {
+                serve_unix_socket(socket_path, handler, number_of_threads, request_timeout);
+                }
+            catch(...)
+                {
+                failure = std::current_exception();
+                }
+            }
+        );
+    auto const limit = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    for(;;)
+        {
+        try
+            {
+            request_via_unix_socket(socket_path, "ping");
+            break;
+            }
+        catch(std::runtime_error const&)
+            {
+            if(limit < std::chrono::steady_clock::now() || failure)
+                {
+                throw;
+                }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+    return server;
+}
+} // Unnamed namespace.
+
+void test_requests()
+{
+    std::exception_ptr failure;
+    std::thread server = start_server(failure);
+
+    LMI_TEST_EQUAL("echo\tping", request_via_unix_socket(socket_path, "ping"));
+    LMI_TEST_EQUAL("echo\t", request_via_unix_socket(socket_path, ""));
+
+    // Exceptions are reported to the client on one line.
+    LMI_TEST_EQUAL
+        ("error\tThrown on request."
+        ,request_via_unix_socket(socket_path, "throw")
+        );
+
+    std::vector<std::string> responses(number_of_threads);
+    std::vector<std::thread> clients;
+    for(int j = 0; j < number_of_threads; ++j)
+        {
+        clients.emplace_back
+            ([&responses, j]
+                {responses[j] = request_via_unix_socket(socket_path, "concurrent");}
+            );
+        }
+    for(auto& i : clients)
+        {
+        i.join();
+        }
+    for(auto const& i : responses)
+        {
+        LMI_TEST_EQUAL("echo\tconcurrent", i);
+        }
+
+    // Only the owner can use the socket.
+    struct stat st;
+    LMI_TEST(0 == ::stat(socket_path.string().c_str(), &st));
+    LMI_TEST_EQUAL(0600, st.st_mode & 07777);
+
+    // Clients that send nothing are dismissed, rather than occupying
+    // every thread, so other requests are still served.
+    std::vector<std::string> dismissals(number_of_threads);
+    std::vector<std::thread> idlers;
+    for(int j = 0; j < number_of_threads; ++j)
+        {
+        idlers.emplace_back
+            ([&dismissals, j]
+                {dismissals[j] = idle_client();}
+            );
+        }
+    LMI_TEST_EQUAL("echo\tping", request_via_unix_socket(socket_path, "ping"));
+    for(auto& i : idlers)
+        {
+        i.join();
+        }
+    for(auto const& i : dismissals)
+        {
+        LMI_TEST_EQUAL("error\tRequest timed out.\n", i);
+        }
+
+    LMI_TEST_EQUAL("ok", request_via_unix_socket(socket_path, unix_socket_shutdown_request));
+    server.join();
+    LMI_TEST(!failure);
+    LMI_TEST(!fs::exists(socket_path));
+
+    LMI_TEST_THROW
+        (request_via_unix_socket(socket_path, "ping")
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Cannot connect to '/tmp/unix_socket_server_test.socket'")
+        );
+}
+
+void test_errors()
+{
+    LMI_TEST_THROW
+        (request_via_unix_socket(socket_path, "two\nlines")
+        ,std::runtime_error
+        ,"Request must be a single line."
+        );
+
+    LMI_TEST_THROW
+        (serve_unix_socket("/tmp/" + std::string(200, 'x'), handler)
+        ,std::runtime_error
+        ,lmi_test::what_regex("is longer than the maximum of")
+        );
+
+    // A stale socket would be replaced, but any other file is kept.
+    std::ofstream("/tmp/unix_socket_server_test.socket") << "not a socket";
+    LMI_TEST_THROW
+        (serve_unix_socket(socket_path, handler)
+        ,std::runtime_error
+        ,"Cannot serve on '/tmp/unix_socket_server_test.socket',"
+         " which exists and is not a socket."
+        );
+    LMI_TEST(0 == std::remove("/tmp/unix_socket_server_test.socket"));
+}
+
+#else  // !defined LMI_POSIX
+
+void test_unsupported()
+{
+    LMI_TEST_THROW
+        (serve_unix_socket("/tmp/unix_socket_server_test.socket", nullptr)
+        ,std::runtime_error
+        ,"Unix-domain sockets are not supported on this platform."
+        );
+    LMI_TEST_THROW
+        (request_via_unix_socket("/tmp/unix_socket_server_test.socket", "ping")
+        ,std::runtime_error
+        ,"Unix-domain sockets are not supported on this platform."
+        );
+}
+
+#endif // !defined LMI_POSIX
+
+int test_main(int, char*[])
+{
+#if defined LMI_POSIX
+    test_requests();
+    test_errors();
+#else  // !defined LMI_POSIX
+    test_unsupported();
+#endif // !defined LMI_POSIX
+
+    return 0;
+}
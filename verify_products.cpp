@@ -24,16 +24,21 @@
 #include "verify_products.hpp"
 
 #include "actuarial_table.hpp"
+#include "alert.hpp"                    // scoped_alert_capture
 #include "basic_tables.hpp"
 #include "ce_product_name.hpp"
 #include "cso_table.hpp"
 #include "data_directory.hpp"           // AddDataDir()
 #include "database.hpp"
 #include "mc_enum.hpp"                  // all_strings<>()
+#include "parallel_for.hpp"
 #include "product_data.hpp"
 #include "ssize_lmi.hpp"
 
+#include <exception>
 #include <iostream>
+#include <ostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -43,7 +48,8 @@ class product_verifier
 {
   public:
     product_verifier
-        (std::string const& product_name
+        (std::ostream&      os
+        ,std::string const& product_name
         ,std::string const& gender_str
         ,std::string const& smoking_str
         );
@@ -52,6 +58,7 @@ class product_verifier
   private:
     void verify_7702q();
 
+    std::ostream&           os_          ;
     std::string      const  product_name_;
     std::string      const  gender_str_  ;
     std::string      const  smoking_str_ ;
@@ -70,11 +77,13 @@ class product_verifier
 };
 
 product_verifier::product_verifier
-    (std::string const& product_name
+    (std::ostream&      os
+    ,std::string const& product_name
     ,std::string const& gender_str
     ,std::string const& smoking_str
     )
-    :product_name_ {product_name}
+    :os_           {os}
+    ,product_name_ {product_name}
     ,gender_str_   {gender_str}
     ,smoking_str_  {smoking_str}
     ,p_            (*product_data::read_via_cache(filename_from_product_name(product_name)))
@@ -115,7 +124,7 @@ void product_verifier::verify()
         ||  (!axis_s_ && mce_unismoke != smoking_)
         )
         {
-        std::cout
+        os_
             << "  skipping"
             << ' ' << gender_str_
             << ' ' << smoking_str_
@@ -159,7 +168,7 @@ void product_verifier::verify_7702q()
                 ,min_age_
                 ,omega_ - min_age_
                 );
-            std::cout
+            os_
                 << "7702 q okay: builtin "
                 << std::string((v0 == v1) ? "validated" : "PROBLEM")
                 << ' ' << gender_str_
@@ -181,7 +190,7 @@ void product_verifier::verify_7702q()
             {
             if(0 == t_)
                 {
-                std::cout
+                os_
                     << "7702 q PROBLEM: " << product_name_
                     << " nonexistent table zero"
                     << ' ' << gender_str_
@@ -207,7 +216,7 @@ void product_verifier::verify_7702q()
 
             if(v0 == v1)
                 {
-                std::cout
+                os_
                     << "7702 q okay: table " << t_
                     << ' ' << gender_str_
                     << ' ' << smoking_str_
@@ -216,13 +225,13 @@ void product_verifier::verify_7702q()
                 }
             else
                 {
-                std::cout
+                os_
                     << "7702 q PROBLEM: " << product_name_
                     << ' ' << gender_str_
                     << ' ' << smoking_str_
                     << std::endl
                     ;
-                std::cout
+                os_
                     << "\n  CSO era: " << era_
                     << "\n  ALB or ANB: " << a_b_
                     << "\n  table file: " << f
@@ -282,20 +291,69 @@ void product_verifier::verify_7702q()
 /// and product verification need take no note of it. (It is generally
 /// not possible to share 7PP and corridor tables tables across all
 /// products, though, because those tables depend on maturity age.)
+///
+/// Each combination is verified as a separate job, concurrently; an
+/// exception thrown by one is reported as a problem with it, and does
+/// not prevent the others from being verified. Any warning a job
+/// raises is likewise added to its own report.
 
 void verify_products()
 {
-    std::vector<std::string> const& products = ce_product_name().all_strings();
-    for(auto const& p : products)
+    struct job
+    {
+        std::string product;
+        std::string gender;
+        std::string smoking;
+        std::ostringstream report {};
+    };
+    std::vector<job> jobs;
+    for(auto const& p : ce_product_name().all_strings())
         {
-        std::cout << "Testing product " << p << '\n';
         for(auto const& g : all_strings<mcenum_gender>())
             {
             for(auto const& s : all_strings<mcenum_smoking>())
                 {
-                product_verifier(p, g, s).verify();
+                jobs.push_back({p, g, s});
+                }
+            }
+        }
+
+    // Verify each product-gender-smoking combination independently,
+    // writing its diagnostics to a stream of its own, so that the
+    // consolidated report below is the same as if run serially.
+    parallel_for
+        (lmi::ssize(jobs)
+        ,[&jobs](int j)
+            {
+            job& z = jobs[j];
+            scoped_alert_capture const capture;
+            try
+                {
+                product_verifier(z.report, z.product, z.gender, z.smoking).verify();
                 }
+            catch(std::exception const& e)
+                {
+                z.report
+                    << "  PROBLEM: " << z.product
+                    << ' ' << z.gender
+                    << ' ' << z.smoking
+                    << ": " << e.what()
+                    << '\n'
+                    ;
+                }
+            z.report << capture.warnings();
+            }
+        );
+
+    std::string product;
+    for(auto const& z : jobs)
+        {
+        if(product != z.product)
+            {
+            product = z.product;
+            std::cout << "Testing product " << product << '\n';
             }
+        std::cout << z.report.str();
         }
     std::cout << std::endl;
 }
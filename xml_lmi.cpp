@@ -33,6 +33,8 @@
 #include <xmlwrapp/init.h>
 #include <xmlwrapp/tree_parser.h>
 
+#include <cstdint>                      // uint32_t
+#include <ios>                          // hex, uppercase
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -400,6 +402,101 @@ void set_attr
 {
     set_attr(element, name, value_cast<std::string>(value));
 }
+
+/// Append an element's content exactly as libxml2 would write it.
+///
+/// lmi's documents declare no encoding, so libxml2 writes them as
+/// ASCII. It escapes '<', '>', '&', and carriage return, and writes
+/// any other non-ASCII character as a hexadecimal character reference
+/// such as "&#xE9;". It writes everything else unchanged.
+///
+/// Returns false if libxml2 would reject the content because it is
+/// not valid UTF-8 or contains a character that xml forbids. In that
+/// case, 'out' may have been partly appended to, and the caller
+/// should let libxml2 write the document instead.
+
+bool append_escaped_content(std::string& out, std::string const& content)
+{
+    auto is_xml_char = [](std::uint32_t c)
+        {
+        return
+               0x9 == c || 0xA == c || 0xD == c
+            || (0x20    <= c && c <= 0xD7FF)
+            || (0xE000  <= c && c <= 0xFFFD)
+            || (0x10000 <= c && c <= 0x10FFFF)
+            ;
+        };
+
+    std::string::size_type const n = content.size();
+    for(std::string::size_type j = 0; j < n;)
+        {
+        unsigned char const c = static_cast<unsigned char>(content[j]);
+        if('<' == c)
+            {
+            out += "&lt;";
+            ++j;
+            }
+        else if('>' == c)
+            {
+            out += "&gt;";
+            ++j;
+            }
+        else if('&' == c)
+            {
+            out += "&amp;";
+            ++j;
+            }
+        else if('\r' == c)
+            {
+            out += "&#xD;";
+            ++j;
+            }
+        else if(c < 0x80)
+            {
+            if(!is_xml_char(c))
+                {
+                return false;
+                }
+            out += static_cast<char>(c);
+            ++j;
+            }
+        else
+            {
+            // Decode UTF-8 as libxml2 does: continuation bytes are
+            // checked, but overlong forms are not rejected.
+            std::string::size_type const length =
+                  (c < 0xC0) ? 0
+                : (c < 0xE0) ? 2
+                : (c < 0xF0) ? 3
+                : (c < 0xF8) ? 4
+                :              0
+                ;
+            if(0 == length || n - j < length)
+                {
+                return false;
+                }
+            std::uint32_t value = c & (0xFFu >> (1 + length));
+            for(std::string::size_type k = 1; k < length; ++k)
+                {
+                unsigned char const d = static_cast<unsigned char>(content[j + k]);
+                if(0x80 != (d & 0xC0))
+                    {
+                    return false;
+                    }
+                value = (value << 6) | (d & 0x3Fu);
+                }
+            if(!is_xml_char(value))
+                {
+                return false;
+                }
+            std::ostringstream oss;
+            oss << "&#x" << std::uppercase << std::hex << value << ';';
+            out += oss.str();
+            j += length;
+            }
+        }
+    return true;
+}
 } // namespace xml_lmi
 
 std::ostream& operator<<(std::ostream& os, xml_lmi::xml_document const& d)
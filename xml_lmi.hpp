@@ -110,6 +110,8 @@ namespace xml_lmi
         ,std::string const& name
         ,int                value
         );
+
+    bool append_escaped_content(std::string& out, std::string const& content);
 } // namespace xml_lmi
 
 std::ostream& operator<<(std::ostream&, xml_lmi::xml_document const&);
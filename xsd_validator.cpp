@@ -0,0 +1,736 @@
+// Validate xml documents with XSD schemata, caching compiled schemata.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "xsd_validator.hpp"
+
+#include "alert.hpp"
+#include "data_directory.hpp"           // AddDataDir()
+#include "value_cast.hpp"
+#include "xml_lmi.hpp"
+
+#include <xmlwrapp/attributes.h>
+#include <xmlwrapp/document.h>
+#include <xmlwrapp/nodes_view.h>
+#include <xmlwrapp/schema.h>
+
+#include <algorithm>                    // any_of(), find(), find_if(), stable_sort()
+#include <cmath>                        // isnan()
+#include <cstdlib>                      // strtod()
+#include <cstring>                      // strcmp()
+#include <map>
+#include <memory>                       // make_unique()
+#include <mutex>
+#include <regex>
+#include <set>
+#include <stdexcept>
+
+namespace
+{
+/// Values longer than this are not matched against patterns, because
+/// std::regex may recurse once per character, and the resulting stack
+/// usage is not bounded. Such a value is deemed invalid here, so that
+/// libxml2 decides its fate.
+
+std::string::size_type const maximum_pattern_length = 1000;
+
+struct simple_type
+{
+    std::string              base;
+    std::vector<std::string> enumerations;
+    std::vector<std::regex>  patterns;
+    bool                     has_minimum {false};
+    double                   minimum     {0.0};
+    bool                     has_maximum {false};
+    double                   maximum     {0.0};
+};
+
+struct particle
+{
+    std::string name;
+    int         min_occurs {1};
+    int         max_occurs {1}; // Negative means unbounded.
+};
+
+struct attribute_decl
+{
+    std::string name;
+    bool        required {false};
+    std::string type;
+};
+
+struct complex_type
+{
+    std::string                 base;
+    std::vector<particle>       sequence;
+    std::vector<attribute_decl> attributes;
+};
+
+struct element_decl
+{
+    std::string  type;
+    bool         is_complex {false};
+    complex_type complex;
+};
+
+[[noreturn]] void unsupported(std::string const& what)
+{
+    alarum() << "Unsupported XSD construct '" << what << "'." << LMI_FLUSH;
+    throw "Unreachable--silences a compiler diagnostic.";
+}
+
+std::string attribute(xml::element const& e, std::string const& name)
+{
+    std::string z;
+    xml_lmi::get_attr(e, name, z);
+    return z;
+}
+
+int occurrences(xml::element const& e, std::string const& name)
+{
+    std::string const s = attribute(e, name);
+    return
+          s.empty()          ?  1
+        : "unbounded" == s   ? -1
+        : value_cast<int>(s)
+        ;
+}
+
+/// Collapse whitespace, as XSD does for every built-in type that this
+/// class supports except xs:string.
+
+std::string collapse(std::string const& s)
+{
+    std::string z;
+    bool pending_space = false;
+    for(char c : s)
+        {
+        if(' ' == c || '\t' == c || '\n' == c || '\r' == c)
+            {
+            pending_space = !z.empty();
+            }
+        else
+            {
+            if(pending_space)
+                {
+                z += ' ';
+                }
+            pending_space = false;
+            z += c;
+            }
+        }
+    return z;
+}
+
+bool is_whitespace(std::string const& s)
+{
+    return collapse(s).empty();
+}
+
+/// XSD 1.0's lexical space for xs:double, which, unlike XSD 1.1's,
+/// has no "+INF".
+
+bool is_xsd_double(std::string const& s)
+{
+    static std::regex const r
+        ("[+-]?([0-9]+(\\.[0-9]*)?|\\.[0-9]+)([Ee][+-]?[0-9]+)?|-?INF|NaN");
+    return std::regex_match(s, r);
+}
+
+bool is_xsd_non_negative_integer(std::string const& s)
+{
+    static std::regex const r("\\+?[0-9]+");
+    return std::regex_match(s, r);
+}
+} // Unnamed namespace.
+
+struct xsd_validator::schema_data
+{
+    std::map<std::string,simple_type>  simple_types;
+    std::map<std::string,complex_type> complex_types;
+    std::map<std::string,element_decl> elements;
+    std::set<std::string>              loaded_files;
+    int                                anonymous_types {0};
+
+    void load(std::string const& filename);
+    std::string parse_simple_type(xml::element const&, std::string name);
+    complex_type parse_complex_type(xml::element const&);
+    attribute_decl parse_attribute(xml::element const&);
+    element_decl parse_element(xml::element const&);
+    void resolve(complex_type&);
+    void check_references() const;
+
+    bool validate_element
+        (xml::element       const&
+        ,element_decl       const&
+        ,std::vector<std::string>&
+        ) const;
+    bool is_valid_value(std::string const& type, std::string const& value) const;
+};
+
+void xsd_validator::schema_data::load(std::string const& filename)
+{
+    if(!loaded_files.insert(filename).second)
+        {
+        return;
+        }
+
+    xml_lmi::dom_parser const parser(AddDataDir(filename));
+    for(auto const& i : parser.root_node("schema").elements())
+        {
+        std::string const tag = i.get_name();
+        if("annotation" == tag)
+            {
+            continue;
+            }
+        else if("include" == tag)
+            {
+            load(attribute(i, "schemaLocation"));
+            }
+        else if("simpleType" == tag)
+            {
+            parse_simple_type(i, attribute(i, "name"));
+            }
+        else if("complexType" == tag)
+            {
+            complex_types[attribute(i, "name")] = parse_complex_type(i);
+            }
+        else if("element" == tag)
+            {
+            elements[attribute(i, "name")] = parse_element(i);
+            }
+        else
+            {
+            unsupported(tag);
+            }
+        }
+}
+
+/// Parse a simple type, giving it a unique name if it is anonymous,
+/// and return its name.
+
+std::string xsd_validator::schema_data::parse_simple_type
+    (xml::element const& e
+    ,std::string         name
+    )
+{
+    if(name.empty())
+        {
+        name = "#anonymous" + value_cast<std::string>(++anonymous_types);
+        }
+
+    bool restricted = false;
+    simple_type z;
+    for(auto const& i : e.elements())
+        {
+        std::string const tag = i.get_name();
+        if("annotation" == tag)
+            {
+            continue;
+            }
+        else if("restriction" != tag || restricted)
+            {
+            unsupported(tag);
+            }
+        restricted = true;
+        z.base = attribute(i, "base");
+        if
+            (  "xs:string"             != z.base
+            && "xs:token"              != z.base
+            && "xs:double"             != z.base
+            && "xs:nonNegativeInteger" != z.base
+            )
+            {
+            unsupported(z.base);
+            }
+        for(auto const& j : i.elements())
+            {
+            std::string const facet = j.get_name();
+            std::string const value = attribute(j, "value");
+            if("annotation" == facet)
+                {
+                continue;
+                }
+            else if("enumeration" == facet)
+                {
+                z.enumerations.push_back(value);
+                }
+            else if("pattern" == facet)
+                {
+                z.patterns.emplace_back(value);
+                }
+            else if("minInclusive" == facet)
+                {
+                z.has_minimum = true;
+                z.minimum     = value_cast<double>(value);
+                }
+            else if("maxInclusive" == facet)
+                {
+                z.has_maximum = true;
+                z.maximum     = value_cast<double>(value);
+                }
+            else
+                {
+                unsupported(facet);
+                }
+            }
+        }
+    if(!restricted)
+        {
+        unsupported("simpleType without restriction");
+        }
+    simple_types[name] = z;
+    return name;
+}
+
+complex_type xsd_validator::schema_data::parse_complex_type(xml::element const& e)
+{
+    complex_type z;
+    for(auto const& i : e.elements())
+        {
+        std::string const tag = i.get_name();
+        if("annotation" == tag)
+            {
+            continue;
+            }
+        else if("sequence" == tag)
+            {
+            for(auto const& j : i.elements())
+                {
+                std::string const t = j.get_name();
+                if("annotation" == t)
+                    {
+                    continue;
+                    }
+                else if("element" != t || attribute(j, "ref").empty())
+                    {
+                    unsupported("sequence of " + t);
+                    }
+                z.sequence.push_back
+                    ({attribute(j, "ref")
+                    ,occurrences(j, "minOccurs")
+                    ,occurrences(j, "maxOccurs")
+                    });
+                }
+            }
+        else if("attribute" == tag)
+            {
+            z.attributes.push_back(parse_attribute(i));
+            }
+        else if("complexContent" == tag)
+            {
+            for(auto const& j : i.elements())
+                {
+                std::string const t = j.get_name();
+                if("annotation" == t)
+                    {
+                    continue;
+                    }
+                else if("extension" != t)
+                    {
+                    unsupported(t);
+                    }
+                complex_type const x = parse_complex_type(j);
+                z.base = attribute(j, "base");
+                z.sequence  .insert(z.sequence  .end(), x.sequence  .begin(), x.sequence  .end());
+                z.attributes.insert(z.attributes.end(), x.attributes.begin(), x.attributes.end());
+                }
+            }
+        else
+            {
+            unsupported(tag);
+            }
+        }
+    return z;
+}
+
+attribute_decl xsd_validator::schema_data::parse_attribute(xml::element const& e)
+{
+    attribute_decl z {attribute(e, "name"), "required" == attribute(e, "use"), attribute(e, "type")};
+    for(auto const& i : e.elements())
+        {
+        std::string const tag = i.get_name();
+        if("annotation" == tag)
+            {
+            continue;
+            }
+        else if("simpleType" != tag)
+            {
+            unsupported(tag);
+            }
+        z.type = parse_simple_type(i, "");
+        }
+    if(z.type.empty())
+        {
+        z.type = "xs:string";
+        }
+    return z;
+}
+
+element_decl xsd_validator::schema_data::parse_element(xml::element const& e)
+{
+    element_decl z;
+    z.type = attribute(e, "type");
+    for(auto const& i : e.elements())
+        {
+        std::string const tag = i.get_name();
+        if("annotation" == tag)
+            {
+            continue;
+            }
+        else if("complexType" == tag)
+            {
+            z.is_complex = true;
+            z.complex = parse_complex_type(i);
+            }
+        else if("simpleType" == tag)
+            {
+            z.type = parse_simple_type(i, "");
+            }
+        else
+            {
+            unsupported(tag);
+            }
+        }
+    if(z.type.empty() && !z.is_complex)
+        {
+        unsupported("element without type");
+        }
+    return z;
+}
+
+/// Prepend the sequence and attributes of any base type.
+
+void xsd_validator::schema_data::resolve(complex_type& t)
+{
+    if(t.base.empty())
+        {
+        return;
+        }
+    auto const i = complex_types.find(t.base);
+    if(complex_types.end() == i)
+        {
+        unsupported("base type " + t.base);
+        }
+    resolve(i->second);
+    complex_type z = i->second;
+    z.sequence  .insert(z.sequence  .end(), t.sequence  .begin(), t.sequence  .end());
+    z.attributes.insert(z.attributes.end(), t.attributes.begin(), t.attributes.end());
+    t = z;
+}
+
+void xsd_validator::schema_data::check_references() const
+{
+    for(auto const& [name, e] : elements)
+        {
+        if(!e.is_complex && !simple_types.count(e.type))
+            {
+            unsupported("type " + e.type + " of element " + name);
+            }
+        for(auto const& p : e.complex.sequence)
+            {
+            if(!elements.count(p.name))
+                {
+                unsupported("reference " + p.name);
+                }
+            }
+        for(auto const& a : e.complex.attributes)
+            {
+            if(!simple_types.count(a.type))
+                {
+                unsupported("type " + a.type + " of attribute " + a.name);
+                }
+            }
+        }
+}
+
+/// Validate an element and, recursively, its subelements, stopping
+/// at the first error.
+
+bool xsd_validator::schema_data::validate_element
+    (xml::element       const& e
+    ,element_decl       const& d
+    ,std::vector<std::string>& errors
+    ) const
+{
+    std::string const name = e.get_name();
+    std::string const where = "Element '" + name + "'";
+
+    for(auto const& a : e.get_attributes())
+        {
+        std::string const a_name = a.get_name();
+        auto const& decls = d.complex.attributes;
+        auto const i = std::find_if
+            (decls.begin()
+            ,decls.end()
+            ,[&a_name](attribute_decl const& x) {return a_name == x.name;}
+            );
+        if(decls.end() == i)
+            {
+            errors.push_back(where + ": attribute '" + a_name + "' is not allowed.");
+            return false;
+            }
+        if(!is_valid_value(i->type, a.get_value()))
+            {
+            errors.push_back(where + ": attribute '" + a_name + "' is invalid.");
+            return false;
+            }
+        }
+    for(auto const& a : d.complex.attributes)
+        {
+        std::string ignored;
+        if(a.required && !xml_lmi::get_attr(e, a.name, ignored))
+            {
+            errors.push_back(where + ": attribute '" + a.name + "' is missing.");
+            return false;
+            }
+        }
+
+    // Iterators, not pointers to the nodes they designate, are kept,
+    // because an xmlwrapp iterator owns the node it dereferences to.
+    std::vector<xml::node::const_iterator> children;
+    for(auto i = e.begin(); i != e.end(); ++i)
+        {
+        if(xml::node::type_element == i->get_type())
+            {
+            children.push_back(i);
+            }
+        else if(!i->is_text() && xml::node::type_comment != i->get_type())
+            {
+            errors.push_back(where + ": unsupported content.");
+            return false;
+            }
+        }
+
+    if(!d.is_complex)
+        {
+        if(!children.empty())
+            {
+            errors.push_back(where + ": element content is not allowed.");
+            return false;
+            }
+        if(!is_valid_value(d.type, xml_lmi::get_content(e)))
+            {
+            errors.push_back(where + ": value is invalid.");
+            return false;
+            }
+        return true;
+        }
+
+    if(!is_whitespace(xml_lmi::get_content(e)))
+        {
+        errors.push_back(where + ": character content is not allowed.");
+        return false;
+        }
+
+    // As though by 'sort_cell_subelements.xsl'.
+    if("cell" == name)
+        {
+        std::stable_sort
+            (children.begin()
+            ,children.end()
+            ,[](xml::node::const_iterator a, xml::node::const_iterator b)
+                {return std::strcmp(a->get_name(), b->get_name()) < 0;}
+            );
+        }
+
+    auto const& sequence = d.complex.sequence;
+    std::vector<particle>::size_type p = 0;
+    int n = 0;
+    for(auto const& c : children)
+        {
+        std::string const c_name = c->get_name();
+        for(;;)
+            {
+            if(sequence.size() == p)
+                {
+                errors.push_back(where + ": subelement '" + c_name + "' is not expected.");
+                return false;
+                }
+            particle const& q = sequence[p];
+            if(c_name == q.name && (q.max_occurs < 0 || n < q.max_occurs))
+                {
+                ++n;
+                break;
+                }
+            if(n < q.min_occurs)
+                {
+                errors.push_back
+                    (where + ": subelement '" + c_name + "' is not expected;"
+                    + " expected '" + q.name + "'."
+                    );
+                return false;
+                }
+            ++p;
+            n = 0;
+            }
+        if(!validate_element(*c, elements.at(c_name), errors))
+            {
+            return false;
+            }
+        }
+    for(; p < sequence.size(); ++p, n = 0)
+        {
+        if(n < sequence[p].min_occurs)
+            {
+            errors.push_back(where + ": subelement '" + sequence[p].name + "' is missing.");
+            return false;
+            }
+        }
+    return true;
+}
+
+bool xsd_validator::schema_data::is_valid_value
+    (std::string const& type
+    ,std::string const& value
+    ) const
+{
+    simple_type const& t = simple_types.at(type);
+    std::string const v = ("xs:string" == t.base) ? value : collapse(value);
+
+    if("xs:double" == t.base && !is_xsd_double(v))
+        {
+        return false;
+        }
+    if("xs:nonNegativeInteger" == t.base && !is_xsd_non_negative_integer(v))
+        {
+        return false;
+        }
+
+    if(!t.enumerations.empty())
+        {
+        if(t.enumerations.end() == std::find(t.enumerations.begin(), t.enumerations.end(), v))
+            {
+            return false;
+            }
+        }
+
+    if(!t.patterns.empty())
+        {
+        if(maximum_pattern_length < v.size())
+            {
+            return false;
+            }
+        auto const matches = [&v](std::regex const& r) {return std::regex_match(v, r);};
+        if(!std::any_of(t.patterns.begin(), t.patterns.end(), matches))
+            {
+            return false;
+            }
+        }
+
+    if(t.has_minimum || t.has_maximum)
+        {
+        // NaN compares false to everything, but satisfies no bound.
+        double const d = std::strtod(v.c_str(), nullptr);
+        if
+            (  std::isnan(d)
+            || (t.has_minimum && d < t.minimum)
+            || (t.has_maximum && t.maximum < d)
+            )
+            {
+            return false;
+            }
+        }
+
+    return true;
+}
+
+xsd_validator::xsd_validator(std::string const& xsd_filename)
+    :data_ {std::make_unique<schema_data>()}
+{
+    for(auto const& i : {"xs:string", "xs:token", "xs:double", "xs:nonNegativeInteger"})
+        {
+        data_->simple_types[i].base = i;
+        }
+    data_->load(xsd_filename);
+    for(auto& i : data_->complex_types)
+        {
+        data_->resolve(i.second);
+        }
+    for(auto& [name, e] : data_->elements)
+        {
+        if(!e.is_complex && data_->complex_types.count(e.type))
+            {
+            e.is_complex = true;
+            e.complex    = data_->complex_types[e.type];
+            }
+        data_->resolve(e.complex);
+        }
+    data_->check_references();
+}
+
+xsd_validator::~xsd_validator() = default;
+
+/// Validate a document, returning a description of the first error
+/// found, if any.
+
+std::vector<std::string> xsd_validator::validate(xml_lmi::Document const& d) const
+{
+    std::vector<std::string> errors;
+    xml::element const& root = d.get_root_node();
+    auto const i = data_->elements.find(root.get_name());
+    if(data_->elements.end() == i)
+        {
+        errors.push_back("Root element '" + std::string(root.get_name()) + "' is not declared.");
+        }
+    else
+        {
+        data_->validate_element(root, i->second, errors);
+        }
+    return errors;
+}
+
+xml::schema const& cached_xsd_schema(std::string const& xsd_filename)
+{
+    static std::mutex mutex;
+    static std::map<std::string,std::unique_ptr<xml::schema>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<xml::schema>& z = cache[xsd_filename];
+    if(!z)
+        {
+        xml_lmi::dom_parser const parser(AddDataDir(xsd_filename));
+        z = std::make_unique<xml::schema>(parser.document());
+        }
+    return *z;
+}
+
+xsd_validator const* cached_xsd_validator(std::string const& xsd_filename)
+{
+    static std::mutex mutex;
+    static std::map<std::string,std::unique_ptr<xsd_validator>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto const i = cache.find(xsd_filename);
+    if(cache.end() != i)
+        {
+        return i->second.get();
+        }
+    std::unique_ptr<xsd_validator>& z = cache[xsd_filename];
+    try
+        {
+        z = std::make_unique<xsd_validator>(xsd_filename);
+        }
+    catch(std::exception const&)
+        {
+        // Leave 'z' null, so that libxml2 is always used instead.
+        }
+    return z.get();
+}
@@ -0,0 +1,85 @@
+// Validate xml documents with XSD schemata, caching compiled schemata.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef xsd_validator_hpp
+#define xsd_validator_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+#include "xml_lmi_fwd.hpp"
+
+#include <memory>                       // unique_ptr
+#include <string>
+#include <vector>
+
+/// Design notes for class xsd_validator.
+///
+/// Validating a large external census with libxml2 is costly: its
+/// schema must first be compiled, and its cells' subelements must be
+/// sorted by an XSLT transformation that produces a complete second
+/// DOM, because the schema requires them to appear in alphabetical
+/// order. This class instead interprets the schema itself, checking
+/// element presence and content, and attribute values, in one pass
+/// over the document as originally parsed. Subelements of <cell> are
+/// compared in sorted order, just as though they had been sorted.
+///
+/// Only the small subset of XSD that lmi's schemata use is supported:
+/// global elements, simple and complex types, sequences with
+/// occurrence bounds, complex-content extensions, attributes, and
+/// restrictions of xs:string, xs:token, xs:double, and
+/// xs:nonNegativeInteger by enumeration, pattern, minInclusive, and
+/// maxInclusive facets. The ctor throws if a schema uses anything
+/// else.
+///
+/// Validation is conservative: it may reject a valid document (for
+/// example, one with a sequence-input string too long to be matched
+/// safely by std::regex), but it should never accept an invalid one.
+/// Therefore, a document that this class rejects should be validated
+/// again by libxml2, which then provides its usual diagnostics; the
+/// diagnostics returned by validate() are only terse summaries.
+
+class LMI_SO xsd_validator final
+{
+  public:
+    explicit xsd_validator(std::string const& xsd_filename);
+    ~xsd_validator();
+
+    std::vector<std::string> validate(xml_lmi::Document const&) const;
+
+  private:
+    xsd_validator(xsd_validator const&) = delete;
+    xsd_validator& operator=(xsd_validator const&) = delete;
+
+    struct schema_data;
+    std::unique_ptr<schema_data> data_;
+};
+
+/// Compiled libxml2 schema for a data file, cached across calls.
+
+LMI_SO xml::schema const& cached_xsd_schema(std::string const& xsd_filename);
+
+/// Native validator for a data file, cached across calls; or null if
+/// the schema uses any construct that class xsd_validator lacks.
+
+LMI_SO xsd_validator const* cached_xsd_validator(std::string const& xsd_filename);
+
+#endif // xsd_validator_hpp
@@ -0,0 +1,247 @@
+// Validate xml documents with XSD schemata--unit test.
+//
+// Copyright (C) 2022 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "xsd_validator.hpp"
+
+#include "test_tools.hpp"
+#include "xml_lmi.hpp"
+
+#include <cstdio>                       // remove()
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::string const schema_name("eraseme_xsd_validator_test.xsd");
+
+/// A schema using every construct that class xsd_validator supports.
+
+char const* const schema_text =
+    "<?xml version='1.0' encoding='UTF-8'?>\n"
+    "<xs:schema xmlns:xs='http://www.w3.org/2001/XMLSchema' elementFormDefault='qualified'>\n"
+    "  <xs:simpleType name='gender'>\n"
+    "    <xs:restriction base='xs:token'>\n"
+    "      <xs:enumeration value='Female'/>\n"
+    "      <xs:enumeration value='Male'/>\n"
+    "    </xs:restriction>\n"
+    "  </xs:simpleType>\n"
+    "  <xs:simpleType name='age_int'>\n"
+    "    <xs:restriction base='xs:nonNegativeInteger'>\n"
+    "      <xs:maxInclusive value='99'/>\n"
+    "    </xs:restriction>\n"
+    "  </xs:simpleType>\n"
+    "  <xs:simpleType name='fraction'>\n"
+    "    <xs:restriction base='xs:double'>\n"
+    "      <xs:minInclusive value='0'/>\n"
+    "      <xs:maxInclusive value='1'/>\n"
+    "    </xs:restriction>\n"
+    "  </xs:simpleType>\n"
+    "  <xs:simpleType name='mode'>\n"
+    "    <xs:restriction base='xs:string'>\n"
+    "      <xs:pattern value=' *(annual|monthly) *'/>\n"
+    "    </xs:restriction>\n"
+    "  </xs:simpleType>\n"
+    "  <xs:element name='Age' type='age_int'/>\n"
+    "  <xs:element name='Fraction' type='fraction'/>\n"
+    "  <xs:element name='Gender' type='gender'/>\n"
+    "  <xs:element name='Mode' type='mode'/>\n"
+    "  <xs:element name='Rate' type='xs:double'/>\n"
+    "  <xs:element name='cell'>\n"
+    "    <xs:complexType>\n"
+    "      <xs:sequence>\n"
+    "        <xs:element ref='Age'/>\n"
+    "        <xs:element ref='Gender'/>\n"
+    "        <xs:element minOccurs='0' ref='Fraction'/>\n"
+    "        <xs:element minOccurs='0' ref='Mode'/>\n"
+    "        <xs:element ref='Rate'/>\n"
+    "      </xs:sequence>\n"
+    "    </xs:complexType>\n"
+    "  </xs:element>\n"
+    "  <xs:complexType name='cells'>\n"
+    "    <xs:sequence>\n"
+    "      <xs:element maxOccurs='unbounded' ref='cell'/>\n"
+    "    </xs:sequence>\n"
+    "  </xs:complexType>\n"
+    "  <xs:element name='document'>\n"
+    "    <xs:complexType>\n"
+    "      <xs:complexContent>\n"
+    "        <xs:extension base='cells'>\n"
+    "          <xs:attribute name='version' use='required'>\n"
+    "            <xs:simpleType>\n"
+    "              <xs:restriction base='xs:token'>\n"
+    "                <xs:enumeration value='9'/>\n"
+    "              </xs:restriction>\n"
+    "            </xs:simpleType>\n"
+    "          </xs:attribute>\n"
+    "          <xs:attribute name='data_source' type='xs:nonNegativeInteger'/>\n"
+    "        </xs:extension>\n"
+    "      </xs:complexContent>\n"
+    "    </xs:complexType>\n"
+    "  </xs:element>\n"
+    "</xs:schema>\n"
+    ;
+
+/// Validate a document given as a string, returning the first error,
+/// or an empty string if there is none.
+
+std::string first_error(xsd_validator const& v, std::string const& s)
+{
+    xml_lmi::dom_parser const parser(s.c_str(), s.size());
+    std::vector<std::string> const errors = v.validate(parser.document());
+    return errors.empty() ? std::string() : errors.front();
+}
+
+std::string document(std::string const& attributes, std::string const& cells)
+{
+    return "<?xml version='1.0'?><document" + attributes + ">" + cells + "</document>";
+}
+} // Unnamed namespace.
+
+int test_main(int, char*[])
+{
+    std::ofstream(schema_name) << schema_text;
+
+    xsd_validator const* const p = cached_xsd_validator(schema_name);
+    LMI_TEST(nullptr != p);
+    LMI_TEST(p == cached_xsd_validator(schema_name));
+    xsd_validator const& v = *p;
+
+    std::string const v9(" version='9'");
+    std::string const sorted
+        ("<cell><Age>45</Age><Gender>Male</Gender><Mode> annual</Mode><Rate>0.5</Rate></cell>");
+
+    LMI_TEST_EQUAL("", first_error(v, document(v9, sorted)));
+    LMI_TEST_EQUAL("", first_error(v, document(v9 + " data_source='2'", sorted + sorted)));
+
+    // Subelements of <cell> may appear in any order, and optional
+    // ones may be omitted. Tokens are whitespace-collapsed.
+    LMI_TEST_EQUAL
+        (""
+        ,first_error
+            (v
+            ,document
+                (v9
+                ,"<cell>\n <Rate>1E3</Rate>\n <Gender> Female </Gender>\n <Age>0</Age>\n</cell>"
+                )
+            )
+        );
+
+    LMI_TEST_EQUAL
+        ("Element 'document': attribute 'version' is missing."
+        ,first_error(v, document("", sorted))
+        );
+    LMI_TEST_EQUAL
+        ("Element 'document': attribute 'version' is invalid."
+        ,first_error(v, document(" version='8'", sorted))
+        );
+    LMI_TEST_EQUAL
+        ("Element 'document': attribute 'bogus' is not allowed."
+        ,first_error(v, document(v9 + " bogus='1'", sorted))
+        );
+    LMI_TEST_EQUAL
+        ("Element 'document': subelement 'cell' is missing."
+        ,first_error(v, document(v9, ""))
+        );
+    LMI_TEST_EQUAL
+        ("Element 'cell': subelement 'Gender' is missing."
+        ,first_error(v, document(v9, "<cell><Age>45</Age></cell>"))
+        );
+    LMI_TEST_EQUAL
+        ("Element 'cell': subelement 'Rate' is not expected."
+        ,first_error(v, document(v9, "<cell><Age>45</Age><Gender>Male</Gender><Rate>1</Rate><Rate>1</Rate></cell>"))
+        );
+    LMI_TEST_EQUAL
+        ("Element 'Age': value is invalid."
+        ,first_error(v, document(v9, "<cell><Age>100</Age><Gender>Male</Gender><Rate>1</Rate></cell>"))
+        );
+    LMI_TEST_EQUAL
+        ("Element 'Gender': value is invalid."
+        ,first_error(v, document(v9, "<cell><Age>45</Age><Gender>male</Gender><Rate>1</Rate></cell>"))
+        );
+    LMI_TEST_EQUAL
+        ("Element 'Mode': value is invalid."
+        ,first_error(v, document(v9, "<cell><Age>45</Age><Gender>Male</Gender><Mode>daily</Mode><Rate>1</Rate></cell>"))
+        );
+    LMI_TEST_EQUAL
+        ("Element 'Rate': value is invalid."
+        ,first_error(v, document(v9, "<cell><Age>45</Age><Gender>Male</Gender><Rate>1,5</Rate></cell>"))
+        );
+
+    // XSD 1.0 doubles: "INF" and "NaN", but not "+INF".
+    for(auto const& i : {"INF", "-INF", "NaN", "+1.5E-3"})
+        {
+        LMI_TEST_EQUAL
+            (""
+            ,first_error(v, document(v9, "<cell><Age>45</Age><Gender>Male</Gender><Rate>" + std::string(i) + "</Rate></cell>"))
+            );
+        }
+    LMI_TEST_EQUAL
+        ("Element 'Rate': value is invalid."
+        ,first_error(v, document(v9, "<cell><Age>45</Age><Gender>Male</Gender><Rate>+INF</Rate></cell>"))
+        );
+
+    // Bounds on doubles: NaN satisfies neither.
+    LMI_TEST_EQUAL
+        (""
+        ,first_error(v, document(v9, "<cell><Age>45</Age><Gender>Male</Gender><Fraction>1</Fraction><Rate>1</Rate></cell>"))
+        );
+    for(auto const& i : {"NaN", "INF", "-INF", "1.5", "-0.5"})
+        {
+        LMI_TEST_EQUAL
+            ("Element 'Fraction': value is invalid."
+            ,first_error(v, document(v9, "<cell><Age>45</Age><Gender>Male</Gender><Fraction>" + std::string(i) + "</Fraction><Rate>1</Rate></cell>"))
+            );
+        }
+
+    LMI_TEST_EQUAL
+        ("Element 'cell': character content is not allowed."
+        ,first_error(v, document(v9, "<cell>text<Age>45</Age><Gender>Male</Gender><Rate>1</Rate></cell>"))
+        );
+    LMI_TEST_EQUAL
+        ("Element 'Age': element content is not allowed."
+        ,first_error(v, document(v9, "<cell><Age><Age/></Age><Gender>Male</Gender><Rate>1</Rate></cell>"))
+        );
+
+    // Schemata with unsupported constructs are rejected, so that
+    // libxml2 is used instead.
+    std::string const unsupported_name("eraseme_xsd_validator_test_1.xsd");
+    std::ofstream(unsupported_name)
+        << "<?xml version='1.0'?>"
+        << "<xs:schema xmlns:xs='http://www.w3.org/2001/XMLSchema'>"
+        << "<xs:element name='x' type='xs:date'/>"
+        << "</xs:schema>"
+        ;
+    LMI_TEST_THROW
+        (xsd_validator {unsupported_name}
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Unsupported XSD construct")
+        );
+    LMI_TEST(nullptr == cached_xsd_validator(unsupported_name));
+
+    LMI_TEST(0 == std::remove(schema_name.c_str()));
+    LMI_TEST(0 == std::remove(unsupported_name.c_str()));
+
+    return 0;
+}
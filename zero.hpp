@@ -30,6 +30,7 @@
 #include "round_to.hpp"
 #include "ssize_lmi.hpp"
 
+#include <algorithm>                    // max(), min()
 #include <cfloat>                       // DBL_EPSILON, DECIMAL_DIG
 #include <climits>                      // INT_MAX
 #include <cmath>                        // fabs(), isfinite(), isnan(), pow()
@@ -91,6 +92,21 @@ struct root_type
     int           n_eval   {0};
 };
 
+/// Optional estimate of a root, for decimal_root().
+///
+/// A hint whose 'width' is not positive is ignored. Otherwise, a
+/// root is sought first in [guess - width, guess + width], clipped
+/// to the a priori bounds. If that interval doesn't bracket a root,
+/// it is widened geometrically until it does, or until it reaches
+/// the a priori bounds, which are then used as though no hint had
+/// been given.
+
+struct root_hint
+{
+    double guess {0.0};
+    double width {0.0};
+};
+
 /// Specialized binary64 midpoint for root finding.
 ///
 /// [Author's note: I thought this might be a brand-new discovery, as
@@ -762,15 +778,27 @@ root_type lmi_root
 /// rounds to zero, so the lower bound was adjusted without the cost
 /// of another function evaluation (because of caching here).
 
+/// A good hint saves evaluations; a bad one costs only the two
+/// evaluations at the ends of each interval tried before the a
+/// priori bounds, which are reused if those bounds are reached.
+///
+/// Any interval that is tried must show a strict change of sign, so
+/// that it contains a root in its interior. If 'f' changes sign only
+/// once in [bound0, bound1], then, that is the root found, and the
+/// result is the same as for the a priori bounds, with or without a
+/// hint. If 'f' has more than one root, a hint may select a root
+/// different from the one that would otherwise be found.
+
 template<typename FunctionalType>
 root_type decimal_root
-    (FunctionalType& f
-    ,double          bound0
-    ,double          bound1
-    ,root_bias       bias
-    ,int             decimals
-    ,std::ostream&   os_trace
-    ,int             sprauchling_limit = INT_MAX
+    (FunctionalType&  f
+    ,double           bound0
+    ,double           bound1
+    ,root_hint const& hint
+    ,root_bias        bias
+    ,int              decimals
+    ,std::ostream&    os_trace
+    ,int              sprauchling_limit = INT_MAX
     )
 {
     round_to<double> const round_dec {decimals, r_to_nearest};
@@ -799,10 +827,34 @@ root_type decimal_root
             }
         };
 
+    double b0 = round_dec(bound0);
+    double b1 = round_dec(bound1);
+    double const lo_bound = std::min(b0, b1);
+    double const hi_bound = std::max(b0, b1);
+    for(double w = hint.width; 0.0 < w; w *= 8.0)
+        {
+        double const lo = round_dec(std::max(lo_bound, hint.guess - w));
+        double const hi = round_dec(std::min(hi_bound, hint.guess + w));
+        if(hi <= lo || (lo_bound == lo && hi_bound == hi))
+            {
+            os_trace << " hint rejected: using a priori bounds" << std::endl;
+            break;
+            }
+        double const f_lo = fr(lo);
+        double const f_hi = fr(hi);
+        if(signum(f_lo) * signum(f_hi) < 0.0)
+            {
+            os_trace << " hint brackets [" << lo << ", " << hi << "]" << std::endl;
+            b0 = lo;
+            b1 = hi;
+            break;
+            }
+        }
+
     auto z = lmi_root
         (fr
-        ,round_dec(bound0)
-        ,round_dec(bound1)
+        ,b0
+        ,b1
         ,0.5 * std::pow(10.0, -decimals)
         ,os_trace
         ,sprauchling_limit
@@ -816,6 +868,29 @@ root_type decimal_root
     return z;
 }
 
+template<typename FunctionalType>
+root_type decimal_root
+    (FunctionalType& f
+    ,double          bound0
+    ,double          bound1
+    ,root_bias       bias
+    ,int             decimals
+    ,std::ostream&   os_trace
+    ,int             sprauchling_limit = INT_MAX
+    )
+{
+    return decimal_root
+        (f
+        ,bound0
+        ,bound1
+        ,root_hint {}
+        ,bias
+        ,decimals
+        ,os_trace
+        ,sprauchling_limit
+        );
+}
+
 template<typename FunctionalType>
 root_type decimal_root
     (FunctionalType& f
@@ -27,11 +27,12 @@
 #include "materially_equal.hpp"
 #include "math_functions.hpp"           // signum()
 #include "miscellany.hpp"               // stifle_unused_warning()
+#include "null_stream.hpp"
 #include "test_tools.hpp"
 
 #include <algorithm>                    // max()
 #include <cfloat>                       // DECIMAL_DIG
-#include <cmath>                        // exp(), fabs(), log(), pow(), sin(), sqrt()
+#include <cmath>                        // exp(), expm1(), fabs(), log(), pow(), sin(), sqrt()
 #include <limits>
 #include <sstream>
 
@@ -1297,6 +1298,64 @@ void test_former_rounding_problem()
     LMI_TEST(root_is_valid == r.validity);
 }
 
+/// Test hints, which must not change the root found for a function
+/// with a single root.
+
+void test_hints()
+{
+    auto f0 = [](double x) {return 0.93 * x - 123456.78;};
+    auto f1 = [](double x) {return std::expm1(x / 1.0e5) - 3.0;};
+    double const b0 = 0.0;
+    double const b1 = 999999999.99;
+    std::ostream null_ostream(&null_streambuf());
+    null_ostream.setstate(std::ios::badbit);
+    for(auto bias : {bias_none, bias_lower, bias_higher})
+        {
+        root_type const r0 = decimal_root(f0, b0, b1, bias, 2);
+        LMI_TEST(root_is_valid == r0.validity);
+
+        // A hint near the root costs nothing for a linear function,
+        // whose root is found by the first secant step anyway.
+        root_type r = decimal_root
+            (f0, b0, b1, root_hint {132750.0, 10.0}, bias, 2, null_ostream);
+        LMI_TEST(root_is_valid == r.validity);
+        LMI_TEST_EQUAL(r0.root, r.root);
+        LMI_TEST_RELATION(r.n_eval,<=,r0.n_eval);
+
+        // A hint that doesn't bracket the root is widened.
+        r = decimal_root
+            (f0, b0, b1, root_hint {500000.0, 0.01}, bias, 2, null_ostream);
+        LMI_TEST(root_is_valid == r.validity);
+        LMI_TEST_EQUAL(r0.root, r.root);
+
+        // A hint outside the bounds is harmless.
+        r = decimal_root
+            (f0, b0, b1, root_hint {-1.0e12, 1.0}, bias, 2, null_ostream);
+        LMI_TEST(root_is_valid == r.validity);
+        LMI_TEST_EQUAL(r0.root, r.root);
+
+        // A hint with no width is ignored.
+        r = decimal_root
+            (f0, b0, b1, root_hint {132750.0, 0.0}, bias, 2, null_ostream);
+        LMI_TEST_EQUAL(r0.root  , r.root  );
+        LMI_TEST_EQUAL(r0.n_eval, r.n_eval);
+
+        // For a nonlinear function, it saves evaluations.
+        root_type const r1 = decimal_root(f1, b0, b1, bias, 2);
+        LMI_TEST(root_is_valid == r1.validity);
+        r = decimal_root
+            (f1, b0, b1, root_hint {138000.0, 1000.0}, bias, 2, null_ostream);
+        LMI_TEST(root_is_valid == r.validity);
+        LMI_TEST_EQUAL(r1.root, r.root);
+        LMI_TEST_RELATION(r.n_eval,<,r1.n_eval);
+        }
+
+    // A hint cannot find a root that the bounds exclude.
+    root_type const r = decimal_root
+        (f0, 0.0, 1000.0, root_hint {500.0, 10.0}, bias_none, 2, null_ostream);
+    LMI_TEST(root_not_bracketed == r.validity);
+}
+
 void test_toms748()
 {
     // begin test adapted from 'driver.f'
@@ -2977,6 +3036,7 @@ int test_main(int, char*[])
     test_various_functions();
     test_hodgepodge();
     test_former_rounding_problem();
+    test_hints();
     test_toms748();
 
     std::cout << "--8<----8<--" << std::endl;